@@ -62,6 +62,47 @@ const vx_char extensions[] =
 #endif
     " ";
 
+/*! \brief Picks the threadpool size: the VX_NUM_WORKERS environment variable,
+ * then the TARGET_NUM_CORES build setting, then the number of online cores.
+ */
+static vx_uint32 vxGetNumWorkers(void)
+{
+    vx_uint32 num = 0u;
+    char *str = getenv("VX_NUM_WORKERS");
+    if (str)
+    {
+        num = (vx_uint32)strtoul(str, NULL, 10);
+    }
+    if (num == 0u)
+    {
+        num = VX_INT_HOST_CORES;
+    }
+    if (num == 0u)
+    {
+        num = vxGetNumCores();
+    }
+    if (num > VX_INT_MAX_WORKERS)
+    {
+        num = VX_INT_MAX_WORKERS;
+    }
+    VX_PRINT(VX_ZONE_CONTEXT, "Using %u threadpool workers\n", num);
+    return num;
+}
+
+/*! \brief Picks the default threadpool policy from the VX_THREADPOOL environment
+ * variable: "stealing" selects the work-stealing pool, anything else the
+ * round-robin one. \see VX_CONTEXT_ATTRIBUTE_THREADPOOL
+ */
+static vx_enum vxGetThreadpoolType(void)
+{
+    char *str = getenv("VX_THREADPOOL");
+    if (str && strcmp(str, "stealing") == 0)
+    {
+        return VX_THREADPOOL_WORK_STEALING;
+    }
+    return VX_THREADPOOL_ROUND_ROBIN;
+}
+
 static vx_bool vxWorkerNode(vx_threadpool_worker_t *worker)
 {
     vx_bool ret = vx_true_e;
@@ -70,6 +111,14 @@ static vx_bool vxWorkerNode(vx_threadpool_worker_t *worker)
     vx_action action = (vx_action)worker->data->v3;
     vx_uint32 p = 0;
 
+    if (node->chain_next != NULL)
+    {
+        VX_PRINT(VX_ZONE_GRAPH, "Executing chain of %s on target %s\n", node->kernel->name, target->name);
+        action = vxExecuteChain(node);
+        worker->data->v3 = (vx_value_t)action;
+        return ((action == VX_ACTION_ABANDON) || (action == VX_ACTION_RESTART)) ? vx_false_e : vx_true_e;
+    }
+
     /* turn on access to virtual memory */
     for (p = 0u; p < node->kernel->signature.num_parameters; p++) {
         if (node->parameters[p] == NULL) continue;
@@ -82,7 +131,7 @@ static vx_bool vxWorkerNode(vx_threadpool_worker_t *worker)
     action = target->funcs.process(target, &node, 0, 1);
     VX_PRINT(VX_ZONE_GRAPH, "Executed %s on target %s with action %d returned\n", node->kernel->name, target->name, action);
 
-    /* turn on access to virtual memory */
+    /* turn off access to virtual memory */
     for (p = 0u; p < node->kernel->signature.num_parameters; p++) {
         if (node->parameters[p] == NULL) continue;
         if (node->parameters[p]->is_virtual == vx_true_e) {
@@ -91,7 +140,7 @@ static vx_bool vxWorkerNode(vx_threadpool_worker_t *worker)
             // should allow commits to work, even if the flag is lowered.
             // if this is an output, there should only be a single writer, so
             // no locks are needed. Bidirectional is not allowed to be virtual.
-            node->parameters[p]->is_accessible = vx_true_e;
+            node->parameters[p]->is_accessible = vx_false_e;
         }
     }
 
@@ -104,6 +153,39 @@ static vx_bool vxWorkerNode(vx_threadpool_worker_t *worker)
     return ret;
 }
 
+/*! \brief Replaces the worker pool of the context by one of the given policy, unless
+ * a graph is being processed with it.
+ */
+static vx_status vxSetThreadpoolType(vx_context context, vx_enum type)
+{
+    vx_status status = VX_SUCCESS;
+    vxSemWait(context->p_global_lock);
+    if (context->num_processing > 0u)
+    {
+        status = VX_ERROR_GRAPH_SCHEDULED;
+    }
+    else if (context->workers == NULL || context->workers->type != type)
+    {
+        vx_threadpool_t *workers = vxCreateThreadpool(type,
+                                                      vxGetNumWorkers(),
+                                                      VX_INT_MAX_REF, /* very deep queues! */
+                                                      sizeof(vx_work_t),
+                                                      vxWorkerNode,
+                                                      context);
+        if (workers)
+        {
+            vxDestroyThreadpool(&context->workers);
+            context->workers = workers;
+        }
+        else
+        {
+            status = VX_ERROR_NO_RESOURCES;
+        }
+    }
+    vxSemPost(context->p_global_lock);
+    return status;
+}
+
 static vx_value_t vxWorkerGraph(void *arg)
 {
     vx_processor_t *proc = (vx_processor_t *)arg;
@@ -145,6 +227,10 @@ VX_INT_API vx_bool vxIsValidType(vx_enum type)
     {
         ret = vx_true_e;
     }
+    else if (type == VX_TYPE_KEYPOINT_F32) /* sub-pixel keypoint extension */
+    {
+        ret = vx_true_e;
+    }
     else if (VX_TYPE_IS_OBJECT(type)) /* some object */
     {
         ret = vx_true_e;
@@ -220,6 +306,7 @@ VX_INT_API vx_bool vxAddAccessor(vx_context context,
 {
     vx_uint32 a;
     vx_bool worked = vx_false_e;
+    vxSemWait(&context->base.lock);
     for (a = 0u; a < dimof(context->accessors); a++)
     {
         if (context->accessors[a].used == vx_false_e)
@@ -229,7 +316,7 @@ VX_INT_API vx_bool vxAddAccessor(vx_context context,
             {
                 context->accessors[a].ptr = malloc(size);
                 if (context->accessors[a].ptr == NULL)
-                    return vx_false_e;
+                    break;
                 context->accessors[a].allocated = vx_true_e;
             }
             else
@@ -245,6 +332,7 @@ VX_INT_API vx_bool vxAddAccessor(vx_context context,
             break;
         }
     }
+    vxSemPost(&context->base.lock);
     return worked;
 }
 
@@ -252,6 +340,7 @@ VX_INT_API vx_bool vxFindAccessor(vx_context context, void *ptr, vx_uint32 *pInd
 {
     vx_uint32 a;
     vx_bool worked = vx_false_e;
+    vxSemWait(&context->base.lock);
     for (a = 0u; a < dimof(context->accessors); a++)
     {
         if (context->accessors[a].used == vx_true_e)
@@ -265,6 +354,7 @@ VX_INT_API vx_bool vxFindAccessor(vx_context context, void *ptr, vx_uint32 *pInd
             }
         }
     }
+    vxSemPost(&context->base.lock);
     return worked;
 }
 
@@ -272,11 +362,13 @@ VX_INT_API void vxRemoveAccessor(vx_context context, vx_uint32 index)
 {
     if (index < dimof(context->accessors))
     {
+        vxSemWait(&context->base.lock);
         if (context->accessors[index].allocated == vx_true_e)
         {
             free(context->accessors[index].ptr);
         }
         memset(&context->accessors[index], 0, sizeof(vx_external_t));
+        vxSemPost(&context->base.lock);
         VX_PRINT(VX_ZONE_CONTEXT, "Removed accessors[%u]\n", index);
     }
 }
@@ -311,9 +403,11 @@ VX_API_ENTRY vx_context VX_API_CALL vxCreateContext()
             vx_uint32 p = 0u, p2 = 0u, t = 0u;
             context->p_global_lock = &global_lock;
             context->imm_border.mode = VX_BORDER_MODE_UNDEFINED;
+            vxInitImagePool(&context->image_pool);
             vxInitReference(&context->base, NULL, VX_TYPE_CONTEXT, NULL);
             vxIncrementReference(&context->base, VX_EXTERNAL);
-            context->workers = vxCreateThreadpool(VX_INT_HOST_CORES,
+            context->workers = vxCreateThreadpool(vxGetThreadpoolType(),
+                                                  vxGetNumWorkers(),
                                                   VX_INT_MAX_REF, /* very deep queues! */
                                                   sizeof(vx_work_t),
                                                   vxWorkerNode,
@@ -332,6 +426,7 @@ VX_API_ENTRY vx_context VX_API_CALL vxCreateContext()
             if (context->num_targets == 0)
             {
                 VX_PRINT(VX_ZONE_ERROR, "No targets loaded!\n");
+                vxDeinitImagePool(&context->image_pool);
                 free(context);
                 vxSemPost(&context_lock);
                 return 0;
@@ -491,6 +586,8 @@ VX_API_ENTRY vx_status VX_API_CALL vxReleaseContext(vx_context *c)
                     VX_PRINT(VX_ZONE_ERROR,"Reference %d not removed\n", r);
             }
 
+            vxDeinitImagePool(&context->image_pool);
+
             /*! \internal wipe away the context memory first */
             /* Normally destroy sem is part of release reference, but can't for context */
             vxDestroySem(&((vx_reference )context)->lock);
@@ -558,6 +655,78 @@ VX_API_ENTRY vx_status VX_API_CALL vxSetContextAttribute(vx_context context, vx_
                     status = VX_ERROR_INVALID_PARAMETERS;
                 }
                 break;
+            case VX_CONTEXT_ATTRIBUTE_IMAGE_ALIGNMENT:
+                if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
+                {
+                    vx_size alignment = *(vx_size *)ptr;
+                    if ((alignment < 16) || (alignment > 4096) || (alignment & (alignment - 1)))
+                        status = VX_ERROR_INVALID_VALUE;
+                    else
+                    {
+                        /* the kept blocks may be aligned less */
+                        vxTrimImagePool(&context->image_pool, 0ul);
+                        context->image_pool.alignment = alignment;
+                    }
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_CONTEXT_ATTRIBUTE_IMAGE_ROW_PADDING:
+                if (VX_CHECK_PARAM(ptr, size, vx_bool, 0x3))
+                {
+                    context->image_pool.row_padding = *(vx_bool *)ptr;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_CONTEXT_ATTRIBUTE_IMAGE_HUGEPAGES:
+                if (VX_CHECK_PARAM(ptr, size, vx_enum, 0x3))
+                {
+                    vx_enum hugepages = *(vx_enum *)ptr;
+                    if ((hugepages != VX_HUGEPAGES_NONE) && (hugepages != VX_HUGEPAGES_TRANSPARENT) &&
+                        (hugepages != VX_HUGEPAGES_RESERVED))
+                        status = VX_ERROR_INVALID_VALUE;
+                    else
+                    {
+                        /* the kept blocks may be backed otherwise */
+                        vxTrimImagePool(&context->image_pool, 0ul);
+                        context->image_pool.hugepages = hugepages;
+                    }
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_CONTEXT_ATTRIBUTE_IMAGE_POOL_SIZE:
+                if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
+                {
+                    context->image_pool.capacity = *(vx_size *)ptr;
+                    vxTrimImagePool(&context->image_pool, context->image_pool.capacity);
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_CONTEXT_ATTRIBUTE_THREADPOOL:
+                if (VX_CHECK_PARAM(ptr, size, vx_enum, 0x3))
+                {
+                    vx_enum type = *(vx_enum *)ptr;
+                    if ((type != VX_THREADPOOL_ROUND_ROBIN) && (type != VX_THREADPOOL_WORK_STEALING))
+                        status = VX_ERROR_INVALID_VALUE;
+                    else
+                        status = vxSetThreadpoolType(context, type);
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
             default:
                 status = VX_ERROR_NOT_SUPPORTED;
                 break;
@@ -689,6 +858,62 @@ VX_API_ENTRY vx_status VX_API_CALL vxQueryContext(vx_context context, vx_enum at
                     status = VX_ERROR_INVALID_PARAMETERS;
                 }
                 break;
+            case VX_CONTEXT_ATTRIBUTE_IMAGE_ALIGNMENT:
+                if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
+                {
+                    *(vx_size *)ptr = context->image_pool.alignment;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_CONTEXT_ATTRIBUTE_IMAGE_ROW_PADDING:
+                if (VX_CHECK_PARAM(ptr, size, vx_bool, 0x3))
+                {
+                    *(vx_bool *)ptr = context->image_pool.row_padding;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_CONTEXT_ATTRIBUTE_IMAGE_HUGEPAGES:
+                if (VX_CHECK_PARAM(ptr, size, vx_enum, 0x3))
+                {
+                    *(vx_enum *)ptr = context->image_pool.hugepages;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_CONTEXT_ATTRIBUTE_IMAGE_POOL_SIZE:
+                if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
+                {
+                    *(vx_size *)ptr = context->image_pool.capacity;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_CONTEXT_ATTRIBUTE_THREADPOOL:
+                if (VX_CHECK_PARAM(ptr, size, vx_enum, 0x3))
+                {
+                    /* the pool may be being replaced */
+                    vxSemWait(context->p_global_lock);
+                    if (context->workers)
+                        *(vx_enum *)ptr = context->workers->type;
+                    else
+                        status = VX_ERROR_NO_RESOURCES;
+                    vxSemPost(context->p_global_lock);
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
             case VX_CONTEXT_ATTRIBUTE_UNIQUE_KERNELS:
                 if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
                 {
@@ -147,7 +147,7 @@ VX_API_ENTRY vx_status VX_API_CALL vxQueryDelay(vx_delay delay, vx_enum attribut
         switch (attribute)
         {
             case VX_DELAY_ATTRIBUTE_TYPE:
-                if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
+                if (VX_CHECK_PARAM(ptr, size, vx_enum, 0x3))
                     *(vx_enum *)ptr = delay->type;
                 else
                     status = VX_ERROR_INVALID_PARAMETERS;
@@ -337,8 +337,10 @@ VX_API_ENTRY vx_status VX_API_CALL vxAgeDelay(vx_delay delay)
     {
         vx_int32 i,j;
 
-        // increment the index
+        // increment the index, nodes running on another thread read it under the lock
+        vxSemWait(&delay->base.lock);
         delay->index = (delay->index + 1) % (vx_uint32)delay->count;
+        vxSemPost(&delay->base.lock);
 
         VX_PRINT(VX_ZONE_DELAY, "Delay has shifted by 1, base index is now %d\n", delay->index);
 
@@ -480,8 +480,24 @@ VX_API_ENTRY vx_status VX_API_CALL vxSetGraphAttribute(vx_graph graph, vx_enum a
     vx_status status = VX_SUCCESS;
     if (vxIsValidSpecificReference(&graph->base, VX_TYPE_GRAPH) == vx_true_e)
     {
-        /*! \todo there are no settable attributes in this implementation yet... */
-        status = VX_ERROR_NOT_SUPPORTED;
+        switch (attribute)
+        {
+            case VX_GRAPH_ATTRIBUTE_TILE_HEIGHT:
+                if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
+                {
+                    graph->tile_height = *(vx_uint32 *)ptr;
+                    /* the chains are planned by the verification */
+                    graph->verified = vx_false_e;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            default:
+                status = VX_ERROR_NOT_SUPPORTED;
+                break;
+        }
     }
     else
     {
@@ -540,6 +556,54 @@ VX_API_ENTRY vx_status VX_API_CALL vxQueryGraph(vx_graph graph, vx_enum attribut
                     status = VX_ERROR_INVALID_PARAMETERS;
                 }
                 break;
+            case VX_GRAPH_ATTRIBUTE_PEAK_MEMORY:
+                if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
+                {
+                    *(vx_size *)ptr = graph->peak_memory;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_GRAPH_ATTRIBUTE_ARENA_SIZE:
+                if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
+                {
+                    *(vx_size *)ptr = graph->arena_size;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_GRAPH_ATTRIBUTE_TILE_HEIGHT:
+                if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
+                {
+                    *(vx_uint32 *)ptr = graph->tile_height;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_GRAPH_ATTRIBUTE_NODE_PERFORMANCE:
+                if (ptr != NULL && size > 0 && size % sizeof(vx_node_perf_t) == 0 &&
+                    size / sizeof(vx_node_perf_t) <= graph->numNodes &&
+                    ((vx_size)ptr & 0x3) == 0)
+                {
+                    vx_node_perf_t *nodes = (vx_node_perf_t *)ptr;
+                    vx_uint32 n, num = (vx_uint32)(size / sizeof(vx_node_perf_t));
+                    for (n = 0; n < num; n++)
+                    {
+                        snprintf(nodes[n].name, sizeof(nodes[n].name), "%s", graph->nodes[n]->kernel->name);
+                        nodes[n].perf = graph->nodes[n]->perf;
+                    }
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
             default:
                 status = VX_ERROR_NOT_SUPPORTED;
                 break;
@@ -552,6 +616,439 @@ VX_API_ENTRY vx_status VX_API_CALL vxQueryGraph(vx_graph graph, vx_enum attribut
     return status;
 }
 
+/* A virtual image which only the nodes of this graph can see, it can share the arena */
+static vx_bool vxIsArenaImage(vx_graph graph, vx_reference ref)
+{
+    vx_image image = (vx_image)ref;
+    if (ref && ref->type == VX_TYPE_IMAGE && ref->is_virtual == vx_true_e &&
+        ref->scope == &graph->base && image->parent == NULL &&
+        image->memory.allocated == vx_false_e)
+        return vx_true_e;
+    return vx_false_e;
+}
+
+static void vxReleaseArena(vx_graph graph)
+{
+    vx_uint32 i;
+    for (i = 0; i < graph->numArenaImages; i++)
+    {
+        vxUnplaceMemory(&graph->arena_images[i]->memory);
+        vxReleaseReferenceInt((vx_reference *)&graph->arena_images[i], VX_TYPE_IMAGE, VX_INTERNAL, NULL);
+    }
+    graph->numArenaImages = 0;
+    free(graph->arena);
+    graph->arena = NULL;
+    graph->arena_size = 0ul;
+    graph->peak_memory = 0ul;
+}
+
+/* Marks reads[n * numNodes + n1] when node n reads what node n1 writes. Returns NULL when
+ * out of memory, else the caller frees the array. */
+static vx_bool *vxComputeNodeReads(vx_graph graph)
+{
+    vx_uint32 n, n1, p, p1;
+    /* one more, so an empty graph gets an array too */
+    vx_bool *reads = (vx_bool *)calloc(graph->numNodes * graph->numNodes + 1, sizeof(vx_bool));
+    if (reads == NULL)
+        return NULL;
+
+    for (n = 0; n < graph->numNodes; n++)
+    {
+        for (p = 0; p < graph->nodes[n]->kernel->signature.num_parameters; p++)
+        {
+            if ((graph->nodes[n]->kernel->signature.directions[p] != VX_INPUT) ||
+                (graph->nodes[n]->parameters[p] == NULL))
+                continue;
+            for (n1 = 0; n1 < graph->numNodes; n1++)
+            {
+                if (n1 == n)
+                    continue;
+                for (p1 = 0; p1 < graph->nodes[n1]->kernel->signature.num_parameters; p1++)
+                {
+                    if ((graph->nodes[n1]->kernel->signature.directions[p1] != VX_INPUT) &&
+                        vxCheckWriteDependency(graph->nodes[n]->parameters[p], graph->nodes[n1]->parameters[p1]))
+                        reads[n * graph->numNodes + n1] = vx_true_e;
+                }
+            }
+        }
+    }
+    return reads;
+}
+
+/* The level at which each node runs, as vxExecuteGraph schedules them: the heads first,
+ * every other node one level after the last node it reads from. Nodes of one level may
+ * run at the same time. A node of a chain runs along with the node it reads band by band,
+ * at the same level. */
+static void vxComputeNodeLevels(vx_graph graph, const vx_bool reads[], vx_uint32 levels[])
+{
+    vx_uint32 n, n1, pass;
+    vx_bool changed = vx_true_e;
+
+    for (n = 0; n < graph->numNodes; n++)
+        levels[n] = 0;
+    /* the graph has no cycles, so the longest paths settle within numNodes passes */
+    for (pass = 0; (pass < graph->numNodes) && (changed == vx_true_e); pass++)
+    {
+        changed = vx_false_e;
+        for (n = 0; n < graph->numNodes; n++)
+        {
+            for (n1 = 0; n1 < graph->numNodes; n1++)
+            {
+                vx_uint32 step = (graph->nodes[n]->chain_prev == graph->nodes[n1]) ? 0 : 1;
+                if (reads[n * graph->numNodes + n1] && (levels[n] < levels[n1] + step))
+                {
+                    levels[n] = levels[n1] + step;
+                    changed = vx_true_e;
+                }
+            }
+        }
+    }
+}
+
+/* Places the virtual images of the graph in one arena. An image lives from the first to the
+ * last level of the nodes which use it, images whose lives don't overlap share bytes. The
+ * largest images are placed first, each at the lowest offset free for its whole life. */
+static vx_status vxPlanArena(vx_graph graph, const vx_uint32 levels[])
+{
+    vx_uint32 first[VX_INT_MAX_NODES], last[VX_INT_MAX_NODES], order[VX_INT_MAX_NODES];
+    vx_size sizes[VX_INT_MAX_NODES], offsets[VX_INT_MAX_NODES];
+    vx_uint32 n, p, i, j, k, num, maxLevel = 0;
+    vx_uint8 *base;
+
+    for (n = 0; n < graph->numNodes; n++)
+    {
+        if (levels[n] > maxLevel)
+            maxLevel = levels[n];
+        for (p = 0; p < graph->nodes[n]->kernel->signature.num_parameters; p++)
+        {
+            vx_reference ref = graph->nodes[n]->parameters[p];
+            for (i = 0; i < graph->numArenaImages; i++)
+            {
+                if (ref == (vx_reference)graph->arena_images[i])
+                    break;
+            }
+            if (i == graph->numArenaImages)
+            {
+                if (vxIsArenaImage(graph, ref) == vx_false_e)
+                    continue;
+                if (i == dimof(graph->arena_images))
+                {
+                    /* no room left in the list, the image gets memory of its own */
+                    if (vxAllocateImage((vx_image)ref) == vx_false_e)
+                        return VX_ERROR_NO_MEMORY;
+                    continue;
+                }
+                vxIncrementReference(ref, VX_INTERNAL);
+                graph->arena_images[graph->numArenaImages++] = (vx_image)ref;
+                first[i] = last[i] = levels[n];
+            }
+            if (levels[n] < first[i])
+                first[i] = levels[n];
+            if (levels[n] > last[i])
+                last[i] = levels[n];
+        }
+    }
+    num = graph->numArenaImages;
+    if (num == 0)
+        return VX_SUCCESS;
+
+    for (i = 0; i < num; i++)
+    {
+        sizes[i] = vxPlaceMemory(&graph->arena_images[i]->memory, NULL);
+        /* insertion by decreasing size */
+        for (j = i; (j > 0) && (sizes[order[j - 1]] < sizes[i]); j--)
+            order[j] = order[j - 1];
+        order[j] = i;
+    }
+    for (i = 0; i < num; i++)
+    {
+        vx_uint32 a = order[i];
+        vx_size best = (vx_size)-1;
+        /* the candidates are 0 and the ends of the placed images */
+        for (j = 0; j <= i; j++)
+        {
+            vx_size offset = (j == i) ? 0ul : offsets[order[j]] + sizes[order[j]];
+            vx_bool fits = (offset < best) ? vx_true_e : vx_false_e;
+            for (k = 0; (k < i) && (fits == vx_true_e); k++)
+            {
+                vx_uint32 b = order[k];
+                if ((first[a] <= last[b]) && (first[b] <= last[a]) &&
+                    (offset < offsets[b] + sizes[b]) && (offsets[b] < offset + sizes[a]))
+                    fits = vx_false_e;
+            }
+            if (fits == vx_true_e)
+                best = offset;
+        }
+        offsets[a] = best;
+        if (best + sizes[a] > graph->arena_size)
+            graph->arena_size = best + sizes[a];
+    }
+    for (n = 0; n <= maxLevel; n++)
+    {
+        vx_size alive = 0ul;
+        for (i = 0; i < num; i++)
+        {
+            if ((first[i] <= n) && (n <= last[i]))
+                alive += sizes[i];
+        }
+        if (alive > graph->peak_memory)
+            graph->peak_memory = alive;
+    }
+
+    graph->arena = (vx_uint8 *)malloc(graph->arena_size + VX_MEMORY_ALIGNMENT);
+    if (graph->arena == NULL)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Failed to allocate "VX_FMT_SIZE" bytes of arena\n", graph->arena_size);
+        return VX_ERROR_NO_MEMORY;
+    }
+    base = (vx_uint8 *)(((vx_size)graph->arena + VX_MEMORY_ALIGNMENT - 1) & ~(vx_size)(VX_MEMORY_ALIGNMENT - 1));
+    for (i = 0; i < num; i++)
+    {
+        vxPlaceMemory(&graph->arena_images[i]->memory, base + offsets[i]);
+        VX_PRINT(VX_ZONE_GRAPH, "Arena image "VX_FMT_REF" at "VX_FMT_SIZE" for levels %u..%u\n",
+                 graph->arena_images[i], offsets[i], first[i], last[i]);
+    }
+    VX_PRINT(VX_ZONE_GRAPH, "Arena of "VX_FMT_SIZE" bytes for %u images, peak "VX_FMT_SIZE" bytes\n",
+             graph->arena_size, num, graph->peak_memory);
+    return VX_SUCCESS;
+}
+
+/* The only output of a node which can run in bands, NULL if it can not be chained */
+static vx_image vxBandOutput(vx_node node)
+{
+    vx_image output = NULL;
+    vx_uint32 p;
+    if ((node->attributes.inputRows == NULL) || (node->child != NULL))
+        return NULL;
+    for (p = 0; p < node->kernel->signature.num_parameters; p++)
+    {
+        vx_reference ref = node->parameters[p];
+        if ((node->kernel->signature.directions[p] == VX_INPUT) || (ref == NULL))
+            continue;
+        if ((node->kernel->signature.directions[p] == VX_BIDIRECTIONAL) ||
+            (ref->type != VX_TYPE_IMAGE) || (output != NULL))
+            return NULL;
+        output = (vx_image)ref;
+    }
+    return output;
+}
+
+/* Links the nodes of a tiled graph into chains which run band by band and gives the levels
+ * of the nodes with the chains, for the arena and the schedule. A node is linked to the only
+ * writer of one of its input images when both can run in bands and that image is the whole
+ * output of the writer. The chain runs at the level of its head, so a link which would have
+ * a node of the chain wait for a later level is undone again. */
+static vx_status vxPlanChains(vx_graph graph, vx_uint32 levels[])
+{
+    vx_uint32 n, n1, p;
+    vx_bool undone = vx_true_e;
+    vx_bool *reads = vxComputeNodeReads(graph);
+
+    if (reads == NULL)
+        return VX_ERROR_NO_MEMORY;
+    for (n = 0; n < graph->numNodes; n++)
+    {
+        graph->nodes[n]->chain_next = NULL;
+        graph->nodes[n]->chain_prev = NULL;
+    }
+
+    for (n = 0; (n < graph->numNodes) && (graph->tile_height > 0); n++)
+    {
+        vx_node node = graph->nodes[n];
+        if (vxBandOutput(node) == NULL)
+            continue;
+        for (p = 0; (p < node->kernel->signature.num_parameters) && (node->chain_prev == NULL); p++)
+        {
+            vx_reference ref = node->parameters[p];
+            vx_uint32 writers[VX_INT_MAX_REF], count = dimof(writers);
+            vx_node prev;
+            if ((node->kernel->signature.directions[p] != VX_INPUT) ||
+                (ref == NULL) || (ref->type != VX_TYPE_IMAGE))
+                continue;
+            if ((vxFindNodesWithReference(graph, ref, writers, &count, VX_OUTPUT) != VX_SUCCESS) || (count != 1))
+                continue;
+            prev = graph->nodes[writers[0]];
+            if ((prev != node) && (prev->chain_next == NULL) && (prev->affinity == node->affinity) &&
+                (vxBandOutput(prev) == (vx_image)ref))
+            {
+                prev->chain_next = node;
+                node->chain_prev = prev;
+                node->chain_input = p;
+            }
+        }
+    }
+
+    /* only the levels change as links are undone, the reads are found once */
+    while (undone == vx_true_e)
+    {
+        undone = vx_false_e;
+        vxComputeNodeLevels(graph, reads, levels);
+        for (n = 0; (n < graph->numNodes) && (undone == vx_false_e); n++)
+        {
+            vx_node node = graph->nodes[n];
+            if (node->chain_prev == NULL)
+                continue;
+            for (n1 = 0; graph->nodes[n1] != node->chain_prev; n1++)
+                ;
+            if (levels[n] != levels[n1])
+            {
+                VX_PRINT(VX_ZONE_GRAPH, "Node[%u] %s waits for level %u, unlinked from node[%u]\n",
+                         n, node->kernel->name, levels[n], n1);
+                node->chain_prev->chain_next = NULL;
+                node->chain_prev = NULL;
+                undone = vx_true_e;
+            }
+        }
+    }
+    free(reads);
+    for (n = 0; n < graph->numNodes; n++)
+    {
+        if (graph->nodes[n]->chain_next)
+            VX_PRINT(VX_ZONE_GRAPH, "Node[%u] %s runs band by band into %s\n", n,
+                     graph->nodes[n]->kernel->name, graph->nodes[n]->chain_next->kernel->name);
+    }
+    return VX_SUCCESS;
+}
+
+/* Calls the kernel of a node of a chain for the rows [start_y, end_y) of its output */
+static vx_status vxExecuteBand(vx_node node, vx_perf_t *bands, vx_uint32 start_y, vx_uint32 end_y)
+{
+    node->band.start_x = 0;
+    node->band.start_y = start_y;
+    node->band.end_x = vxBandOutput(node)->width;
+    node->band.end_y = end_y;
+    vxStartCapture(bands);
+    node->status = node->kernel->function(node, (vx_reference *)node->parameters,
+                                          node->kernel->signature.num_parameters);
+    vxStopCapture(bands);
+    memset(&node->band, 0, sizeof(node->band));
+    return node->status;
+}
+
+vx_action vxExecuteChain(vx_node head)
+{
+    vx_node chain[VX_INT_MAX_REF];
+    vx_perf_t bands[VX_INT_MAX_REF];
+    vx_uint32 height[VX_INT_MAX_REF], done[VX_INT_MAX_REF], need[VX_INT_MAX_REF];
+    vx_uint32 i, p, num = 0, end = 0;
+    vx_status status = VX_SUCCESS;
+    vx_action action = VX_ACTION_CONTINUE;
+    vx_node node;
+
+    for (node = head; node != NULL; node = node->chain_next)
+    {
+        height[num] = vxBandOutput(node)->height;
+        done[num] = 0;
+        vxInitPerf(&bands[num]);
+        node->status = VX_SUCCESS;
+        /* turn on access to virtual memory */
+        for (p = 0u; p < node->kernel->signature.num_parameters; p++)
+        {
+            if (node->parameters[p] && node->parameters[p]->is_virtual == vx_true_e)
+                node->parameters[p]->is_accessible = vx_true_e;
+        }
+        chain[num++] = node;
+    }
+
+    /* before each band of the last node, the nodes before it compute the rows it reads */
+    while ((status == VX_SUCCESS) && (done[num - 1] < height[num - 1]))
+    {
+        end += head->graph->tile_height;
+        need[num - 1] = (end < height[num - 1] ? end : height[num - 1]);
+        for (i = num - 1; (i > 0) && (status == VX_SUCCESS); i--)
+        {
+            vx_uint32 in_start_y = 0, in_end_y = 0;
+            need[i - 1] = done[i - 1];
+            if (need[i] > done[i])
+                status = chain[i]->attributes.inputRows(chain[i], (const vx_reference *)chain[i]->parameters,
+                                                        chain[i]->chain_input, done[i], need[i],
+                                                        &in_start_y, &in_end_y);
+            if (in_end_y > need[i - 1])
+                need[i - 1] = (in_end_y < height[i - 1] ? in_end_y : height[i - 1]);
+        }
+        for (i = 0; (i < num) && (status == VX_SUCCESS); i++)
+        {
+            if (need[i] > done[i])
+                status = vxExecuteBand(chain[i], &bands[i], done[i], need[i]);
+            done[i] = need[i];
+        }
+    }
+    /* the rows nobody in the chain read, the images are whole for the rest of the graph */
+    for (i = 0; (i < num) && (status == VX_SUCCESS); i++)
+    {
+        if (done[i] < height[i])
+            status = vxExecuteBand(chain[i], &bands[i], done[i], height[i]);
+    }
+
+    for (i = 0; i < num; i++)
+    {
+        node = chain[i];
+        /* all the bands count as one run of the node */
+        node->perf.beg = bands[i].beg;
+        node->perf.end = bands[i].end;
+        node->perf.tmp = bands[i].sum;
+        node->perf.sum += node->perf.tmp;
+        node->perf.num++;
+        node->perf.avg = node->perf.sum / node->perf.num;
+        node->perf.min = (node->perf.min < node->perf.tmp ? node->perf.min : node->perf.tmp);
+        node->executed = vx_true_e;
+        node->visited = vx_true_e;
+        /* turn off access to virtual memory */
+        for (p = 0u; p < node->kernel->signature.num_parameters; p++)
+        {
+            if (node->parameters[p] && node->parameters[p]->is_virtual == vx_true_e)
+                node->parameters[p]->is_accessible = vx_false_e;
+        }
+        if (action != VX_ACTION_CONTINUE)
+            continue;
+        if (node->status != VX_SUCCESS)
+        {
+            action = VX_ACTION_ABANDON;
+            VX_PRINT(VX_ZONE_ERROR, "Abandoning Graph due to error (%d) in %s!\n", node->status, node->kernel->name);
+        }
+        else if (node->callback)
+        {
+            action = node->callback(node);
+        }
+    }
+    return action;
+}
+
+/* Lays out the order in which vxExecuteGraph runs the nodes: a wave for each level, the
+ * levels in order. The rest of a chain runs along with its head, so it is left out. */
+static void vxPlanSchedule(vx_graph graph, const vx_uint32 levels[])
+{
+    vx_uint32 n, i, level, maxLevel = 0, num = 0;
+
+    graph->numWaves = 0;
+    for (n = 0; n < graph->numNodes; n++)
+    {
+        if (levels[n] > maxLevel)
+            maxLevel = levels[n];
+    }
+    for (level = 0; (level <= maxLevel) && (graph->numNodes > 0); level++)
+    {
+        graph->waves[graph->numWaves] = num;
+        for (n = 0; n < graph->numNodes; n++)
+        {
+            if ((levels[n] == level) && (graph->nodes[n]->chain_prev == NULL))
+                graph->schedule[num++] = n;
+        }
+        if (num > graph->waves[graph->numWaves])
+            graph->numWaves++;
+    }
+    graph->waves[graph->numWaves] = num;
+
+    for (level = 0; level < graph->numWaves; level++)
+    {
+        for (i = graph->waves[level]; i < graph->waves[level + 1]; i++)
+        {
+            VX_PRINT(VX_ZONE_GRAPH, "Wave[%u] node[%u] %s\n", level, graph->schedule[i],
+                     graph->nodes[graph->schedule[i]]->kernel->name);
+        }
+    }
+}
+
 void vxDestructGraph(vx_reference ref)
 {
     vx_graph graph = (vx_graph)ref;
@@ -567,6 +1064,7 @@ void vxDestructGraph(vx_reference ref)
         }
         vxRemoveNodeInt(&graph->nodes[0]);
     }
+    vxReleaseArena(graph);
     // execution lock?
     vxDestroySem(&graph->lock);
 }
@@ -586,6 +1084,8 @@ VX_API_ENTRY vx_status VX_API_CALL vxVerifyGraph(vx_graph graph)
         vx_uint32 h,n,p;
         vx_bool hasACycle = vx_false_e;
         vx_meta_format meta = 0;
+        /* the levels of the nodes, planned once for the chains, the arena and the schedule */
+        vx_uint32 levels[VX_INT_MAX_REF];
 
         /* lock the graph */
         vxSemWait(&graph->base.lock);
@@ -928,6 +1428,9 @@ VX_API_ENTRY vx_status VX_API_CALL vxVerifyGraph(vx_graph graph)
         VX_PRINT(VX_ZONE_GRAPH,"Memory Allocation Phase! (%d)\n", status);
         VX_PRINT(VX_ZONE_GRAPH,"########################\n");
 
+        /* the virtual images are placed again once the graph is known to be acyclic */
+        vxReleaseArena(graph);
+
         /* now make sure each parameter is backed by memory. */
         for (n = 0; (n < graph->numNodes) && (status == VX_SUCCESS); n++)
         {
@@ -942,7 +1445,11 @@ VX_API_ENTRY vx_status VX_API_CALL vxVerifyGraph(vx_graph graph)
                                  graph->nodes[n]->parameters[p]->type,
                                  graph->nodes[n]->kernel->signature.types[p]);
 
-                    if (graph->nodes[n]->parameters[p]->type == VX_TYPE_IMAGE)
+                    if (vxIsArenaImage(graph, graph->nodes[n]->parameters[p]) == vx_true_e)
+                    {
+                        /* placed in the arena */
+                    }
+                    else if (graph->nodes[n]->parameters[p]->type == VX_TYPE_IMAGE)
                     {
                         if (vxAllocateImage((vx_image_t *)graph->nodes[n]->parameters[p]) == vx_false_e)
                         {
@@ -1113,6 +1620,39 @@ VX_API_ENTRY vx_status VX_API_CALL vxVerifyGraph(vx_graph graph)
             goto exit;
         }
 
+        VX_PRINT(VX_ZONE_GRAPH,"#####################\n");
+        VX_PRINT(VX_ZONE_GRAPH,"Chain Planning Phase (%d)\n", status);
+        VX_PRINT(VX_ZONE_GRAPH,"#####################\n");
+
+        /* before the arena, which places the images by the levels of the chains */
+        if (status == VX_SUCCESS)
+        {
+            status = vxPlanChains(graph, levels);
+            if (status != VX_SUCCESS)
+                vxAddLogEntry(&graph->base, status, "Failed to plan the chains of a tiled graph!\n");
+        }
+
+        VX_PRINT(VX_ZONE_GRAPH,"#####################\n");
+        VX_PRINT(VX_ZONE_GRAPH,"Arena Planning Phase (%d)\n", status);
+        VX_PRINT(VX_ZONE_GRAPH,"#####################\n");
+
+        if (status == VX_SUCCESS)
+        {
+            status = vxPlanArena(graph, levels);
+            if (status != VX_SUCCESS)
+                vxAddLogEntry(&graph->base, status, "Failed to place the virtual images in an arena!\n");
+        }
+
+        VX_PRINT(VX_ZONE_GRAPH,"########################\n");
+        VX_PRINT(VX_ZONE_GRAPH,"Schedule Planning Phase (%d)\n", status);
+        VX_PRINT(VX_ZONE_GRAPH,"########################\n");
+
+        /* the waves vxExecuteGraph replays, at the levels the arena was placed by */
+        if (status == VX_SUCCESS)
+        {
+            vxPlanSchedule(graph, levels);
+        }
+
         VX_PRINT(VX_ZONE_GRAPH,"#########################\n");
         VX_PRINT(VX_ZONE_GRAPH,"Target Verification Phase (%d)\n", status);
         VX_PRINT(VX_ZONE_GRAPH,"#########################\n");
@@ -1240,17 +1780,24 @@ static vx_status vxExecuteGraph(vx_graph graph, vx_uint32 depth)
 {
     vx_status status = VX_SUCCESS;
     vx_action action = VX_ACTION_CONTINUE;
-    vx_uint32 n, p, numLast, numNext, numLeft = 0;
-    vx_uint32 last_nodes[VX_INT_MAX_REF];
-    vx_uint32 next_nodes[VX_INT_MAX_REF];
-    vx_uint32 left_nodes[VX_INT_MAX_REF];
+    vx_uint32 n, p, w, i;
 #if defined(OPENVX_USE_SMP)
     vx_value_set_t workitems[VX_INT_MAX_REF];
+    vx_uint32 numWork = 0;
+    vx_bool parallel = vx_false_e;
 #endif
     if (vxIsValidReference(&graph->base) == vx_false_e)
     {
         return VX_ERROR_INVALID_REFERENCE;
     }
+#if defined(OPENVX_USE_SMP)
+    /* only the outermost graph uses the pool, nested (child) graphs run inline on the worker */
+    if (depth == 1 && graph->should_serialize == vx_false_e &&
+        graph->base.context->workers && graph->base.context->workers->numWorkers > 1)
+    {
+        parallel = vx_true_e;
+    }
+#endif
     if (graph->verified == vx_false_e)
     {
         status = vxVerifyGraph((vx_graph)graph);
@@ -1264,42 +1811,51 @@ restart:
     VX_PRINT(VX_ZONE_GRAPH,"*** PROCESSING GRAPH ***\n");
     VX_PRINT(VX_ZONE_GRAPH,"************************\n");
 
-    vxClearVisitation(graph);
-    vxClearExecution(graph);
+    action = VX_ACTION_CONTINUE;
     vxStartCapture(&graph->perf);
-    /* initialize the next_nodes as the graph heads */
-    memcpy(next_nodes, graph->heads, graph->numHeads * sizeof(vx_uint32));
-    numNext = graph->numHeads;
-
-    do {
-        for (n = 0; n < numNext; n++)
+    /* replay the waves the verification planned, each one after the last is done */
+    for (w = 0; w < graph->numWaves; w++)
+    {
+        for (i = graph->waves[w]; i < graph->waves[w + 1]; i++)
         {
-            vxPrintNode(graph->nodes[next_nodes[n]]);
+            vxPrintNode(graph->nodes[graph->schedule[i]]);
         }
 
-        /* execute the next nodes */
-        for (n = 0; n < numNext; n++)
+        /* execute the nodes of the wave */
+#if defined(OPENVX_USE_SMP)
+        numWork = 0;
+#endif
+        for (i = graph->waves[w]; i < graph->waves[w + 1]; i++)
         {
-            if (graph->nodes[next_nodes[n]]->executed == vx_false_e)
-            {
-                vx_uint32 t = graph->nodes[next_nodes[n]]->affinity;
+            vx_uint32 t;
+            n = graph->schedule[i];
+            t = graph->nodes[n]->affinity;
 #if defined(OPENVX_USE_SMP)
-                if (depth == 1 && graph->should_serialize == vx_false_e)
+            if (parallel == vx_true_e)
+            {
+                vx_value_set_t *work = &workitems[numWork++];
+                vx_target target = &graph->base.context->targets[t];
+                vx_node node = graph->nodes[n];
+                work->v1 = (vx_value_t)target;
+                work->v2 = (vx_value_t)node;
+                work->v3 = (vx_value_t)VX_ACTION_CONTINUE;
+                VX_PRINT(VX_ZONE_GRAPH, "Scheduling work on %s for %s\n", target->name, node->kernel->name);
+            }
+            else
+#endif
+            {
+                vx_target_t *target = &graph->base.context->targets[t];
+                vx_node_t *node = graph->nodes[n];
+
+                if (node->chain_next != NULL)
                 {
-                    vx_value_set_t *work = &workitems[n];
-                    vx_target target = &graph->base.context->targets[t];
-                    vx_node node = graph->nodes[next_nodes[n]];
-                    work->v1 = (vx_value_t)target;
-                    work->v2 = (vx_value_t)node;
-                    work->v3 = (vx_value_t)VX_ACTION_CONTINUE;
-                    VX_PRINT(VX_ZONE_GRAPH, "Scheduling work on %s for %s\n", target->name, node->kernel->name);
+                    VX_PRINT(VX_ZONE_GRAPH, "Calling chain of Node[%u] %s:%s\n",
+                             n,
+                             target->name, node->kernel->name);
+                    action = vxExecuteChain(node);
                 }
                 else
-#endif
                 {
-                    vx_target_t *target = &graph->base.context->targets[t];
-                    vx_node_t *node = graph->nodes[next_nodes[n]];
-
                     /* turn on access to virtual memory */
                     for (p = 0u; p < node->kernel->signature.num_parameters; p++) {
                         if (node->parameters[p] == NULL) continue;
@@ -1309,13 +1865,13 @@ restart:
                     }
 
                     VX_PRINT(VX_ZONE_GRAPH, "Calling Node[%u] %s:%s\n",
-                             next_nodes[n],
+                             n,
                              target->name, node->kernel->name);
 
                     action = target->funcs.process(target, &node, 0, 1);
 
                     VX_PRINT(VX_ZONE_GRAPH, "Returned Node[%u] %s:%s Action %d\n",
-                             next_nodes[n],
+                             n,
                              target->name, node->kernel->name,
                              action);
 
@@ -1326,34 +1882,29 @@ restart:
                             node->parameters[p]->is_accessible = vx_false_e;
                         }
                     }
+                }
 
-                    if ((action == VX_ACTION_ABANDON) ||
-                        (action == VX_ACTION_RESTART))
-                    {
-                        break;
-                    }
+                if ((action == VX_ACTION_ABANDON) ||
+                    (action == VX_ACTION_RESTART))
+                {
+                    break;
                 }
             }
-            else
-            {
-                VX_PRINT(VX_ZONE_ERROR, "Multiple executions attempted!\n");
-                break;
-            }
         }
 
 #if defined(OPENVX_USE_SMP)
-        if (depth == 1 && graph->should_serialize == vx_false_e)
+        if (parallel == vx_true_e && numWork > 0)
         {
-            if (vxIssueThreadpool(graph->base.context->workers, workitems, numNext) == vx_true_e)
+            if (vxIssueThreadpool(graph->base.context->workers, workitems, numWork) == vx_true_e)
             {
                 /* do a blocking complete */
-                VX_PRINT(VX_ZONE_GRAPH, "Issued %u work items!\n", numNext);
+                VX_PRINT(VX_ZONE_GRAPH, "Issued %u work items!\n", numWork);
                 if (vxCompleteThreadpool(graph->base.context->workers, vx_true_e) == vx_true_e)
                 {
-                    VX_PRINT(VX_ZONE_GRAPH, "Processed %u items in threadpool!\n", numNext);
+                    VX_PRINT(VX_ZONE_GRAPH, "Processed %u items in threadpool!\n", numWork);
                 }
                 action = VX_ACTION_CONTINUE;
-                for (n = 0; n < numNext; n++)
+                for (n = 0; n < numWork; n++)
                 {
                     vx_action a = workitems[n].v3;
                     if (a != VX_ACTION_CONTINUE)
@@ -1364,6 +1915,13 @@ restart:
                     }
                 }
             }
+            else
+            {
+                /* some items may have been issued before the queues overflowed */
+                vxCompleteThreadpool(graph->base.context->workers, vx_true_e);
+                VX_PRINT(VX_ZONE_ERROR, "Failed to issue %u work items!\n", numWork);
+                action = VX_ACTION_ABANDON;
+            }
         }
 #endif
 
@@ -1372,15 +1930,7 @@ restart:
         {
             break;
         }
-
-        /* copy next_nodes to last_nodes */
-        memcpy(last_nodes, next_nodes, numNext * sizeof(vx_uint32));
-        numLast = numNext;
-
-        /* determine the next nodes */
-        vxFindNextNodes(graph, last_nodes, numLast, next_nodes, &numNext, left_nodes, &numLeft);
-
-    } while (numNext > 0);
+    }
 
     if (action == VX_ACTION_RESTART)
     {
@@ -1391,7 +1941,6 @@ restart:
         status = VX_ERROR_GRAPH_ABANDONED;
     }
     vxStopCapture(&graph->perf);
-    vxClearVisitation(graph);
 
     VX_PRINT(VX_ZONE_GRAPH,"Process returned status %d\n", status);
     for (n = 0; n < graph->numNodes; n++)
@@ -1527,17 +2076,18 @@ VX_API_ENTRY vx_status VX_API_CALL vxProcessGraph(vx_graph graph)
         return VX_ERROR_INVALID_REFERENCE;
 
     {
-        /* create a counter for re-entrancy checking */
-        static vx_uint32 count = 0;
-        vx_sem_t* p_sem = graph->base.context->p_global_lock;
+        /* the counter is also used for re-entrancy checking */
+        vx_context context = graph->base.context;
+        vx_sem_t* p_sem = context->p_global_lock;
+        vx_uint32 count;
         vx_status status = VX_SUCCESS;
 
         vxSemWait(p_sem);
-        count++;
+        count = ++context->num_processing;
         vxSemPost(p_sem);
         status = vxExecuteGraph(graph, count);
         vxSemWait(p_sem);
-        count--;
+        context->num_processing--;
         vxSemPost(p_sem);
 
         return status;
@@ -1583,8 +2133,8 @@ VX_API_ENTRY vx_status VX_API_CALL vxSetGraphParameterByIndex(vx_graph graph, vx
                                            value);
             if (status == VX_SUCCESS)
             {
-                /* if this is correct type/dir for the node then short-cut verify the graph */
-                graph->verified = vx_true_e;
+                /* the chains, the arena and the schedule were planned for the old reference */
+                graph->verified = vx_false_e;
             }
         }
         else
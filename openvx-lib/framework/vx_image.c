@@ -97,6 +97,95 @@ static vx_uint32 vxComputePlaneRangeSize(vx_image image, vx_uint32 range, vx_uin
     return (range * image->memory.strides[p][VX_DIM_X]) / image->scale[p][VX_DIM_X];
 }
 
+/* A pointer within the rows of a plane was mapped, the accessors have none of them */
+static vx_bool vxIsMappedPatch(vx_image image, vx_uint32 p, const vx_uint8 *ptr)
+{
+    const vx_uint8 *base = NULL;
+    vx_size size = 0ul;
+    if ((p >= image->planes) || (ptr == NULL) || (image->memory.ptrs[p] == NULL))
+        return vx_false_e;
+    base = image->memory.ptrs[p];
+    size = (vx_size)image->memory.dims[p][VX_DIM_Y] * image->memory.strides[p][VX_DIM_Y];
+    if ((ptr < base) || (ptr >= base + size))
+        return vx_false_e;
+    /* the padding of a row is not in the image */
+    if (((vx_size)(ptr - base) % image->memory.strides[p][VX_DIM_Y]) >=
+        (vx_size)image->memory.dims[p][VX_DIM_X] * image->memory.strides[p][VX_DIM_X])
+        return vx_false_e;
+    return vx_true_e;
+}
+
+/* Copies len bytes of the rows start_y to end_y between a plane and a patch, the offsets
+ * of both only grow by their row strides from one row to the next */
+static void vxCopyPatchRows(vx_image image, vx_uint32 p, vx_uint32 start_x, vx_uint32 start_y, vx_uint32 end_y,
+                            vx_imagepatch_addressing_t *addr, vx_uint8 *patch, vx_uint32 len, vx_bool to_patch)
+{
+    vx_uint8 *plane = &image->memory.ptrs[p][vxComputePlaneOffset(image, start_x, start_y, p)];
+    vx_int32 stride = image->memory.strides[p][VX_DIM_Y];
+    vx_uint32 y, rows = (end_y - start_y + addr->step_y - 1) / addr->step_y;
+    VX_PRINT(VX_ZONE_IMAGE, "%s %u rows of %u bytes\n", to_patch ? "Reading" : "Writing", rows, len);
+    if ((stride == addr->stride_y) && ((vx_uint32)stride == len))
+    {
+        /* both are packed, the rows are one block */
+        if (to_patch == vx_true_e)
+            memcpy(patch, plane, (vx_size)len * rows);
+        else
+            memcpy(plane, patch, (vx_size)len * rows);
+        return;
+    }
+    for (y = 0u; y < rows; y++, plane += stride, patch += addr->stride_y)
+    {
+        if (to_patch == vx_true_e)
+            memcpy(patch, plane, len);
+        else
+            memcpy(plane, patch, len);
+    }
+}
+
+vx_status vxMapImagePatchInt(vx_image image, const vx_rectangle_t *rect, vx_uint32 plane_index,
+                             vx_imagepatch_addressing_t *addr, void **ptr, vx_enum usage)
+{
+    if ((usage < VX_READ_ONLY) || (VX_READ_AND_WRITE < usage))
+        return VX_ERROR_INVALID_PARAMETERS;
+    if ((usage != VX_READ_ONLY) && (image->constant == vx_true_e))
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Can't write to constant data, only read!\n");
+        return VX_ERROR_NOT_SUPPORTED;
+    }
+    /* the parameters of a node were checked and allocated when its graph was verified */
+    if ((image->memory.allocated == vx_false_e) && (vxAllocateImage(image) == vx_false_e))
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Failed to allocate image\n");
+        return VX_ERROR_NO_MEMORY;
+    }
+    addr->dim_x = rect->end_x - rect->start_x;
+    addr->dim_y = rect->end_y - rect->start_y;
+    addr->stride_x = image->memory.strides[plane_index][VX_DIM_X];
+    addr->stride_y = image->memory.strides[plane_index][VX_DIM_Y];
+    addr->step_x = image->scale[plane_index][VX_DIM_X];
+    addr->step_y = image->scale[plane_index][VX_DIM_Y];
+    addr->scale_x = VX_SCALE_UNITY / image->scale[plane_index][VX_DIM_X];
+    addr->scale_y = VX_SCALE_UNITY / image->scale[plane_index][VX_DIM_Y];
+    *ptr = &image->memory.ptrs[plane_index][vxComputePatchOffset(rect->start_x, rect->start_y, addr)];
+    return VX_SUCCESS;
+}
+
+void vxUnmapImagePatchInt(vx_image image, const vx_rectangle_t *rect, vx_enum usage)
+{
+    if (usage == VX_READ_ONLY)
+        return;
+    if (image->region.start_x > rect->start_x)
+        image->region.start_x = rect->start_x;
+    if (image->region.start_y > rect->start_y)
+        image->region.start_y = rect->start_y;
+    if (image->region.end_x < rect->end_x)
+        image->region.end_x = rect->end_x;
+    if (image->region.end_y < rect->end_y)
+        image->region.end_y = rect->end_y;
+    /* the count is shared with the host and other graphs, so it is only changed under the lock */
+    vxWroteToReference(&image->base);
+}
+
 vx_bool vxIsValidImage(vx_image image)
 {
     if ((vxIsValidSpecificReference(&image->base, VX_TYPE_IMAGE) == vx_true_e) &&
@@ -316,7 +405,11 @@ void vxFreeImage(vx_image image)
 
 vx_bool vxAllocateImage(vx_image image)
 {
+#if defined(EXPERIMENTAL_USE_OPENCL)
     vx_bool ret = vxAllocateMemory(image->base.context, &image->memory);
+#else
+    vx_bool ret = vxAllocateImageMemory(image->base.context, &image->memory);
+#endif
     vxPrintMemory(&image->memory);
     return ret;
 }
@@ -327,7 +420,7 @@ VX_API_ENTRY vx_image VX_API_CALL vxCreateImageFromROI(vx_image image, vx_rectan
     if ((vxIsValidImage(image) == vx_true_e) && (rect))
     {
         /* perhaps the parent hasn't been allocated yet? */
-        if (vxAllocateMemory(image->base.context, &image->memory) == vx_true_e)
+        if (vxAllocateImage(image) == vx_true_e)
         {
             subimage = (vx_image)vxCreateReference(image->base.context, VX_TYPE_IMAGE, VX_EXTERNAL, &image->base.context->base);
             if (subimage)
@@ -632,6 +725,51 @@ VX_API_ENTRY vx_image VX_API_CALL vxCreateImageFromHandle(vx_context context, vx
     return image;
 }
 
+VX_API_ENTRY vx_status VX_API_CALL vxSwapImageHandle(vx_image image, void *new_ptrs[], void *prev_ptrs[], vx_size num_planes)
+{
+    vx_status status = VX_ERROR_INVALID_REFERENCE;
+    if (vxIsValidImage(image) == vx_true_e)
+    {
+        vx_uint32 p = 0;
+        status = VX_ERROR_INVALID_PARAMETERS;
+        if ((image->parent != NULL) || (image->constant == vx_true_e) ||
+            (new_ptrs == NULL) || (num_planes != image->planes))
+            goto exit;
+        for (p = 0; p < image->planes; p++)
+        {
+            if (new_ptrs[p] == NULL)
+                goto exit;
+        }
+        if (image->import_type == VX_IMPORT_TYPE_NONE)
+        {
+            /* the own planes go back to the pool, the new memory has packed rows */
+            vxFreeImage(image);
+            for (p = 0; p < image->planes; p++)
+            {
+                vxComputeMemoryLayout(&image->memory, p);
+                vxCreateSem(&image->memory.locks[p], 1);
+            }
+            image->memory.allocated = vx_true_e;
+            image->import_type = VX_IMPORT_TYPE_HOST;
+        }
+        for (p = 0; p < image->planes; p++)
+        {
+            if (prev_ptrs)
+                prev_ptrs[p] = image->memory.ptrs[p];
+            image->memory.ptrs[p] = new_ptrs[p];
+        }
+        /* the new memory is written as a whole */
+        image->region.start_x = 0;
+        image->region.start_y = 0;
+        image->region.end_x = image->width;
+        image->region.end_y = image->height;
+        status = VX_SUCCESS;
+    }
+exit:
+    VX_PRINT(VX_ZONE_API, "%s returned %d\n", __FUNCTION__, status);
+    return status;
+}
+
 VX_API_ENTRY vx_status VX_API_CALL vxQueryImage(vx_image image, vx_enum attribute, void *ptr, vx_size size)
 {
     vx_status status = VX_SUCCESS;
@@ -987,7 +1125,6 @@ VX_API_ENTRY vx_status VX_API_CALL vxAccessImagePatch(vx_image image,
 
     if (*ptr != NULL && mapped == vx_false_e)
     {
-        vx_uint32 y, i, j, len;
         vx_uint8 *tmp = *ptr;
 
         /*! \todo implement overlapping multi-writers lock, not just single writer lock */
@@ -1010,14 +1147,8 @@ VX_API_ENTRY vx_status VX_API_CALL vxAccessImagePatch(vx_image image,
         addr->scale_y = VX_SCALE_UNITY / image->scale[plane_index][VX_DIM_Y];
         if ((usage == VX_READ_ONLY) || (usage == VX_READ_AND_WRITE))
         {
-            for (y = rect->start_y; y < rect->end_y; y+=addr->step_y)
-            {
-                i = vxComputePlaneOffset(image, rect->start_x, y, plane_index);
-                j = vxComputePatchOffset(0, (y - rect->start_y), addr);
-                len = vxComputePlaneRangeSize(image, addr->dim_x, plane_index);
-                VX_PRINT(VX_ZONE_IMAGE, "%p[%u] <= %p[%u] for %u\n", tmp, j, image->memory.ptrs[plane_index], i, len);
-                memcpy(&tmp[j], &image->memory.ptrs[plane_index][i], len);
-            }
+            vxCopyPatchRows(image, plane_index, rect->start_x, rect->start_y, rect->end_y, addr, tmp,
+                            vxComputePlaneRangeSize(image, addr->dim_x, plane_index), vx_true_e);
             VX_PRINT(VX_ZONE_IMAGE, "Copied image into %p\n", *ptr);
             vxReadFromReference(&image->base);
         }
@@ -1036,7 +1167,6 @@ VX_API_ENTRY vx_status VX_API_CALL vxCommitImagePatch(vx_image image,
                                     void *ptr)
 {
     vx_status status = VX_ERROR_INVALID_REFERENCE;
-    vx_int32 i = 0;
     vx_bool external = vx_true_e; // assume that it was an allocated buffer
     vx_uint32 start_x = rect ? rect->start_x : 0u;
     vx_uint32 start_y = rect ? rect->start_y : 0u;
@@ -1100,7 +1230,9 @@ VX_API_ENTRY vx_status VX_API_CALL vxCommitImagePatch(vx_image image,
          * 4.) EXTERNAL - dependant on area (do nothing on zero, determine on non-zero)
          * 5.) !INTERNAL && !EXTERNAL == MAPPED
          */
-        vx_bool internal = vxFindAccessor(image->base.context, ptr, &index);
+        /* a mapped pointer is known in constant time, only the others are searched */
+        vx_bool mapped = vxIsMappedPatch(image, plane_index, tmp);
+        vx_bool internal = (mapped == vx_true_e) ? vx_false_e : vxFindAccessor(image->base.context, ptr, &index);
 
         if ((zero_area == vx_false_e) && (image->constant == vx_true_e))
         {
@@ -1130,48 +1262,18 @@ VX_API_ENTRY vx_status VX_API_CALL vxCommitImagePatch(vx_image image,
                 if (image->region.end_y < end_y)
                     image->region.end_y = end_y;
 
-                /* index of 1 pixel line past last. */
-                i = (image->memory.dims[plane_index][VX_DIM_Y] * image->memory.strides[plane_index][VX_DIM_Y]);
-
-                VX_PRINT(VX_ZONE_IMAGE, "base:%p tmp:%p end:%p\n",
-                    image->memory.ptrs[plane_index], ptr, &image->memory.ptrs[plane_index][i]);
-
-                if ((image->memory.ptrs[plane_index] <= (vx_uint8 *)ptr) &&
-                    ((vx_uint8 *)ptr < &image->memory.ptrs[plane_index][i]))
+                if (mapped == vx_true_e)
                 {
-                    /* corner case for 2d memory */
-                    if (image->memory.strides[plane_index][VX_DIM_Y] !=
-                        (image->memory.dims[plane_index][VX_DIM_X] * image->memory.strides[plane_index][VX_DIM_X]))
-                    {
-                        /* determine if the pointer is within the image boundary. */
-                        vx_uint8 *base = image->memory.ptrs[plane_index];
-                        vx_size offset = ((vx_size)(tmp - base)) % image->memory.strides[plane_index][VX_DIM_Y];
-                        if (offset < (image->memory.dims[plane_index][VX_DIM_X] * image->memory.strides[plane_index][VX_DIM_X]))
-                        {
-                            VX_PRINT(VX_ZONE_IMAGE, "Pointer is within 2D image\n");
-                            external = vx_false_e;
-                        }
-                    }
-                    else
-                    {
-                        /* the pointer in contained in the image, so it was mapped, thus
-                         * there's nothing else to do. */
-                        external = vx_false_e;
-                        VX_PRINT(VX_ZONE_IMAGE, "Mapped pointer detected!\n");
-                    }
+                    /* the pointer in contained in the image, so it was mapped, thus
+                     * there's nothing else to do. */
+                    external = vx_false_e;
+                    VX_PRINT(VX_ZONE_IMAGE, "Mapped pointer detected!\n");
                 }
                 if (external == vx_true_e || internal == vx_true_e)
                 {
                     /* copy the patch back to the image. */
-                    vx_uint32 y, i, j, len;
-                    for (y = start_y; y < end_y; y += addr->step_y)
-                    {
-                        i = vxComputePlaneOffset(image, start_x, y, plane_index);
-                        j = vxComputePatchOffset(0, (y - start_y), addr);
-                        len = vxComputePatchRangeSize((end_x - start_x), addr);
-                        VX_PRINT(VX_ZONE_IMAGE, "%p[%u] <= %p[%u] for %u\n", image->memory.ptrs[plane_index], j, tmp, i, len);
-                        memcpy(&image->memory.ptrs[plane_index][i], &tmp[j], len);
-                    }
+                    vxCopyPatchRows(image, plane_index, start_x, start_y, end_y, addr, tmp,
+                                    vxComputePatchRangeSize((end_x - start_x), addr), vx_false_e);
                     if (internal == vx_true_e)
                     {
                         /* a write only or read/write copy */
@@ -893,6 +893,16 @@ VX_API_ENTRY vx_status VX_API_CALL vxSetKernelAttribute(vx_kernel k, vx_enum att
                 status = VX_ERROR_INVALID_PARAMETERS;
             }
             break;
+        case VX_KERNEL_ATTRIBUTE_INPUT_ROWS:
+            if (VX_CHECK_PARAM(ptr, size, vx_kernel_input_rows_f, 0x1))
+            {
+                memcpy(&kernel->attributes.inputRows, ptr, size);
+            }
+            else
+            {
+                status = VX_ERROR_INVALID_PARAMETERS;
+            }
+            break;
 #ifdef EXPERIMENTAL_USE_NODE_MEMORY
         case VX_KERNEL_ATTRIBUTE_GLOBAL_DATA_SIZE:
             if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
@@ -146,14 +146,14 @@ VX_API_ENTRY vx_status VX_API_CALL vxAccessMatrix(vx_matrix matrix, void *array)
     {
         if (vxAllocateMemory(matrix->base.context, &matrix->memory) == vx_true_e)
         {
-            vxSemWait(&matrix->base.lock);
+            vxSemWait(&matrix->memory.locks[0]);
             if (array)
             {
                 vx_size size = matrix->memory.strides[0][1] *
                                matrix->memory.dims[0][1];
                 memcpy(array, matrix->memory.ptrs[0], size);
             }
-            vxSemPost(&matrix->base.lock);
+            vxSemPost(&matrix->memory.locks[0]);
             vxReadFromReference(&matrix->base);
             status = VX_SUCCESS;
         }
@@ -177,14 +177,14 @@ VX_API_ENTRY vx_status VX_API_CALL vxCommitMatrix(vx_matrix matrix, void *array)
     {
         if (vxAllocateMemory(matrix->base.context, &matrix->memory) == vx_true_e)
         {
-            vxSemWait(&matrix->base.lock);
+            vxSemWait(&matrix->memory.locks[0]);
             if (array)
             {
                 vx_size size = matrix->memory.strides[0][1] *
                                matrix->memory.dims[0][1];
                 memcpy(matrix->memory.ptrs[0], array, size);
             }
-            vxSemPost(&matrix->base.lock);
+            vxSemPost(&matrix->memory.locks[0]);
             vxWroteToReference(&matrix->base);
             status = VX_SUCCESS;
         }
@@ -200,3 +200,85 @@ VX_API_ENTRY vx_status VX_API_CALL vxCommitMatrix(vx_matrix matrix, void *array)
     }
     return status;
 }
+
+static vx_bool vxIsValidMatrixUsage(vx_enum usage)
+{
+    return (usage == VX_READ_ONLY || usage == VX_WRITE_ONLY || usage == VX_READ_AND_WRITE) ? vx_true_e : vx_false_e;
+}
+
+VX_API_ENTRY vx_status VX_API_CALL vxMapMatrix(vx_matrix matrix, void **ptr, vx_enum usage)
+{
+    vx_status status = VX_ERROR_INVALID_REFERENCE;
+    if (vxIsValidSpecificReference(&matrix->base, VX_TYPE_MATRIX) == vx_true_e)
+    {
+        if ((ptr == NULL) || (vxIsValidMatrixUsage(usage) == vx_false_e))
+        {
+            status = VX_ERROR_INVALID_PARAMETERS;
+        }
+        else if (vxAllocateMemory(matrix->base.context, &matrix->memory) == vx_true_e)
+        {
+            /* held until the unmap */
+            vxSemWait(&matrix->memory.locks[0]);
+            matrix->map_usage = usage;
+            *ptr = matrix->memory.ptrs[0];
+            status = VX_SUCCESS;
+        }
+        else
+        {
+            VX_PRINT(VX_ZONE_ERROR, "Failed to allocate matrix\n");
+            status = VX_ERROR_NO_MEMORY;
+        }
+    }
+    else
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Invalid reference for matrix\n");
+    }
+    return status;
+}
+
+VX_API_ENTRY vx_status VX_API_CALL vxUnmapMatrix(vx_matrix matrix, void *ptr)
+{
+    vx_status status = VX_ERROR_INVALID_REFERENCE;
+    if (vxIsValidSpecificReference(&matrix->base, VX_TYPE_MATRIX) == vx_true_e)
+    {
+        if ((matrix->map_usage == 0) || (ptr != matrix->memory.ptrs[0]))
+        {
+            VX_PRINT(VX_ZONE_ERROR, "Matrix is not mapped to %p\n", ptr);
+            status = VX_ERROR_INVALID_PARAMETERS;
+        }
+        else
+        {
+            vx_enum usage = matrix->map_usage;
+            matrix->map_usage = 0;
+            vxSemPost(&matrix->memory.locks[0]);
+            if (usage == VX_READ_ONLY)
+                vxReadFromReference(&matrix->base);
+            else
+                vxWroteToReference(&matrix->base);
+            status = VX_SUCCESS;
+        }
+    }
+    else
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Invalid reference for matrix\n");
+    }
+    return status;
+}
+
+vx_status vxMapMatrixInt(vx_matrix matrix, void **ptr, vx_enum usage)
+{
+    /* the parameters of a node were checked when its graph was verified */
+    if (vxAllocateMemory(matrix->base.context, &matrix->memory) == vx_false_e)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Failed to allocate matrix\n");
+        return VX_ERROR_NO_MEMORY;
+    }
+    *ptr = matrix->memory.ptrs[0];
+    return VX_SUCCESS;
+}
+
+void vxUnmapMatrixInt(vx_matrix matrix, vx_enum usage)
+{
+    if (usage != VX_READ_ONLY)
+        vxWroteToReference(&matrix->base);
+}
@@ -22,6 +22,9 @@
  */
 
 #include <vx_internal.h>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 vx_bool vxFreeMemory(vx_context context, vx_memory_t *memory)
 {
@@ -37,7 +40,13 @@ vx_bool vxFreeMemory(vx_context context, vx_memory_t *memory)
 #if defined(EXPERIMENTAL_USE_OPENCL)
                 clReleaseMemObject(memory->hdls[p]);
 #endif
-                free(memory->ptrs[p]);
+                if (memory->pooled[p])
+                {
+                    vxReleasePoolBlock(&context->image_pool, memory->ptrs[p], memory->pooled[p]);
+                    memory->pooled[p] = 0ul;
+                }
+                else
+                    free(memory->ptrs[p]);
                 vxDestroySem(&memory->locks[p]);
                 memory->ptrs[p] = NULL;
             }
@@ -48,24 +57,67 @@ vx_bool vxFreeMemory(vx_context context, vx_memory_t *memory)
 }
 
 
+vx_size vxComputeMemoryLayout(vx_memory_t *memory, vx_uint32 p)
+{
+    vx_int32 d = 0;
+    vx_size size = sizeof(vx_uint8);
+    /* channel is a declared size, don't assume */
+    if (memory->strides[p][VX_DIM_C] != 0)
+        size = (size_t)abs(memory->strides[p][VX_DIM_C]);
+    for (d = 0; d < memory->ndims; d++)
+    {
+        memory->strides[p][d] = (vx_int32)size;
+        size *= (vx_size)abs(memory->dims[p][d]);
+    }
+    return size;
+}
+
+vx_size vxPlaceMemory(vx_memory_t *memory, vx_uint8 *base)
+{
+    vx_size offset = 0ul;
+    vx_int32 p = 0;
+    for (p = 0; p < memory->nptrs; p++)
+    {
+        vx_size size = vxComputeMemoryLayout(memory, p);
+        if (base)
+        {
+            memory->ptrs[p] = base + offset;
+            vxCreateSem(&memory->locks[p], 1);
+        }
+        offset += (size + VX_MEMORY_ALIGNMENT - 1) & ~(vx_size)(VX_MEMORY_ALIGNMENT - 1);
+    }
+    if (base)
+    {
+        memory->allocated = vx_true_e;
+        VX_PRINT(VX_ZONE_INFO, "Placed %u pointers at %p\n", memory->nptrs, base);
+    }
+    return offset;
+}
+
+void vxUnplaceMemory(vx_memory_t *memory)
+{
+    vx_int32 p = 0;
+    if (memory->allocated == vx_true_e)
+    {
+        for (p = 0; p < memory->nptrs; p++)
+        {
+            vxDestroySem(&memory->locks[p]);
+            memory->ptrs[p] = NULL;
+        }
+        memory->allocated = vx_false_e;
+    }
+}
+
 vx_bool vxAllocateMemory(vx_context context, vx_memory_t *memory)
 {
     if (memory->allocated == vx_false_e)
     {
-        vx_int32 d = 0, p = 0;
+        vx_int32 p = 0;
         VX_PRINT(VX_ZONE_INFO, "Allocating %u pointers of %u dimensions each.\n", memory->nptrs, memory->ndims);
         memory->allocated = vx_true_e;
         for (p = 0; p < memory->nptrs; p++)
         {
-            vx_size size = sizeof(vx_uint8);
-            /* channel is a declared size, don't assume */
-            if (memory->strides[p][VX_DIM_C] != 0)
-                size = (size_t)abs(memory->strides[p][VX_DIM_C]);
-            for (d = 0; d < memory->ndims; d++)
-            {
-                memory->strides[p][d] = (vx_int32)size;
-                size *= (vx_size)abs(memory->dims[p][d]);
-            }
+            vx_size size = vxComputeMemoryLayout(memory, p);
             /* don't presume that memory should be zeroed */
             memory->ptrs[p] = malloc(size);
             if (memory->ptrs[p] == NULL)
@@ -122,6 +174,192 @@ vx_bool vxAllocateMemory(vx_context context, vx_memory_t *memory)
     return memory->allocated;
 }
 
+static vx_size vxAlignSize(vx_size size, vx_size alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+/* Planes from a huge page on are mapped from the system, on the huge page boundaries so
+ * that the transparent huge pages can back them, the others come from the heap. */
+static vx_uint8 *vxNewPoolBlock(vx_image_pool_t *pool, vx_size size)
+{
+    void *ptr = NULL;
+#if defined(__linux__)
+    if (size >= VX_INT_HUGEPAGE_SIZE)
+    {
+        vx_uint8 *map = NULL;
+        vx_size head = 0ul, span = size + VX_INT_HUGEPAGE_SIZE;
+#if defined(MAP_HUGETLB)
+        if (pool->hugepages == VX_HUGEPAGES_RESERVED)
+        {
+            ptr = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+            if (ptr != MAP_FAILED)
+                return (vx_uint8 *)ptr;
+            VX_PRINT(VX_ZONE_WARNING, "No reserved huge pages for "VX_FMT_SIZE" bytes\n", size);
+        }
+#endif
+        map = (vx_uint8 *)mmap(NULL, span, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if ((void *)map == MAP_FAILED)
+            return NULL;
+        head = vxAlignSize((vx_size)map, VX_INT_HUGEPAGE_SIZE) - (vx_size)map;
+        if (head)
+            munmap(map, head);
+        munmap(map + head + size, span - head - size);
+        ptr = map + head;
+#if defined(MADV_HUGEPAGE)
+        if (pool->hugepages != VX_HUGEPAGES_NONE)
+            madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+        return (vx_uint8 *)ptr;
+    }
+#endif
+#if defined(_WIN32) || defined(UNDER_CE)
+    ptr = _aligned_malloc(size, pool->alignment);
+#else
+    if (posix_memalign(&ptr, pool->alignment, size) != 0)
+        ptr = NULL;
+#endif
+    return (vx_uint8 *)ptr;
+}
+
+static void vxDeletePoolBlock(vx_uint8 *ptr, vx_size size)
+{
+#if defined(__linux__)
+    if (size >= VX_INT_HUGEPAGE_SIZE)
+    {
+        munmap(ptr, size);
+        return;
+    }
+#endif
+#if defined(_WIN32) || defined(UNDER_CE)
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+/* Frees the oldest blocks until the free ones take at most the given bytes, with the lock */
+static void vxEvictPoolBlocks(vx_image_pool_t *pool, vx_size bytes, vx_uint32 num)
+{
+    vx_uint32 i = 0u;
+    while ((i < pool->num_blocks) && ((pool->cached > bytes) || (pool->num_blocks - i > num)))
+    {
+        vxDeletePoolBlock(pool->blocks[i].ptr, pool->blocks[i].size);
+        pool->cached -= pool->blocks[i].size;
+        i++;
+    }
+    if (i)
+    {
+        pool->num_blocks -= i;
+        memmove(&pool->blocks[0], &pool->blocks[i], pool->num_blocks * sizeof(vx_pool_block_t));
+    }
+}
+
+void vxInitImagePool(vx_image_pool_t *pool)
+{
+    vxCreateSem(&pool->lock, 1);
+    pool->alignment = VX_MEMORY_ALIGNMENT;
+    pool->row_padding = vx_true_e;
+    pool->hugepages = VX_HUGEPAGES_TRANSPARENT;
+    pool->capacity = VX_INT_IMAGE_POOL_SIZE;
+    pool->num_blocks = 0u;
+    pool->cached = 0ul;
+}
+
+void vxDeinitImagePool(vx_image_pool_t *pool)
+{
+    vxEvictPoolBlocks(pool, 0ul, 0u);
+    vxDestroySem(&pool->lock);
+}
+
+void vxTrimImagePool(vx_image_pool_t *pool, vx_size bytes)
+{
+    vxSemWait(&pool->lock);
+    vxEvictPoolBlocks(pool, bytes, VX_INT_MAX_POOL_BLOCKS);
+    vxSemPost(&pool->lock);
+}
+
+void vxReleasePoolBlock(vx_image_pool_t *pool, vx_uint8 *ptr, vx_size size)
+{
+    vxSemWait(&pool->lock);
+    /* a block allocated before the alignment was raised is not kept */
+    if ((size > pool->capacity) || ((vx_size)ptr & (pool->alignment - 1)))
+    {
+        vxDeletePoolBlock(ptr, size);
+    }
+    else
+    {
+        vxEvictPoolBlocks(pool, pool->capacity - size, VX_INT_MAX_POOL_BLOCKS - 1);
+        pool->blocks[pool->num_blocks].ptr = ptr;
+        pool->blocks[pool->num_blocks].size = size;
+        pool->num_blocks++;
+        pool->cached += size;
+    }
+    vxSemPost(&pool->lock);
+}
+
+vx_bool vxAllocateImageMemory(vx_context_t *context, vx_memory_t *memory)
+{
+    vx_image_pool_t *pool = &context->image_pool;
+    if (memory->allocated == vx_false_e)
+    {
+        vx_int32 p = 0;
+        vxSemWait(&pool->lock);
+        memory->allocated = vx_true_e;
+        for (p = 0; p < memory->nptrs; p++)
+        {
+            vx_size size = vxComputeMemoryLayout(memory, p);
+            vx_uint32 i = pool->num_blocks;
+            if ((pool->row_padding == vx_true_e) && (memory->ndims > VX_DIM_Y))
+            {
+                memory->strides[p][VX_DIM_Y] = (vx_int32)vxAlignSize(memory->strides[p][VX_DIM_Y], pool->alignment);
+                size = (vx_size)memory->strides[p][VX_DIM_Y] * abs(memory->dims[p][VX_DIM_Y]);
+            }
+            size = vxAlignSize(size > 0ul ? size : 1ul, pool->alignment);
+#if defined(__linux__) && defined(MAP_HUGETLB)
+            /* the reserved huge pages are only mapped whole */
+            if ((pool->hugepages == VX_HUGEPAGES_RESERVED) && (size >= VX_INT_HUGEPAGE_SIZE))
+                size = vxAlignSize(size, VX_INT_HUGEPAGE_SIZE);
+#endif
+            /* the most recently released block of the size is the likeliest in the cache */
+            while ((i > 0u) && (pool->blocks[i - 1].size != size))
+                i--;
+            if (i > 0u)
+            {
+                memory->ptrs[p] = pool->blocks[i - 1].ptr;
+                pool->num_blocks--;
+                pool->cached -= size;
+                memmove(&pool->blocks[i - 1], &pool->blocks[i], (pool->num_blocks - i + 1) * sizeof(vx_pool_block_t));
+                VX_PRINT(VX_ZONE_INFO, "Recycled %p for "VX_FMT_SIZE" bytes\n", memory->ptrs[p], size);
+            }
+            else
+            {
+                memory->ptrs[p] = vxNewPoolBlock(pool, size);
+                VX_PRINT(VX_ZONE_INFO, "Allocated %p for "VX_FMT_SIZE" bytes\n", memory->ptrs[p], size);
+            }
+            if (memory->ptrs[p] == NULL)
+            {
+                VX_PRINT(VX_ZONE_ERROR, "Failed to allocated "VX_FMT_SIZE" bytes\n", size);
+                /* unroll */
+                memory->allocated = vx_false_e;
+                for (p = p - 1; p >= 0; p--)
+                {
+                    vxDestroySem(&memory->locks[p]);
+                    vxDeletePoolBlock(memory->ptrs[p], memory->pooled[p]);
+                    memory->ptrs[p] = NULL;
+                    memory->pooled[p] = 0ul;
+                }
+                break;
+            }
+            memory->pooled[p] = size;
+            vxCreateSem(&memory->locks[p], 1);
+        }
+        vxSemPost(&pool->lock);
+        vxPrintMemory(memory);
+    }
+    return memory->allocated;
+}
+
 void vxPrintMemory(vx_memory_t *mem)
 {
     vx_int32 d = 0, p = 0;
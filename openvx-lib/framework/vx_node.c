@@ -148,6 +148,26 @@ VX_API_ENTRY vx_status VX_API_CALL vxQueryNode(vx_node n, vx_enum attribute, voi
                     status = VX_ERROR_INVALID_PARAMETERS;
                 }
                 break;
+            case VX_NODE_ATTRIBUTE_THREADS:
+                if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
+                {
+                    *(vx_uint32 *)ptr = node->attributes.numThreads;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
+            case VX_NODE_ATTRIBUTE_BAND:
+                if (VX_CHECK_PARAM(ptr, size, vx_rectangle_t, 0x3))
+                {
+                    memcpy(ptr, &node->band, size);
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
 #ifdef OPENVX_KHR_NODE_MEMORY
             case VX_NODE_ATTRIBUTE_GLOBAL_DATA_SIZE:
                 if (VX_CHECK_PARAM(ptr, size, vx_size, 0x3))
@@ -268,6 +288,16 @@ VX_API_ENTRY vx_status VX_API_CALL vxSetNodeAttribute(vx_node n, vx_enum attribu
                     status = VX_ERROR_INVALID_PARAMETERS;
                 }
                 break;
+            case VX_NODE_ATTRIBUTE_THREADS:
+                if (VX_CHECK_PARAM(ptr, size, vx_uint32, 0x3))
+                {
+                    node->attributes.numThreads = *(vx_uint32 *)ptr;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_PARAMETERS;
+                }
+                break;
             case VX_NODE_ATTRIBUTE_BORDER_MODE:
                 if (VX_CHECK_PARAM(ptr, size, vx_border_mode_t, 0x3))
                 {
@@ -22,6 +22,10 @@
  */
 
 #include <vx_internal.h>
+#if defined(__linux__) || defined(__ANDROID__) || defined(__QNX__) || defined(__CYGWIN__) || defined(__APPLE__)
+#include <unistd.h>
+#include <sched.h>
+#endif
 
 #define BILLION (1000000000)
 
@@ -39,7 +43,8 @@ vx_bool vxCreateSem(vx_sem_t *sem, vx_uint32 count)
     VX_PRINT(VX_ZONE_OSAL, "sem_init(%p,%u)=>%d errno=%d\n",sem,count,ret,errno);
     if (ret == 0)
 #elif defined(_WIN32) || defined(UNDER_CE)
-    *sem = CreateSemaphore(NULL, count, count, NULL);
+    /* a semaphore created empty is used as a counter (threadpool work) */
+    *sem = CreateSemaphore(NULL, count, (count > 0 ? count : LONG_MAX), NULL);
     if (*sem)
 #endif
         return vx_true_e;
@@ -322,6 +327,31 @@ void vxSleepThread(vx_uint32 milliseconds)
 #endif
 }
 
+void vxYieldThread(void)
+{
+#if defined(__linux__) || defined(__ANDROID__) || defined(__QNX__) || defined(__CYGWIN__) || defined(__APPLE__)
+    sched_yield();
+#elif defined(_WIN32) || defined(UNDER_CE)
+    SwitchToThread();
+#endif
+}
+
+vx_uint32 vxGetNumCores(void)
+{
+    vx_uint32 num = 1u;
+#if defined(__linux__) || defined(__ANDROID__) || defined(__QNX__) || defined(__CYGWIN__) || defined(__APPLE__)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (count > 0)
+        num = (vx_uint32)count;
+#elif defined(_WIN32) || defined(UNDER_CE)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    if (info.dwNumberOfProcessors > 0)
+        num = (vx_uint32)info.dwNumberOfProcessors;
+#endif
+    return num;
+}
+
 vx_thread_t vxCreateThread(vx_thread_f func, void *arg)
 {
     vx_thread_t thread = 0;
@@ -336,24 +366,79 @@ vx_thread_t vxCreateThread(vx_thread_f func, void *arg)
 }
 
 
+vx_int32 vxAtomicLoad(volatile vx_int32 *ptr)
+{
+#if defined(_WIN32) || defined(UNDER_CE)
+    return (vx_int32)InterlockedCompareExchange((volatile LONG *)ptr, 0, 0);
+#else
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void vxAtomicStore(volatile vx_int32 *ptr, vx_int32 value)
+{
+#if defined(_WIN32) || defined(UNDER_CE)
+    InterlockedExchange((volatile LONG *)ptr, (LONG)value);
+#else
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+vx_int32 vxAtomicAdd(volatile vx_int32 *ptr, vx_int32 value)
+{
+#if defined(_WIN32) || defined(UNDER_CE)
+    return (vx_int32)InterlockedExchangeAdd((volatile LONG *)ptr, (LONG)value) + value;
+#else
+    return __atomic_add_fetch(ptr, value, __ATOMIC_ACQ_REL);
+#endif
+}
+
+vx_bool vxAtomicCompareExchange(volatile vx_int32 *ptr, vx_int32 expected, vx_int32 desired)
+{
+#if defined(_WIN32) || defined(UNDER_CE)
+    return (InterlockedCompareExchange((volatile LONG *)ptr, (LONG)desired, (LONG)expected) == (LONG)expected) ? vx_true_e : vx_false_e;
+#else
+    return __atomic_compare_exchange_n(ptr, &expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? vx_true_e : vx_false_e;
+#endif
+}
+
 void vxDestroyThreadpool(vx_threadpool_t **ppool)
 {
     vx_threadpool_t *pool = (ppool ? *ppool : NULL);
     if (pool)
     {
         uint32_t i;
+        if (pool->type == VX_THREADPOOL_WORK_STEALING)
+        {
+            /* wake up every worker so it can see the pool is stopping */
+            pool->running = vx_false_e;
+            for (i = 0u; i < pool->numWorkers; i++)
+            {
+                vxSemPost(&pool->work);
+            }
+        }
         for (i = 0u; i < pool->numWorkers; i++)
         {
             vx_value_t ret;
-            vxPopQueue(pool->workers[i].queue);
+            if (pool->workers[i].queue)
+                vxPopQueue(pool->workers[i].queue);
             vxJoinThread(pool->workers[i].handle, &ret);
             vxStopCapture(&pool->workers[i].perf);
             pool->workers[i].handle = 0;
-            vxDestroyQueue(&pool->workers[i].queue);
+            if (pool->workers[i].queue)
+                vxDestroyQueue(&pool->workers[i].queue);
             pool->workers[i].queue = (vx_queue_t *)NULL;
+            if (pool->workers[i].deque)
+                vxDestroySem(&pool->workers[i].deque->lock);
+            free(pool->workers[i].deque);
+            pool->workers[i].deque = (vx_deque_t *)NULL;
         }
         free(pool->workers);
         pool->workers = (vx_threadpool_worker_t *)NULL;
+        if (pool->type == VX_THREADPOOL_WORK_STEALING)
+        {
+            vxDestroySem(&pool->work);
+        }
         vxDestroySem(&pool->sem);
         vxDeinitEvent(&pool->completed);
         free(pool);
@@ -401,7 +486,98 @@ static vx_value_t vxWorkerThreadpool(void *arg)
     return (vx_value_t)ret;
 }
 
-vx_threadpool_t *vxCreateThreadpool(vx_uint32 numThreads,
+/* The indices are free running, the arithmetic is unsigned so they may wrap. */
+static vx_bool vxPushDeque(vx_deque_t *deque, vx_value_set_t *data)
+{
+    vx_bool pushed = vx_false_e;
+    vxSemWait(&deque->lock);
+    if (deque->bottom - deque->top < VX_INT_MAX_QUEUE_DEPTH)
+    {
+        deque->data[deque->bottom % VX_INT_MAX_QUEUE_DEPTH] = data;
+        deque->bottom++;
+        pushed = vx_true_e;
+    }
+    vxSemPost(&deque->lock);
+    return pushed;
+}
+
+/* The owner takes the item pushed last. */
+static vx_value_set_t *vxPopDeque(vx_deque_t *deque)
+{
+    vx_value_set_t *data = NULL;
+    vxSemWait(&deque->lock);
+    if (deque->bottom != deque->top)
+    {
+        deque->bottom--;
+        data = deque->data[deque->bottom % VX_INT_MAX_QUEUE_DEPTH];
+    }
+    vxSemPost(&deque->lock);
+    return data;
+}
+
+/* A thief takes the oldest item, it passes a deque whose lock is busy and tries the next one. */
+static vx_value_set_t *vxStealDeque(vx_deque_t *deque)
+{
+    vx_value_set_t *data = NULL;
+    if (vxSemTryWait(&deque->lock) == vx_true_e)
+    {
+        if (deque->bottom != deque->top)
+        {
+            data = deque->data[deque->top % VX_INT_MAX_QUEUE_DEPTH];
+            deque->top++;
+        }
+        vxSemPost(&deque->lock);
+    }
+    return data;
+}
+
+static vx_value_t vxWorkerStealingThreadpool(void *arg)
+{
+    vx_threadpool_worker_t *pool_worker = (vx_threadpool_worker_t *)arg;
+    vx_threadpool_t *pool = pool_worker->pool;
+    vx_bool ret = vx_false_e;
+
+    vxStopCapture(&pool_worker->perf);
+    VX_PRINT(VX_ZONE_OSAL, "Threadpool worker %p active, waiting on deque!\n", arg);
+    vxInitPerf(&pool_worker->perf); // reset
+    vxStartCapture(&pool_worker->perf);
+
+    /* each token on the semaphore stands for one item in some deque */
+    while (vxSemWait(&pool->work) == vx_true_e && pool->running == vx_true_e)
+    {
+        vx_threadpool_f function = pool_worker->function;
+        vx_value_set_t *data = vxPopDeque(pool_worker->deque);
+        uint32_t i;
+
+        /* own deque empty, steal from the others in turn */
+        for (i = 1u; data == NULL; i++)
+        {
+            data = vxStealDeque(pool->workers[(pool_worker->index + i) % pool->numWorkers].deque);
+        }
+        VX_PRINT(VX_ZONE_OSAL, "Worker received workitem!\n");
+        pool_worker->data = data;
+        pool_worker->active = vx_true_e;
+        vxStopCapture(&pool_worker->perf);
+        ret = function(pool_worker); /* <=== WORK IS DONE HERE */
+        if (vxAtomicAdd(&pool->numCurrentItems, -1) == 0)
+        {
+            /* an issuer may have reset the event and counted a new batch since, check again under its lock */
+            vxSemWait(&pool->sem);
+            if (vxAtomicLoad(&pool->numCurrentItems) == 0)
+            {
+                vxSetEvent(&pool->completed);
+            }
+            vxSemPost(&pool->sem);
+        }
+        vxStartCapture(&pool_worker->perf);
+        pool_worker->active = vx_false_e;
+    }
+    VX_PRINT(VX_ZONE_OSAL, "Worker exiting!\n");
+    return (vx_value_t)ret;
+}
+
+vx_threadpool_t *vxCreateThreadpool(vx_enum type,
+                                    vx_uint32 numThreads,
                                     vx_uint32 numWorkItems,
                                     vx_size sizeWorkItem,
                                     vx_threadpool_f worker,
@@ -413,10 +589,16 @@ vx_threadpool_t *vxCreateThreadpool(vx_uint32 numThreads,
     {
         uint32_t i;
         vxCreateSem(&pool->sem, 1u);
+        pool->type = type;
         pool->numWorkers = numThreads;
         pool->numWorkItems = numWorkItems;
         pool->sizeWorkItem = (uint32_t)sizeWorkItem;
         vxInitEvent(&pool->completed, vx_false_e);
+        if (type == VX_THREADPOOL_WORK_STEALING)
+        {
+            vxCreateSem(&pool->work, 0u);
+            pool->running = vx_true_e;
+        }
         pool->workers = (vx_threadpool_worker_t *)calloc(pool->numWorkers, sizeof(vx_threadpool_worker_t));
         if (pool->workers)
         {
@@ -424,25 +606,82 @@ vx_threadpool_t *vxCreateThreadpool(vx_uint32 numThreads,
             for (i = 0u; i < pool->numWorkers; i++)
             {
                 vx_threadpool_worker_t *pool_worker = &pool->workers[i];
-                pool_worker->queue = vxCreateQueue();
                 pool_worker->index = i;
                 pool_worker->arg = tmp_arg;
                 pool_worker->function = worker;
                 pool_worker->pool = pool; /* back reference to top level info */
                 vxInitPerf(&pool_worker->perf);
+                if (type == VX_THREADPOOL_WORK_STEALING)
+                {
+                    pool_worker->deque = VX_CALLOC(vx_deque_t);
+                    if (pool_worker->deque)
+                        vxCreateSem(&pool_worker->deque->lock, 1);
+                }
+                else
+                {
+                    pool_worker->queue = vxCreateQueue();
+                }
+            }
+            /* start the threads only once all deques exist, workers look at each other's */
+            for (i = 0u; i < pool->numWorkers; i++)
+            {
+                vx_threadpool_worker_t *pool_worker = &pool->workers[i];
                 vxStartCapture(&pool_worker->perf); /* capture the launch latency */
-                pool_worker->handle = vxCreateThread(&vxWorkerThreadpool, pool_worker);
+                if (type == VX_THREADPOOL_WORK_STEALING)
+                    pool_worker->handle = vxCreateThread(&vxWorkerStealingThreadpool, pool_worker);
+                else
+                    pool_worker->handle = vxCreateThread(&vxWorkerThreadpool, pool_worker);
             }
         }
     }
     return pool;
 }
 
+static vx_bool vxIssueStealingThreadpool(vx_threadpool_t *pool, vx_value_set_t workitems[], uint32_t numWorkItems)
+{
+    uint32_t i;
+    vx_bool wrote = vx_false_e;
+
+    vxSemWait(&pool->sem);
+    vxResetEvent(&pool->completed); /* we're going to have items to work on, so clear the event */
+    /* count the whole batch first so fast workers can't signal completion before the last item is pushed */
+    vxAtomicAdd(&pool->numCurrentItems, (vx_int32)numWorkItems);
+    for (i = 0u; i < numWorkItems; i++)
+    {
+        uint32_t count = 0u;
+        do {
+            uint32_t index = pool->nextWorkerIndex;
+            pool->nextWorkerIndex = (pool->nextWorkerIndex + 1u) % pool->numWorkers;
+            wrote = vxPushDeque(pool->workers[index].deque, &workitems[i]);
+            count++;
+        } while ((wrote == vx_false_e) && (count < pool->numWorkers));
+        if (wrote == vx_false_e)
+        {
+            /* the items from here on were never pushed */
+            if (vxAtomicAdd(&pool->numCurrentItems, -(vx_int32)(numWorkItems - i)) == 0)
+            {
+                vxSetEvent(&pool->completed);
+            }
+            break;
+        }
+    }
+    vxSemPost(&pool->sem);
+    /* wake the workers only once the lock is free, the last one to finish takes it */
+    while (i-- > 0u)
+    {
+        vxSemPost(&pool->work);
+    }
+    return wrote;
+}
+
 vx_bool vxIssueThreadpool(vx_threadpool_t *pool, vx_value_set_t workitems[], uint32_t numWorkItems)
 {
     uint32_t i;
     vx_bool wrote = vx_false_e;
 
+    if (pool->type == VX_THREADPOOL_WORK_STEALING)
+        return vxIssueStealingThreadpool(pool, workitems, numWorkItems);
+
     vxSemWait(&pool->sem);
     vxResetEvent(&pool->completed); /* we're going to have items to work on, so clear the event */
     for (i = 0u; i < numWorkItems; i++)
@@ -486,7 +725,7 @@ vx_bool vxCompleteThreadpool(vx_threadpool_t *pool, vx_bool blocking)
     }
     else
     {
-        if (pool->numCurrentItems == 0)
+        if (vxAtomicLoad(&pool->numCurrentItems) == 0)
         {
             ret = vx_true_e;
         }
@@ -574,10 +813,11 @@ void vxInitPerf(vx_perf_t *perf)
     perf->min = UINT64_MAX;
 }
 
+/* Debug helper, only valid while no other thread uses the queue. */
 void vxPrintQueue(vx_queue_t *q)
 {
     vx_uint32 i;
-    VX_PRINT(VX_ZONE_OSAL, "Queue: %p, lock=%p s,e=[%d,%d] popped=%s\n",q, &q->lock, q->start_index, q->end_index, (q->popped?"yes":"no"));
+    VX_PRINT(VX_ZONE_OSAL, "Queue: %p s,e=[%d,%d] popped=%s\n",q, q->start_index, q->end_index, (vxAtomicLoad(&q->popped)?"yes":"no"));
     for (i = 0; i < VX_INT_MAX_QUEUE_DEPTH; i++)
     {
         if (q->data[i])
@@ -591,13 +831,17 @@ void vxInitQueue(vx_queue_t *q)
 {
     if (q)
     {
-        memset(q->data, 0, sizeof(q->data));
+        vx_int32 i;
+        memset((void *)q->data, 0, sizeof(q->data));
+        for (i = 0; i < VX_INT_MAX_QUEUE_DEPTH; i++)
+            q->seq[i] = i;
         q->start_index = 0;
-        q->end_index = -1;
-        vxCreateSem(&q->lock, 1);
-        vxInitEvent(&q->readEvent, vx_false_e);
-        vxInitEvent(&q->writeEvent, vx_false_e);
-        vxSetEvent(&q->writeEvent);
+        q->end_index = 0;
+        q->readers = 0;
+        q->writers = 0;
+        vxAtomicStore(&q->popped, vx_false_e);
+        vxCreateSem(&q->readable, 0);
+        vxCreateSem(&q->writable, 0);
     }
 }
 
@@ -618,46 +862,93 @@ vx_queue_t *vxCreateQueue(vx_uint32 numItems, vx_size itemSize) {
     return q;
 }
 
+/* A slot is free for position pos when its sequence is pos and filled when
+ * it is pos + 1. The positions are free running, the arithmetic is unsigned. */
+static vx_bool vxTryWriteQueue(vx_queue_t *q, vx_value_set_t *data)
+{
+    vx_uint32 pos = (vx_uint32)vxAtomicLoad(&q->end_index);
+    for (;;)
+    {
+        vx_uint32 i = pos % VX_INT_MAX_QUEUE_DEPTH;
+        vx_int32 diff = (vx_int32)((vx_uint32)vxAtomicLoad(&q->seq[i]) - pos);
+        if (diff == 0)
+        {
+            if (vxAtomicCompareExchange(&q->end_index, (vx_int32)pos, (vx_int32)(pos + 1u)) == vx_true_e)
+            {
+                q->data[i] = data;
+                vxAtomicStore(&q->seq[i], (vx_int32)(pos + 1u));
+                return vx_true_e;
+            }
+        }
+        else if (diff < 0)
+        {
+            return vx_false_e; /* full */
+        }
+        pos = (vx_uint32)vxAtomicLoad(&q->end_index);
+    }
+}
+
+static vx_bool vxTryReadQueue(vx_queue_t *q, vx_value_set_t **data)
+{
+    vx_uint32 pos = (vx_uint32)vxAtomicLoad(&q->start_index);
+    for (;;)
+    {
+        vx_uint32 i = pos % VX_INT_MAX_QUEUE_DEPTH;
+        vx_int32 diff = (vx_int32)((vx_uint32)vxAtomicLoad(&q->seq[i]) - (pos + 1u));
+        if (diff == 0)
+        {
+            if (vxAtomicCompareExchange(&q->start_index, (vx_int32)pos, (vx_int32)(pos + 1u)) == vx_true_e)
+            {
+                *data = q->data[i];
+                q->data[i] = NULL;
+                vxAtomicStore(&q->seq[i], (vx_int32)(pos + VX_INT_MAX_QUEUE_DEPTH));
+                return vx_true_e;
+            }
+        }
+        else if (diff < 0)
+        {
+            return vx_false_e; /* empty */
+        }
+        pos = (vx_uint32)vxAtomicLoad(&q->start_index);
+    }
+}
+
 vx_bool vxWriteQueue(vx_queue_t *q, vx_value_set_t *data)
 {
     vx_bool wrote = vx_false_e;
     if (q)
     {
-        // wait for the queue to be writeable
-        VX_PRINT(VX_ZONE_OSAL, "About to wait on queue %p\n", q);
-        while (vxWaitEvent(&q->writeEvent, VX_INT_FOREVER) == vx_true_e)
+        while (vxAtomicLoad(&q->popped) == vx_false_e)
         {
-            VX_PRINT(VX_ZONE_OSAL, "Signalled!\n");
-            vxSemWait(&q->lock);
-            if (q->popped == vx_false_e)
+            vx_uint32 spins;
+            wrote = vxTryWriteQueue(q, data);
+            // full, give the readers a few chances before sleeping
+            for (spins = 0u; wrote == vx_false_e && spins < VX_INT_QUEUE_SPINS; spins++)
             {
-                // cause other writers to block
-                vxResetEvent(&q->writeEvent);
-                // add the value to the data array if space is available
-                if (q->start_index != q->end_index)
-                {
-                    if (q->end_index == -1) // empty
-                        q->end_index = q->start_index;
-                    q->data[q->end_index] = data;
-                    q->end_index = (q->end_index + 1)%VX_INT_MAX_QUEUE_DEPTH;
-                    wrote = vx_true_e;
-                    // cause other writers to unblock.
-                    if (q->start_index != q->end_index)
-                        vxSetEvent(&q->writeEvent);
-                    vxPrintQueue(q);
-                }
-                else
-                {
-                    // two writers may have raced to enter...
-                    // the second may have a full queue here...
-                }
-
-                if (q->end_index != -1)
-                    vxSetEvent(&q->readEvent);
+                vxYieldThread();
+                wrote = vxTryWriteQueue(q, data);
+            }
+            if (wrote == vx_false_e)
+            {
+                // full, announce the wait and check again so a read in between is not missed
+                VX_PRINT(VX_ZONE_OSAL, "About to wait on queue %p\n", q);
+                vxAtomicAdd(&q->writers, 1);
+                wrote = vxTryWriteQueue(q, data);
+                if (wrote == vx_false_e && vxAtomicLoad(&q->popped) == vx_false_e)
+                    vxSemWait(&q->writable);
+                vxAtomicAdd(&q->writers, -1);
             }
-            vxSemPost(&q->lock);
-            if (q->popped == vx_true_e || wrote == vx_true_e)
+            if (wrote == vx_true_e)
+            {
+                if (vxAtomicAdd(&q->readers, 0) > 0)
+                    vxSemPost(&q->readable);
                 break;
+            }
+        }
+        if (wrote == vx_false_e)
+        {
+            // popped, pass the wake up on to the next sleeping writer
+            vxSemPost(&q->writable);
         }
     }
     return wrote;
@@ -668,32 +959,37 @@ vx_bool vxReadQueue(vx_queue_t *q, vx_value_set_t **data)
     vx_bool red = vx_false_e;
     if (q)
     {
-        VX_PRINT(VX_ZONE_OSAL, "About to wait on queue %p\n", q);
-        while (vxWaitEvent(&q->readEvent, VX_INT_FOREVER) == vx_true_e)
+        while (vxAtomicLoad(&q->popped) == vx_false_e)
         {
-            VX_PRINT(VX_ZONE_OSAL, "Signalled!\n");
-            vxSemWait(&q->lock);
-            if (q->popped == vx_false_e)
+            vx_uint32 spins;
+            red = vxTryReadQueue(q, data);
+            // empty, give the writers a few chances before sleeping
+            for (spins = 0u; red == vx_false_e && spins < VX_INT_QUEUE_SPINS; spins++)
             {
-                if (q->end_index != -1) // not empty
-                {
-                    *data = q->data[q->start_index];
-                    q->data[q->start_index] = NULL;
-                    q->start_index = (q->start_index + 1)%VX_INT_MAX_QUEUE_DEPTH;
-                    red = vx_true_e;
-                    if (q->start_index == q->end_index) // wrapped to empty
-                    {
-                        vxResetEvent(&q->readEvent);
-                        q->end_index = -1;
-                    }
-                    vxPrintQueue(q);
-                }
-
-                vxSetEvent(&q->writeEvent);
+                vxYieldThread();
+                red = vxTryReadQueue(q, data);
+            }
+            if (red == vx_false_e)
+            {
+                // empty, announce the wait and check again so a write in between is not missed
+                VX_PRINT(VX_ZONE_OSAL, "About to wait on queue %p\n", q);
+                vxAtomicAdd(&q->readers, 1);
+                red = vxTryReadQueue(q, data);
+                if (red == vx_false_e && vxAtomicLoad(&q->popped) == vx_false_e)
+                    vxSemWait(&q->readable);
+                vxAtomicAdd(&q->readers, -1);
             }
-            vxSemPost(&q->lock);
-            if (q->popped == vx_true_e || red == vx_true_e)
+            if (red == vx_true_e)
+            {
+                if (vxAtomicAdd(&q->writers, 0) > 0)
+                    vxSemPost(&q->writable);
                 break;
+            }
+        }
+        if (red == vx_false_e)
+        {
+            // popped, pass the wake up on to the next sleeping reader
+            vxSemPost(&q->readable);
         }
         VX_PRINT(VX_ZONE_OSAL, "Leaving with %d\n", red);
     }
@@ -704,11 +1000,9 @@ void vxPopQueue(vx_queue_t *q)
 {
     if (q)
     {
-        vxSemWait(&q->lock);
-        q->popped = vx_true_e;
-        vxSetEvent(&q->readEvent);
-        vxSetEvent(&q->writeEvent);
-        vxSemPost(&q->lock);
+        vxAtomicStore(&q->popped, vx_true_e);
+        vxSemPost(&q->readable);
+        vxSemPost(&q->writable);
     }
 }
 
@@ -717,10 +1011,9 @@ void vxDeinitQueue(vx_queue_t *q)
     if (q)
     {
         q->start_index = 0;
-        q->end_index = -1;
-        vxDestroySem(&q->lock);
-        vxDeinitEvent(&q->readEvent);
-        vxDeinitEvent(&q->writeEvent);
+        q->end_index = 0;
+        vxDestroySem(&q->readable);
+        vxDestroySem(&q->writable);
     }
 }
 
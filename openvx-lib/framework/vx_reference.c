@@ -93,6 +93,8 @@ vx_bool vxAddReference(vx_context context, vx_reference ref)
     vx_bool ret = vx_false_e;
     if (context)
     {
+        /* graphs may be executed concurrently (vxScheduleGraph), guard the table */
+        vxSemWait(&context->base.lock);
         for (r = 0; r < VX_INT_MAX_REF; r++)
         {
             if (context->reftable[r] == NULL)
@@ -103,6 +105,7 @@ vx_bool vxAddReference(vx_context context, vx_reference ref)
                 break;
             }
         }
+        vxSemPost(&context->base.lock);
     }
     else{
         /* can't add context to itself */
@@ -197,6 +200,7 @@ static vx_type_size_t type_sizes[] = {
     {VX_TYPE_COORDINATES2D, sizeof(vx_coordinates2d_t)},
     {VX_TYPE_COORDINATES3D, sizeof(vx_coordinates3d_t)},
     {VX_TYPE_KEYPOINT,      sizeof(vx_keypoint_t)},
+    {VX_TYPE_KEYPOINT_F32,  sizeof(vx_keypoint_f32_t)},
     // pseudo objects
     {VX_TYPE_ERROR,     sizeof(vx_error_t)},
     {VX_TYPE_META_FORMAT,sizeof(vx_meta_format_t)},
@@ -326,16 +330,20 @@ vx_bool vxIsValidSpecificReference(vx_reference ref, vx_enum type)
 vx_bool vxRemoveReference(vx_context context, vx_reference ref)
 {
     vx_uint32 r;
+    vx_bool ret = vx_false_e;
+    vxSemWait(&context->base.lock);
     for (r = 0; r < VX_INT_MAX_REF; r++)
     {
         if (context->reftable[r] == ref)
         {
             context->reftable[r] = NULL;
             context->num_references--;
-            return vx_true_e;
+            ret = vx_true_e;
+            break;
         }
     }
-    return vx_false_e;
+    vxSemPost(&context->base.lock);
+    return ret;
 }
 
 void vxPrintReference(vx_reference ref)
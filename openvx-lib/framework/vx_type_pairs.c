@@ -50,6 +50,7 @@ vx_enum_string_t type_pairs[] = {
     {VX_STRINGERIZE(VX_TYPE_COORDINATES3D),sizeof(vx_coordinates3d_t)*2},
     {VX_STRINGERIZE(VX_TYPE_RECTANGLE),sizeof(vx_rectangle_t)*2},
     {VX_STRINGERIZE(VX_TYPE_KEYPOINT),sizeof(vx_keypoint_t)*2},
+    {VX_STRINGERIZE(VX_TYPE_KEYPOINT_F32),sizeof(vx_keypoint_f32_t)*2},
     /* data objects */
     {VX_STRINGERIZE(VX_TYPE_ARRAY),0},
     {VX_STRINGERIZE(VX_TYPE_DISTRIBUTION),0},
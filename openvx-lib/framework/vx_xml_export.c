@@ -464,6 +464,22 @@ static vx_status vxExportToXMLArray(FILE* fp, vx_reference refs[], vx_uint32 r,
                     }
                     break;
                 }
+                case VX_TYPE_KEYPOINT_F32:
+                {
+                    vx_keypoint_f32_t *key = (vx_keypoint_f32_t *)array->memory.ptrs[0];
+                    for (j = 0; j < array->num_items; j++) {
+                        fprintf(fp, "%s\t<keypoint_f32>\n", indent);
+                        fprintf(fp, "%s\t\t<x>%f</x>\n", indent, key[j].x);
+                        fprintf(fp, "%s\t\t<y>%f</y>\n", indent, key[j].y);
+                        fprintf(fp, "%s\t\t<strength>%f</strength>\n", indent, key[j].strength);
+                        fprintf(fp, "%s\t\t<scale>%f</scale>\n", indent, key[j].scale);
+                        fprintf(fp, "%s\t\t<orientation>%f</orientation>\n", indent, key[j].orientation);
+                        fprintf(fp, "%s\t\t<tracking_status>%u</tracking_status>\n", indent, key[j].tracking_status);
+                        fprintf(fp, "%s\t\t<error>%f</error>\n", indent, key[j].error);
+                        fprintf(fp, "%s\t</keypoint_f32>\n", indent);
+                    }
+                    break;
+                }
                 case VX_TYPE_COORDINATES2D:
                 {
                     vx_coordinates2d_t *cord2d = (vx_coordinates2d_t *)array->memory.ptrs[0];
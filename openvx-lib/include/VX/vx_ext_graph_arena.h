@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_GRAPH_ARENA_H_
+#define _VX_EXT_GRAPH_ARENA_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Graph Arena Extension.
+ * \details Reports the memory the virtual images of a graph take, once they are
+ * placed in one shared arena by their liveness.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_graph
+ */
+#define OPENVX_EXT_GRAPH_ARENA "vx_ext_graph_arena"
+
+/*! \brief The graph attributes of the extension.
+ * \note 0x0 and 0x1 are taken by \ref VX_GRAPH_ATTRIBUTE_TILE_HEIGHT and
+ * \ref VX_GRAPH_ATTRIBUTE_NODE_PERFORMANCE.
+ * \ingroup group_graph
+ */
+enum vx_ext_graph_arena_graph_attribute_e {
+    /*! \brief Returns the most bytes of virtual images alive at once while the graph executes,
+     * known once the graph is verified. Use a <tt>\ref vx_size</tt> parameter. */
+    VX_GRAPH_ATTRIBUTE_PEAK_MEMORY = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_GRAPH) + 0x2,
+    /*! \brief Returns the bytes of the memory the virtual images of the graph share, which
+     * is at least \ref VX_GRAPH_ATTRIBUTE_PEAK_MEMORY. Use a <tt>\ref vx_size</tt> parameter. */
+    VX_GRAPH_ATTRIBUTE_ARENA_SIZE = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_GRAPH) + 0x3,
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_IMAGE_HANDLE_H_
+#define _VX_EXT_IMAGE_HANDLE_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Image Handle Swap Extension.
+ * \details Lets an application hand its decoded frames to an image in place, without
+ * copying them in with <tt>\ref vxAccessImagePatch</tt>.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_image
+ */
+#define OPENVX_EXT_IMAGE_HANDLE "vx_ext_image_handle"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*! \brief Points an image at new externally allocated memory.
+ * \details An imported image gives back its previous pointers in \a prev_ptrs.
+ * An image that owns its memory frees it, keeps its dense layout and becomes imported,
+ * its \a prev_ptrs are set to NULL. Graphs that use the image see the new data on
+ * their next execution, so the memory must keep the layout of the image and must not
+ * be swapped while the image is accessed or a graph that uses it is running.
+ * \param [in] image The reference to the image, it can't be an ROI of another image.
+ * \param [in] new_ptrs[] The array of pointers to each plane, none of them can be NULL.
+ * \param [out] prev_ptrs[] The array of the previous pointers, can be NULL.
+ * \param [in] num_planes The number of planes of the image.
+ * \return A <tt>\ref vx_status_e</tt> enumeration.
+ * \retval VX_SUCCESS The pointers were swapped.
+ * \retval VX_ERROR_INVALID_REFERENCE The image reference is not valid.
+ * \retval VX_ERROR_INVALID_PARAMETERS The image is an ROI or constant, or the pointers are not valid.
+ * \retval VX_ERROR_NO_MEMORY The own memory of the image could not be laid out.
+ * \ingroup group_image
+ */
+VX_API_ENTRY vx_status VX_API_CALL vxSwapImageHandle(vx_image image, void *new_ptrs[], void *prev_ptrs[], vx_size num_planes);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
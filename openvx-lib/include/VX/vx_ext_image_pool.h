@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_IMAGE_POOL_H_
+#define _VX_EXT_IMAGE_POOL_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Image Pool Extension.
+ * \details Controls how the context allocates the image planes: their alignment, the
+ * padding of their rows, their huge page backing and the recycling of released planes.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_context
+ */
+#define OPENVX_EXT_IMAGE_POOL "vx_ext_image_pool"
+
+/*! \brief The enumeration types of the extension, in the <tt>\ref VX_ID_DEFAULT</tt> range.
+ * \note 0x0 is taken by \ref VX_ENUM_THREADPOOL.
+ * \ingroup group_context
+ */
+enum vx_ext_image_pool_enum_e {
+    VX_ENUM_HUGEPAGES       = 0x1, /*!< \brief Huge page backing of image memory. */
+};
+
+/*! \brief The huge page backing of the large image planes.
+ * \see <tt>\ref VX_CONTEXT_ATTRIBUTE_IMAGE_HUGEPAGES</tt>
+ * \ingroup group_context
+ */
+enum vx_hugepages_e {
+    /*! \brief The planes use the regular pages. */
+    VX_HUGEPAGES_NONE = VX_ENUM_BASE(VX_ID_DEFAULT, VX_ENUM_HUGEPAGES) + 0x0,
+    /*! \brief The planes are advised to the system for transparent huge pages. */
+    VX_HUGEPAGES_TRANSPARENT = VX_ENUM_BASE(VX_ID_DEFAULT, VX_ENUM_HUGEPAGES) + 0x1,
+    /*! \brief The planes are taken from the reserved huge pages, the transparent ones
+     * are used when none are left. */
+    VX_HUGEPAGES_RESERVED = VX_ENUM_BASE(VX_ID_DEFAULT, VX_ENUM_HUGEPAGES) + 0x2,
+};
+
+/*! \brief The context attributes of the extension.
+ * \note 0x0 is taken by \ref VX_CONTEXT_ATTRIBUTE_THREADPOOL.
+ * \ingroup group_context
+ */
+enum vx_ext_image_pool_context_attribute_e {
+    /*! \brief The alignment in bytes of the image planes the context allocates, a power of two
+     * from 16 to 4096. Affects the images allocated afterwards. Use a <tt>\ref vx_size</tt> parameter.
+     * \note The default is 64, a cache line.
+     */
+    VX_CONTEXT_ATTRIBUTE_IMAGE_ALIGNMENT = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_CONTEXT) + 0x1,
+    /*! \brief If true the rows of the image planes the context allocates are padded to
+     * <tt>\ref VX_CONTEXT_ATTRIBUTE_IMAGE_ALIGNMENT</tt>, so every row starts aligned.
+     * Use a <tt>\ref vx_bool</tt> parameter. \note The default is true.
+     */
+    VX_CONTEXT_ATTRIBUTE_IMAGE_ROW_PADDING = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_CONTEXT) + 0x2,
+    /*! \brief How the large image planes are backed by huge pages, see <tt>\ref vx_hugepages_e</tt>.
+     * Use a <tt>\ref vx_enum</tt> parameter. \note The default is <tt>\ref VX_HUGEPAGES_TRANSPARENT</tt>.
+     */
+    VX_CONTEXT_ATTRIBUTE_IMAGE_HUGEPAGES = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_CONTEXT) + 0x3,
+    /*! \brief The most bytes of released image planes the context keeps to give to new images
+     * of the same size, 0 disables the recycling. Use a <tt>\ref vx_size</tt> parameter.
+     */
+    VX_CONTEXT_ATTRIBUTE_IMAGE_POOL_SIZE = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_CONTEXT) + 0x4,
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_KEYPOINT_F32_H_
+#define _VX_EXT_KEYPOINT_F32_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Sub-Pixel Keypoint Extension.
+ * \details Adds a keypoint with floating point coordinates, which arrays can hold in place of
+ * <tt>\ref vx_keypoint_t</tt> to keep the sub-pixel positions found by the optical flow.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_basic_features
+ */
+#define OPENVX_EXT_KEYPOINT_F32 "vx_ext_keypoint_f32"
+
+/*! \brief The keypoint data structure with sub-pixel coordinates, otherwise
+ * identical to <tt>\ref vx_keypoint_t</tt>.
+ * \ingroup group_basic_features
+ */
+typedef struct _vx_keypoint_f32_t {
+    vx_float32 x;               /*!< \brief The x coordinate. */
+    vx_float32 y;               /*!< \brief The y coordinate. */
+    vx_float32 strength;        /*!< \brief The strength of the keypoint. Its definition is specific to the corner detector. */
+    vx_float32 scale;           /*!< \brief Initialized to 0 by corner detectors. */
+    vx_float32 orientation;     /*!< \brief Initialized to 0 by corner detectors. */
+    vx_int32 tracking_status;   /*!< \brief A zero indicates a lost point. Initialized to 1 by corner detectors. */
+    vx_float32 error;           /*!< \brief A tracking method specific error. Initialized to 0 by corner detectors. */
+} vx_keypoint_f32_t;
+
+/*! \brief The struct types of the extension.
+ * \note The types of <tt>\ref vxRegisterUserStruct</tt> count up from \ref VX_TYPE_USER_STRUCT_START,
+ * 0x100 to 0x4FF for the 1024 user structs of the sample, so the extension starts at 0x600.
+ * \ingroup group_basic_features
+ */
+enum vx_ext_keypoint_f32_type_e {
+    VX_TYPE_KEYPOINT_F32    = 0x600,/*!< \brief A <tt>\ref vx_keypoint_f32_t</tt>, for <tt>\ref vxCreateArray</tt>. */
+};
+
+#endif
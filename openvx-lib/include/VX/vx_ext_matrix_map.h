@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_MATRIX_MAP_H_
+#define _VX_EXT_MATRIX_MAP_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Matrix Map Extension.
+ * \details Gives the host direct access to the elements of a matrix, where
+ * <tt>\ref vxAccessMatrix</tt> and <tt>\ref vxCommitMatrix</tt> copy them.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_matrix
+ */
+#define OPENVX_EXT_MATRIX_MAP "vx_ext_matrix_map"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*! \brief Gives direct access to the matrix data, with no copy.
+ * \details The elements are laid out as by <tt>\ref vxAccessMatrix</tt>. The matrix stays
+ * locked until <tt>\ref vxUnmapMatrix</tt>, other maps, accesses and commits of it wait.
+ * \param [in] mat The reference to the matrix.
+ * \param [out] ptr The location at which to store the pointer to the elements.
+ * \param [in] usage A <tt>\ref vx_accessor_e</tt> enumeration, the usage of the elements.
+ * \return A <tt>\ref vx_status_e</tt> enumeration.
+ * \retval VX_SUCCESS The matrix is mapped.
+ * \retval VX_ERROR_INVALID_REFERENCE The matrix reference is not valid.
+ * \retval VX_ERROR_INVALID_PARAMETERS The pointer or the usage is not valid.
+ * \retval VX_ERROR_NO_MEMORY The matrix could not be allocated.
+ * \post <tt>\ref vxUnmapMatrix</tt>
+ * \ingroup group_matrix
+ */
+VX_API_ENTRY vx_status VX_API_CALL vxMapMatrix(vx_matrix mat, void **ptr, vx_enum usage);
+
+/*! \brief Ends the direct access to the matrix data, a map which writes counts as a write.
+ * \param [in] mat The reference to the matrix.
+ * \param [in] ptr The pointer given by <tt>\ref vxMapMatrix</tt>.
+ * \return A <tt>\ref vx_status_e</tt> enumeration.
+ * \retval VX_SUCCESS The matrix is unmapped.
+ * \retval VX_ERROR_INVALID_REFERENCE The matrix reference is not valid.
+ * \retval VX_ERROR_INVALID_PARAMETERS The matrix is not mapped or the pointer is not its data.
+ * \pre <tt>\ref vxMapMatrix</tt>
+ * \ingroup group_matrix
+ */
+VX_API_ENTRY vx_status VX_API_CALL vxUnmapMatrix(vx_matrix mat, void *ptr);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
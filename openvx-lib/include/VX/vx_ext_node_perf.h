@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_NODE_PERF_H_
+#define _VX_EXT_NODE_PERF_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Node Performance Extension.
+ * \details Returns the performance of all the nodes of a graph in one query.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_performance
+ */
+#define OPENVX_EXT_NODE_PERF "vx_ext_node_perf"
+
+/*! \brief The performance of one node of a graph.
+ * \see VX_GRAPH_ATTRIBUTE_NODE_PERFORMANCE
+ * \ingroup group_performance
+ */
+typedef struct _vx_node_perf_t {
+    vx_char   name[VX_MAX_KERNEL_NAME]; /*!< \brief The name of the kernel the node executes. */
+    vx_perf_t perf;                     /*!< \brief The performance of the node. */
+} vx_node_perf_t;
+
+/*! \brief The graph attributes of the extension.
+ * \note 0x0 is taken by \ref VX_GRAPH_ATTRIBUTE_TILE_HEIGHT.
+ * \ingroup group_graph
+ */
+enum vx_ext_node_perf_graph_attribute_e {
+    /*! \brief Returns the kernel name and performance of each node, in the order the nodes were added.
+     * Use an array of <tt>\ref vx_node_perf_t</tt> of at most \ref VX_GRAPH_ATTRIBUTE_NUMNODES items;
+     * a shorter array receives the first nodes only. */
+    VX_GRAPH_ATTRIBUTE_NODE_PERFORMANCE = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_GRAPH) + 0x1,
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_NODE_THREADS_H_
+#define _VX_EXT_NODE_THREADS_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Node Threads Extension.
+ * \details Bounds the threads a data-parallel kernel splits the work of one node across.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_node
+ */
+#define OPENVX_EXT_NODE_THREADS "vx_ext_node_threads"
+
+/*! \brief The node attributes of the extension.
+ * \ingroup group_node
+ */
+enum vx_ext_node_threads_attribute_e {
+    /*! \brief Gets or sets the number of threads a data-parallel kernel may split its
+     * work across. Zero (the default) lets the kernel use one thread per online core.
+     * Kernels read it at graph verification. Use a <tt>\ref vx_uint32</tt> parameter.
+     */
+    VX_NODE_ATTRIBUTE_THREADS = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_NODE) + 0x0,
+};
+
+#endif
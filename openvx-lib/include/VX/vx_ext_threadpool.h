@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_THREADPOOL_H_
+#define _VX_EXT_THREADPOOL_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Threadpool Selection Extension.
+ * \details Picks how the context spreads the nodes of a graph over its worker threads.
+ * The attributes and enumerations live in the <tt>\ref VX_ID_DEFAULT</tt> vendor range,
+ * clear of the ones Khronos may define.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_context
+ */
+#define OPENVX_EXT_THREADPOOL "vx_ext_threadpool"
+
+/*! \brief The enumeration types of the extension, in the <tt>\ref VX_ID_DEFAULT</tt> range.
+ * \ingroup group_context
+ */
+enum vx_ext_threadpool_enum_e {
+    VX_ENUM_THREADPOOL      = 0x0, /*!< \brief A threadpool policy. */
+};
+
+/*! \brief The threadpool policies.
+ * \see <tt>\ref VX_CONTEXT_ATTRIBUTE_THREADPOOL</tt>
+ * \ingroup group_context
+ */
+enum vx_threadpool_e {
+    /*! \brief Work is assigned to the queues of the workers in turn. */
+    VX_THREADPOOL_ROUND_ROBIN = VX_ENUM_BASE(VX_ID_DEFAULT, VX_ENUM_THREADPOOL) + 0x0,
+    /*! \brief Each worker takes the work of its own deque, an idle one steals from the others. */
+    VX_THREADPOOL_WORK_STEALING = VX_ENUM_BASE(VX_ID_DEFAULT, VX_ENUM_THREADPOOL) + 0x1,
+};
+
+/*! \brief The context attributes of the extension.
+ * \ingroup group_context
+ */
+enum vx_ext_threadpool_context_attribute_e {
+    /*! \brief Gets or sets the threadpool policy of the context, see <tt>\ref vx_threadpool_e</tt>.
+     * Setting it replaces the worker threads, which fails with
+     * <tt>\ref VX_ERROR_GRAPH_SCHEDULED</tt> while a graph executes. Use a <tt>\ref vx_enum</tt> parameter.
+     * \note The default is <tt>\ref VX_THREADPOOL_WORK_STEALING</tt> when the VX_THREADPOOL
+     * environment variable is "stealing", <tt>\ref VX_THREADPOOL_ROUND_ROBIN</tt> otherwise.
+     */
+    VX_CONTEXT_ATTRIBUTE_THREADPOOL = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_CONTEXT) + 0x0,
+};
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#ifndef _VX_EXT_TILED_GRAPH_H_
+#define _VX_EXT_TILED_GRAPH_H_
+
+#include <VX/vx.h>
+
+/*! \file
+ * \brief The Tiled Graph Extension.
+ * \details Runs chains of row kernels band by band, so the images between the nodes of a
+ * chain are read while they are still in the cache.
+ */
+
+/*! \brief The extension name.
+ * \ingroup group_graph
+ */
+#define OPENVX_EXT_TILED_GRAPH "vx_ext_tiled_graph"
+
+/*! \brief The kernel attributes of the extension.
+ * \ingroup group_user_kernels
+ */
+enum vx_ext_tiled_graph_kernel_attribute_e {
+    /*! \brief Lets the nodes of a kernel run in the bands of a tiled graph, see
+     * \ref VX_GRAPH_ATTRIBUTE_TILE_HEIGHT. Set before the kernel is finalized.
+     * Use a <tt>\ref vx_kernel_input_rows_f</tt> parameter.
+     */
+    VX_KERNEL_ATTRIBUTE_INPUT_ROWS = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_KERNEL) + 0x0,
+};
+
+/*! \brief The node attributes of the extension.
+ * \ingroup group_node
+ */
+enum vx_ext_tiled_graph_node_attribute_e {
+    /*! \brief Returns the rows of its output image the node computes in this call of its
+     * kernel, from start_y up to end_y, when it runs in the bands of a tiled graph. An empty
+     * rectangle when it computes the whole image. Use a <tt>\ref vx_rectangle_t</tt> parameter.
+     * \note 0x0 is taken by \ref VX_NODE_ATTRIBUTE_THREADS.
+     */
+    VX_NODE_ATTRIBUTE_BAND = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_NODE) + 0x1,
+};
+
+/*! \brief The graph attributes of the extension.
+ * \ingroup group_graph
+ */
+enum vx_ext_tiled_graph_graph_attribute_e {
+    /*! \brief Gets or sets the rows of the bands of a tiled graph, 0 (the default) turns the
+     * tiling off. A chain of nodes whose kernels have \ref VX_KERNEL_ATTRIBUTE_INPUT_ROWS, each
+     * reading the output image of the one before it, then runs band by band: a band of the
+     * last node is computed once the nodes before it have computed the rows it reads. The
+     * graph is verified again once it is set. Use a <tt>\ref vx_uint32</tt> parameter.
+     */
+    VX_GRAPH_ATTRIBUTE_TILE_HEIGHT = VX_ATTRIBUTE_BASE(VX_ID_DEFAULT, VX_TYPE_GRAPH) + 0x0,
+};
+
+/*! \brief The rows of an input image a band of rows of the output image of a node reads.
+ * \param [in] node The handle to the node.
+ * \param [in] parameters The array of parameter references, as the kernel gets them.
+ * \param [in] index The index of the input image parameter.
+ * \param [in] start_y The first row of the band of the output.
+ * \param [in] end_y The row after the last row of the band of the output.
+ * \param [out] in_start_y The first row of the input the band reads.
+ * \param [out] in_end_y The row after the last row of the input the band reads, at most
+ * the height of the input.
+ * \see VX_KERNEL_ATTRIBUTE_INPUT_ROWS
+ * \ingroup group_user_kernels
+ */
+typedef vx_status (VX_CALLBACK *vx_kernel_input_rows_f)(vx_node node, const vx_reference parameters[],
+                                                        vx_uint32 index, vx_uint32 start_y, vx_uint32 end_y,
+                                                        vx_uint32 *in_start_y, vx_uint32 *in_end_y);
+
+#endif
@@ -118,6 +118,14 @@ void vxFindNextNodes(vx_graph graph,
  */
 void vxContaminateGraphs(vx_reference ref);
 
+/*! \brief Runs a chain of nodes of a tiled graph band by band, from its head on.
+ * \details The nodes are then executed, with one run of each in their performance.
+ * \return The action of the first callback which does not continue, or
+ * \ref VX_ACTION_ABANDON when one of the kernels fails.
+ * \ingroup group_int_graph
+ */
+vx_action vxExecuteChain(vx_node head);
+
 /*! \brief Destroys a Graph.
  * \ingroup group_int_graph
  */
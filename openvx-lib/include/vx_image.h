@@ -93,6 +93,33 @@ void vxFreeImage(vx_image image);
  */
 vx_bool vxAllocateImage(vx_image image);
 
+/*! \brief Gives a kernel a patch of an image parameter of its node, mapped with no copy and no lock.
+ * \details The graph allocated the image when it was verified and runs its writer before its
+ * readers, so the node has the image to itself while it executes and only the usage is
+ * checked, nothing is logged or counted. Host code uses \ref vxAccessImagePatch instead.
+ * \param [in] image The image parameter.
+ * \param [in] rect The patch, in the coordinates of the image.
+ * \param [in] plane_index The plane of the patch.
+ * \param [out] addr The addressing of the patch.
+ * \param [out] ptr The location at which to store the pointer to the patch.
+ * \param [in] usage The \ref vx_accessor_e usage of the patch.
+ * \retval VX_ERROR_INVALID_PARAMETERS The usage is not a \ref vx_accessor_e.
+ * \retval VX_ERROR_NOT_SUPPORTED The usage writes to a constant image.
+ * \retval VX_ERROR_NO_MEMORY The image could not be allocated.
+ * \ingroup group_int_image
+ */
+vx_status vxMapImagePatchInt(vx_image image, const vx_rectangle_t *rect, vx_uint32 plane_index,
+                             vx_imagepatch_addressing_t *addr, void **ptr, vx_enum usage);
+
+/*! \brief Ends a \ref vxMapImagePatchInt in constant time, a usage which writes grows the
+ * valid region by \a rect and counts as a write to the image.
+ * \param [in] image The image parameter.
+ * \param [in] rect The patch given to \ref vxMapImagePatchInt.
+ * \param [in] usage The usage given to \ref vxMapImagePatchInt.
+ * \ingroup group_int_image
+ */
+void vxUnmapImagePatchInt(vx_image image, const vx_rectangle_t *rect, vx_enum usage);
+
 /*! \brief Prints the values of the images.
  * \ingroup group_int_image
  */
@@ -93,6 +93,15 @@
 #endif
 
 #include <VX/vx_lib_extras.h>
+#include <VX/vx_ext_graph_arena.h>
+#include <VX/vx_ext_image_handle.h>
+#include <VX/vx_ext_image_pool.h>
+#include <VX/vx_ext_keypoint_f32.h>
+#include <VX/vx_ext_matrix_map.h>
+#include <VX/vx_ext_node_perf.h>
+#include <VX/vx_ext_node_threads.h>
+#include <VX/vx_ext_threadpool.h>
+#include <VX/vx_ext_tiled_graph.h>
 
 /*! \def VX_INT_API Used to deliniate APIs which are not intended to be exported.
  * \ingroup group_int_defines
@@ -134,6 +143,26 @@
  */
 #define VX_INT_MAX_REF      (1024)
 
+/*! \brief Alignment of the planes the framework places in shared memory, a cache line.
+ * \ingroup group_int_defines
+ */
+#define VX_MEMORY_ALIGNMENT (64)
+
+/*! \brief Maximum number of released image planes a context keeps for reuse.
+ * \ingroup group_int_defines
+ */
+#define VX_INT_MAX_POOL_BLOCKS (64)
+
+/*! \brief The default most bytes of released image planes a context keeps for reuse.
+ * \ingroup group_int_defines
+ */
+#define VX_INT_IMAGE_POOL_SIZE (256*1024*1024)
+
+/*! \brief The size of a huge page, image planes from this size on are mapped from the system.
+ * \ingroup group_int_defines
+ */
+#define VX_INT_HUGEPAGE_SIZE (2*1024*1024)
+
 /*! \brief Maximum number of user defined structs/
  * \ingroup group_int_defines
  */
@@ -169,15 +198,32 @@
  */
 #define VX_INT_MAX_QUEUE_DEPTH (32)
 
+/*! \brief The number of times a queue is tried again, yielding in between,
+ * before a thread sleeps on it.
+ * \ingroup group_int_defines
+ */
+#define VX_INT_QUEUE_SPINS     (16)
+
 /*! \brief The value to use in event waiting which never returns.
  * \ingroup group_int_defines
  */
 #define VX_INT_FOREVER          (0xFFFFFFFF)
 
-/*! \brief The minimum khronos number of targets.
+/*! \brief The default number of threadpool workers. Zero means the number
+ * of online cores is detected at runtime. Can be overridden by the
+ * VX_NUM_WORKERS environment variable.
  * \ingroup group_int_defines
  */
+#if defined(TARGET_NUM_CORES)
 #define VX_INT_HOST_CORES (TARGET_NUM_CORES)
+#else
+#define VX_INT_HOST_CORES (0)
+#endif
+
+/*! \brief The maximum number of threadpool workers.
+ * \ingroup group_int_defines
+ */
+#define VX_INT_MAX_WORKERS (64)
 
 /*! \brief The largest optical flow pyr LK window.
  * \ingroup group_int_defines
@@ -355,18 +401,44 @@ typedef struct _vx_value_set_t {
     vx_value_t v3;
 } vx_value_set_t;
 
-/*! \brief The queue object.
+/*! \brief The queue object. A bounded lock-free ring where every slot carries
+ * a sequence number telling whether it is free or filled for the current lap.
+ * Threads only block on the semaphores when the ring is full or empty.
  * \ingroup group_int_osal
  */
 typedef struct _vx_queue_t {
+    vx_value_set_t * volatile data[VX_INT_MAX_QUEUE_DEPTH];
+    /*! \brief The per slot sequence numbers */
+    volatile vx_int32 seq[VX_INT_MAX_QUEUE_DEPTH];
+    /*! \brief The next position to read, free running */
+    volatile vx_int32 start_index;
+    /*! \brief The next position to write, free running */
+    volatile vx_int32 end_index;
+    /*! \brief The number of readers sleeping on an empty queue */
+    volatile vx_int32 readers;
+    /*! \brief The number of writers sleeping on a full queue */
+    volatile vx_int32 writers;
+    /*! \brief Wakes readers up */
+    vx_sem_t readable;
+    /*! \brief Wakes writers up */
+    vx_sem_t writable;
+    /*! \brief Set once by \ref vxPopQueue, read and written atomically */
+    volatile vx_int32 popped;
+} vx_queue_t;
+
+/*! \brief The work-stealing deque of one worker. The issuer pushes and the owner
+ * pops at the bottom, other workers steal from the top. Each deque has its own lock,
+ * so only the threads touching the same deque contend.
+ * \ingroup group_int_osal
+ */
+typedef struct _vx_deque_t {
     vx_value_set_t *data[VX_INT_MAX_QUEUE_DEPTH];
-    vx_int32 start_index;
-    vx_int32 end_index;
+    /*! \brief The next position to steal, free running */
+    vx_uint32 top;
+    /*! \brief The next position to push, free running */
+    vx_uint32 bottom;
     vx_sem_t lock;
-    vx_event_t readEvent;
-    vx_event_t writeEvent;
-    vx_bool popped;
-} vx_queue_t;
+} vx_deque_t;
 
 /*! \brief The processor structure which contains the graph queue.
  * \ingroup group_int_context
@@ -399,6 +471,8 @@ typedef vx_bool (*vx_threadpool_f)(struct _vx_threadpool_worker_t *worker);
 typedef struct _vx_threadpool_worker_t {
     /*! \brief The work queue */
     vx_queue_t *queue;
+    /*! \brief The work deque (VX_THREADPOOL_WORK_STEALING only) */
+    vx_deque_t *deque;
     /*! \brief The handle to the worker thread */
     vx_thread_t handle;
     /*! \brief The index of this worker in the pool */
@@ -421,6 +495,8 @@ typedef struct _vx_threadpool_worker_t {
  * \ingroup group_int_osal
  */
 typedef struct _vx_threadpool_t {
+    /*! \brief The scheduling policy \see vx_threadpool_e */
+    vx_enum type;
     /*! \brief The number of threads in the pool */
     uint32_t numWorkers;
     /*! \brief The maximum number of threads in the queue */
@@ -428,7 +504,7 @@ typedef struct _vx_threadpool_t {
     /*! \brief Unit size of a work item */
     uint32_t sizeWorkItem;
     /*! \brief The number of corrent items in the queue */
-     int32_t numCurrentItems;
+    volatile int32_t numCurrentItems;
     /*! \brief The array of workers */
     vx_threadpool_worker_t *workers;
     /*! \brief The next index to submit work to */
@@ -437,6 +513,10 @@ typedef struct _vx_threadpool_t {
     vx_sem_t sem;
     /*! \brief The event which indicates that all work is completed */
     vx_event_t completed;
+    /*! \brief Counts the items waiting in the deques (VX_THREADPOOL_WORK_STEALING only) */
+    vx_sem_t work;
+    /*! \brief Cleared when the pool is destroyed (VX_THREADPOOL_WORK_STEALING only) */
+    volatile vx_bool running;
 } vx_threadpool_t;
 
 /*! \brief The work item to distribute across the threadpools
@@ -618,6 +698,10 @@ typedef struct _vx_kernel_attr_t {
     vx_ptr_t      globalDataPtr;
     /*! \brief The border mode of this node */
     vx_border_mode_t borders;
+    /*! \brief The number of threads the node may use, zero for one per core */
+    vx_uint32     numThreads;
+    /*! \brief The input rows of a band of the output, NULL if the kernel can not run in bands */
+    vx_kernel_input_rows_f inputRows;
 #ifdef OPENVX_KHR_TILING
     /*! \brief The block size information */
     vx_tile_block_size_t blockinfo;
@@ -859,6 +943,38 @@ typedef struct _vx_external_t {
 /*! \brief The top level context data for the entire OpenVX instance
  * \ingroup group_int_context
  */
+/*! \brief A released image plane kept for reuse.
+ * \ingroup group_int_memory
+ */
+typedef struct _vx_pool_block_t {
+    /*! \brief The start of the plane */
+    vx_uint8           *ptr;
+    /*! \brief The size in bytes, blocks are only given to planes of the same size */
+    vx_size             size;
+} vx_pool_block_t;
+
+/*! \brief The allocator of the image planes of a context.
+ * \ingroup group_int_memory
+ */
+typedef struct _vx_image_pool_t {
+    /*! \brief Guards the free blocks, images are released from any thread */
+    vx_sem_t            lock;
+    /*! \brief The alignment of the planes */
+    vx_size             alignment;
+    /*! \brief Pads the rows to the alignment */
+    vx_bool             row_padding;
+    /*! \brief The huge page backing, from \ref vx_hugepages_e */
+    vx_enum             hugepages;
+    /*! \brief The most bytes of free blocks kept */
+    vx_size             capacity;
+    /*! \brief The free blocks, the most recently released last */
+    vx_pool_block_t     blocks[VX_INT_MAX_POOL_BLOCKS];
+    /*! \brief The number of free blocks */
+    vx_uint32           num_blocks;
+    /*! \brief The bytes of the free blocks */
+    vx_size             cached;
+} vx_image_pool_t;
+
 typedef struct _vx_context {
     /*! \brief The base reference object */
     vx_reference_t      base;
@@ -903,6 +1019,9 @@ typedef struct _vx_context {
     } user_structs[VX_INT_MAX_USER_STRUCTS];
     /*! \brief The worker pool used to parallelize the graph*/
     vx_threadpool_t    *workers;
+    /*! \brief The number of graphs being processed, nested ones included. The pool is
+     * only replaced while it is 0. Guarded by the global lock. */
+    vx_uint32           num_processing;
 #if defined(EXPERIMENTAL_USE_OPENCL)
 #define CL_MAX_PLATFORMS (1)
 #define CL_MAX_DEVICES   (2)
@@ -918,6 +1037,8 @@ typedef struct _vx_context {
 #endif
     /*! \brief The immediate mode border */
     vx_border_mode_t    imm_border;
+    /*! \brief The allocator of the image planes */
+    vx_image_pool_t     image_pool;
 } vx_context_t;
 
 /*! \brief A data structure used to track the various costs which could being optimized.
@@ -964,6 +1085,14 @@ typedef struct _vx_node {
     vx_graph            child;
     /*! \brief The node cost factors */
     vx_cost_factors_t   costs;
+    /*! \brief The rows the kernel computes in this call, empty for the whole output. */
+    vx_rectangle_t      band;
+    /*! \brief The node which reads the output of this one band by band, see vxPlanChains. */
+    vx_node             chain_next;
+    /*! \brief The node whose output this one reads band by band. */
+    vx_node             chain_prev;
+    /*! \brief The index of the parameter which reads the output of chain_prev. */
+    vx_uint32           chain_input;
 } vx_node_t;
 
 /*! \brief The internal representation of a graph.
@@ -999,6 +1128,27 @@ typedef struct _vx_graph {
     vx_uint32      numParams;
     /*! \brief A switch to turn off SMP mode */
     vx_bool        should_serialize;
+    /*! \brief The memory of the virtual images of the graph, images which are never
+     * alive at the same level of the execution share it. Its start is aligned on use. */
+    vx_uint8      *arena;
+    /*! \brief The virtual images placed in the arena, internally referenced. */
+    vx_image       arena_images[VX_INT_MAX_NODES];
+    /*! \brief The number of images in the arena. */
+    vx_uint32      numArenaImages;
+    /*! \brief The size of the arena in bytes. */
+    vx_size        arena_size;
+    /*! \brief The most bytes of the arena alive at one level of the execution. */
+    vx_size        peak_memory;
+    /*! \brief The rows of the bands of the chains of nodes, 0 if the graph is not tiled. */
+    vx_uint32      tile_height;
+    /*! \brief The indexes of the nodes in the order of the execution, wave after wave. The
+     * nodes which run in the chain of another node are left out. Planned by the verification. */
+    vx_uint32      schedule[VX_INT_MAX_REF];
+    /*! \brief The start of each wave in the schedule, waves[numWaves] is its end. The nodes
+     * of one wave may run at the same time. */
+    vx_uint32      waves[VX_INT_MAX_REF + 1];
+    /*! \brief The number of waves in the schedule. */
+    vx_uint32      numWaves;
 } vx_graph_t;
 
 /*! \brief The dimensions enumeration, also stride enumerations.
@@ -1052,6 +1202,10 @@ typedef struct _vx_memory_t {
      * VX_WRITE_ONLY or VX_READ_AND_WRITE flag parts. Only single writers are permitted.
      */
     vx_sem_t locks[VX_PLANE_MAX];
+    /*! \brief The size of the blocks the planes got from the image pool, 0 for the
+     * planes which were not.
+     */
+    vx_size        pooled[VX_PLANE_MAX];
 #if defined(EXPERIMENTAL_USE_OPENCL)
     /*! \brief This contains the OpenCL memory references */
     cl_mem hdls[VX_PLANE_MAX];
@@ -1220,6 +1374,8 @@ typedef struct _vx_matrix {
     vx_size columns;
     /*! \brief Number of rows */
     vx_size rows;
+    /*! \brief The usage of the host map, from \ref vx_accessor_e, 0 while the matrix is not mapped */
+    vx_enum map_usage;
 } vx_matrix_t;
 
 /*! \brief A convolution is a special type of matrix (MxM)
@@ -44,6 +44,23 @@
  */
 void vxDestructMatrix(vx_reference ref);
 
+/*! \brief Gives a kernel the memory of a matrix parameter of its node, with no copy and no lock.
+ * \details The graph runs the writer of a matrix before its readers, so the node has the
+ * matrix to itself while it executes. Host code uses \ref vxMapMatrix instead.
+ * \param [in] matrix The matrix parameter.
+ * \param [out] ptr The location at which to store the pointer to the elements.
+ * \param [in] usage The \ref vx_accessor_e usage of the elements.
+ * \ingroup group_int_matrix
+ */
+vx_status vxMapMatrixInt(vx_matrix matrix, void **ptr, vx_enum usage);
+
+/*! \brief Ends a \ref vxMapMatrixInt, a usage which writes counts as a write to the matrix.
+ * \param [in] matrix The matrix parameter.
+ * \param [in] usage The usage given to \ref vxMapMatrixInt.
+ * \ingroup group_int_matrix
+ */
+void vxUnmapMatrixInt(vx_matrix matrix, vx_enum usage);
+
 #ifdef __cplusplus
 }
 #endif
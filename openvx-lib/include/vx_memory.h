@@ -46,6 +46,55 @@ vx_bool vxFreeMemory(vx_context_t *context, vx_memory_t *memory);
  */
 vx_bool vxAllocateMemory(vx_context_t *context, vx_memory_t *memory);
 
+/*! \brief Lays out the strides of a plane of a memory block.
+ * \return The size of the plane in bytes.
+ * \ingroup group_int_memory
+ */
+vx_size vxComputeMemoryLayout(vx_memory_t *memory, vx_uint32 p);
+
+/*! \brief Points the planes of a memory block at memory it does not own, one after
+ * another from \a base, each one aligned to \ref VX_MEMORY_ALIGNMENT.
+ * \details The block counts as allocated but \ref vxFreeMemory must not be called on it,
+ * \ref vxUnplaceMemory gives it back. A NULL \a base only lays out the planes.
+ * \return The bytes the planes take from \a base.
+ * \ingroup group_int_memory
+ */
+vx_size vxPlaceMemory(vx_memory_t *memory, vx_uint8 *base);
+
+/*! \brief Detaches a memory block from the memory given to \ref vxPlaceMemory.
+ * \ingroup group_int_memory
+ */
+void vxUnplaceMemory(vx_memory_t *memory);
+
+/*! \brief Sets up the image pool of a context with the default settings.
+ * \ingroup group_int_memory
+ */
+void vxInitImagePool(vx_image_pool_t *pool);
+
+/*! \brief Frees the blocks kept by an image pool.
+ * \ingroup group_int_memory
+ */
+void vxDeinitImagePool(vx_image_pool_t *pool);
+
+/*! \brief Frees the oldest blocks kept by an image pool until they take at most \a bytes.
+ * \ingroup group_int_memory
+ */
+void vxTrimImagePool(vx_image_pool_t *pool, vx_size bytes);
+
+/*! \brief Gives a plane back to the image pool, which keeps it for a plane of the same
+ * size as long as it is within its capacity.
+ * \ingroup group_int_memory
+ */
+void vxReleasePoolBlock(vx_image_pool_t *pool, vx_uint8 *ptr, vx_size size);
+
+/*! \brief Allocates the planes of an image from the image pool of the context.
+ * \details The planes and, when the pool pads them, their rows are aligned to the pool
+ * alignment. A released plane of the same size is reused before new memory is taken.
+ * \ref vxFreeMemory gives the planes back.
+ * \ingroup group_int_memory
+ */
+vx_bool vxAllocateImageMemory(vx_context_t *context, vx_memory_t *memory);
+
 void vxPrintMemory(vx_memory_t *mem);
 
 vx_size vxComputeMemorySize(vx_memory_t *memory, vx_uint32 p);
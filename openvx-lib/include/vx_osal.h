@@ -78,6 +78,16 @@ vx_thread_t vxCreateThread(vx_thread_f func, void *arg);
  */
 void vxSleepThread(vx_uint32 milliseconds);
 
+/*! \brief Gives the rest of the time slice of the calling thread to other threads.
+ * \ingroup group_int_osal
+ */
+void vxYieldThread(void);
+
+/*! \brief Returns the number of online processors, at least 1.
+ * \ingroup group_int_osal
+ */
+vx_uint32 vxGetNumCores(void);
+
 /*! \brief
  * \ingroup group_int_osal
  */
@@ -188,9 +198,35 @@ vx_symbol_t vxGetSymbol(vx_module_handle_t mod, vx_char * name);
  */
 vx_float32 vxTimeToMS(vx_uint64 c);
 
+/*! \brief Atomically loads a 32 bit value.
+ * \ingroup group_int_osal
+ */
+vx_int32 vxAtomicLoad(volatile vx_int32 *ptr);
+
+/*! \brief Atomically stores a 32 bit value.
+ * \ingroup group_int_osal
+ */
+void vxAtomicStore(volatile vx_int32 *ptr, vx_int32 value);
+
+/*! \brief Atomically adds to a 32 bit value and returns the new value.
+ * \ingroup group_int_osal
+ */
+vx_int32 vxAtomicAdd(volatile vx_int32 *ptr, vx_int32 value);
+
+/*! \brief Atomically replaces \a expected with \a desired.
+ * \return vx_true_e if the value was replaced.
+ * \ingroup group_int_osal
+ */
+vx_bool vxAtomicCompareExchange(volatile vx_int32 *ptr, vx_int32 expected, vx_int32 desired);
+
 void vxDestroyThreadpool(vx_threadpool_t **ppool);
 
-vx_threadpool_t *vxCreateThreadpool(vx_uint32 numThreads,
+/*! \brief Creates a pool of worker threads.
+ * \param [in] type The scheduling policy \see vx_threadpool_e.
+ * \ingroup group_int_osal
+ */
+vx_threadpool_t *vxCreateThreadpool(vx_enum type,
+                                    vx_uint32 numThreads,
                                     vx_uint32 numWorkItems,
                                     vx_size sizeWorkItem,
                                     vx_threadpool_f worker,
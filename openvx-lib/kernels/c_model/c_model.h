@@ -82,10 +82,53 @@ vx_status vxMagnitude(vx_image grad_x, vx_image grad_y, vx_image output);
 
 vx_status vxMultiply(vx_image in0, vx_image in1, vx_scalar scale_param, vx_scalar opolicy_param, vx_scalar rpolicy_param, vx_image output);
 
-vx_status vxOpticalFlowPyrLK(/*p1, p2, p3...*/);
+/*! \brief One pyramid level as seen by the Lucas-Kanade tracker. The strides are in bytes.
+ */
+typedef struct _vx_lk_level_t {
+    const vx_uint8 *prev;       /*!< \brief The old image. */
+    const vx_int16 *prev_dx;    /*!< \brief The x gradient of the old image. */
+    const vx_int16 *prev_dy;    /*!< \brief The y gradient of the old image. */
+    const vx_uint8 *next;       /*!< \brief The new image. */
+    vx_int32 prev_stride;
+    vx_int32 dx_stride;
+    vx_int32 dy_stride;
+    vx_int32 next_stride;
+    vx_uint32 width;            /*!< \brief The width of all images of the level. */
+    vx_uint32 height;           /*!< \brief The height of all images of the level. */
+} vx_lk_level_t;
+
+/*! \brief The sub-pixel state of a tracked point, kept in the coordinates of
+ * the current pyramid level.
+ */
+typedef struct _vx_lk_point_t {
+    vx_float32 prev_x;
+    vx_float32 prev_y;
+    vx_float32 next_x;
+    vx_float32 next_y;
+    vx_int32 status;            /*!< \brief A zero indicates a lost point. */
+    vx_float32 error;
+} vx_lk_point_t;
+
+/*! \brief Tracks the points over one pyramid level.
+ * \param [in] scratch Room for 3 x winSize x winSize S16 values.
+ */
+vx_status vxLKTrackLevel(const vx_lk_level_t *level, vx_lk_point_t *points, vx_size count,
+                         vx_size winSize, vx_enum criteria, vx_float32 epsilon, vx_uint32 num_iterations,
+                         vx_bool final_level, vx_int16 *scratch);
 
 vx_status vxPhase(vx_image grad_x, vx_image grad_y, vx_image output);
 
+/*! \brief The bytes of scratch memory \ref vxHalfScaleGaussian needs for a source \a width. */
+#define C_HALF_SCALE_GAUSSIAN_SCRATCH(width) (((width) + 4) * sizeof(vx_uint16) + (width))
+
+/*! \brief Blurs \a src with the separable 1-4-6-4-1 Gaussian and decimates it into \a dst
+ * in one pass, sampling the same pixels as a nearest neighbor \ref vxScaleImage.
+ * If \a copy is not NULL the rows of \a src are also copied to it as they are read,
+ * \a dst may then be NULL to only copy.
+ * An undefined border is replicated.
+ */
+vx_status vxHalfScaleGaussian(vx_image src, vx_image dst, vx_image copy, const vx_border_mode_t *borders, void *scratch);
+
 vx_status vxScaleImage(vx_image src_image, vx_image dst_image, vx_scalar stype, vx_border_mode_t *bordermode, vx_float64 *interm, vx_size size);
 
 vx_status vxSobel3x3(vx_image input, vx_image grad_x, vx_image grad_y, vx_border_mode_t *bordermode);
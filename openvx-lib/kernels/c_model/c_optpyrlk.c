@@ -23,11 +23,528 @@
 
 #include <c_model.h>
 
-// nodeless version of the OpticalFlowPyrLK kernel
-vx_status vxOpticalFlowPyrLK(/*p1, p2, p3...*/)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LK_USE_SSE2
+#endif
+
+/* GCC and clang build the AVX2 steps without -mavx2, they only run where the CPU has it */
+#if defined(LK_USE_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define LK_USE_AVX2
+#define LK_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/* The bilinear weights are fixed point with W_BITS fractional bits. The old
+ * image window keeps 5 fractional bits, the gradient windows none. */
+#define LK_W_BITS        (14)
+#define LK_FLT_SCALE     (1.f/(1 << 20))
+#define LK_DESCALE(x,n)  (((x) + (1 << ((n)-1))) >> (n))
+
+#define LK_ROW(type, base, stride, y) ((const type *)((const vx_uint8 *)(base) + (vx_int32)(y) * (stride)))
+
+/* The tracker and its SIMD steps are inlined into a plain and an AVX2 function, see
+ * vxLKTrackLevel, so the AVX2 build does not call into SSE encoded code */
+#if defined(__GNUC__)
+#define LK_INLINE inline __attribute__((always_inline))
+#else
+#define LK_INLINE
+#endif
+
+static LK_INLINE void lk_weights(vx_float32 a, vx_float32 b, vx_int32 iw[4])
+{
+    iw[0] = (vx_int32)(((1.f - a)*(1.f - b)*(1 << LK_W_BITS)) + 0.5f);
+    iw[1] = (vx_int32)((a*(1.f - b)*(1 << LK_W_BITS)) + 0.5f);
+    iw[2] = (vx_int32)(((1.f - a)*b*(1 << LK_W_BITS)) + 0.5f);
+    iw[3] = (1 << LK_W_BITS) - iw[0] - iw[1] - iw[2];
+}
+
+#ifdef LK_USE_SSE2
+/* packs a pair of 16 bit weights for _mm_madd_epi16 */
+static LK_INLINE __m128i lk_weight_pair(vx_int32 lo, vx_int32 hi)
+{
+    return _mm_set1_epi32((vx_int32)(((vx_uint32)lo & 0xFFFFu) | ((vx_uint32)hi << 16)));
+}
+
+/* bilinear interpolation of 8 consecutive U8 pixels */
+static LK_INLINE __m128i lk_sample_u8(const vx_uint8 *src, vx_int32 step, __m128i qw0, __m128i qw1)
+{
+    const __m128i z = _mm_setzero_si128();
+    const __m128i qdelta = _mm_set1_epi32(1 << (LK_W_BITS - 5 - 1));
+    __m128i v00 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src)), z);
+    __m128i v01 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + 1)), z);
+    __m128i v10 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + step)), z);
+    __m128i v11 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(src + step + 1)), z);
+    __m128i t0 = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(v00, v01), qw0),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(v10, v11), qw1));
+    __m128i t1 = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(v00, v01), qw0),
+                               _mm_madd_epi16(_mm_unpackhi_epi16(v10, v11), qw1));
+    t0 = _mm_srai_epi32(_mm_add_epi32(t0, qdelta), LK_W_BITS - 5);
+    t1 = _mm_srai_epi32(_mm_add_epi32(t1, qdelta), LK_W_BITS - 5);
+    return _mm_packs_epi32(t0, t1);
+}
+
+/* bilinear interpolation of 8 consecutive S16 pixels, step is in elements */
+static LK_INLINE __m128i lk_sample_s16(const vx_int16 *src, vx_int32 step, __m128i qw0, __m128i qw1)
+{
+    const __m128i qdelta = _mm_set1_epi32(1 << (LK_W_BITS - 1));
+    __m128i v00 = _mm_loadu_si128((const __m128i *)(src));
+    __m128i v01 = _mm_loadu_si128((const __m128i *)(src + 1));
+    __m128i v10 = _mm_loadu_si128((const __m128i *)(src + step));
+    __m128i v11 = _mm_loadu_si128((const __m128i *)(src + step + 1));
+    __m128i t0 = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(v00, v01), qw0),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(v10, v11), qw1));
+    __m128i t1 = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(v00, v01), qw0),
+                               _mm_madd_epi16(_mm_unpackhi_epi16(v10, v11), qw1));
+    t0 = _mm_srai_epi32(_mm_add_epi32(t0, qdelta), LK_W_BITS);
+    t1 = _mm_srai_epi32(_mm_add_epi32(t1, qdelta), LK_W_BITS);
+    return _mm_packs_epi32(t0, t1);
+}
+
+/* bilinear interpolation of 4 consecutive U8 pixels, the upper half is zero */
+static LK_INLINE __m128i lk_sample_u8_4(const vx_uint8 *src, vx_int32 step, __m128i qw0, __m128i qw1)
+{
+    const __m128i z = _mm_setzero_si128();
+    const __m128i qdelta = _mm_set1_epi32(1 << (LK_W_BITS - 5 - 1));
+    __m128i v00 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const vx_int32 *)(src)), z);
+    __m128i v01 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const vx_int32 *)(src + 1)), z);
+    __m128i v10 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const vx_int32 *)(src + step)), z);
+    __m128i v11 = _mm_unpacklo_epi8(_mm_cvtsi32_si128(*(const vx_int32 *)(src + step + 1)), z);
+    __m128i t0 = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(v00, v01), qw0),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(v10, v11), qw1));
+    t0 = _mm_srai_epi32(_mm_add_epi32(t0, qdelta), LK_W_BITS - 5);
+    return _mm_packs_epi32(t0, z);
+}
+
+/* bilinear interpolation of 4 consecutive S16 pixels, the upper half is zero */
+static LK_INLINE __m128i lk_sample_s16_4(const vx_int16 *src, vx_int32 step, __m128i qw0, __m128i qw1)
+{
+    const __m128i qdelta = _mm_set1_epi32(1 << (LK_W_BITS - 1));
+    __m128i v00 = _mm_loadl_epi64((const __m128i *)(src));
+    __m128i v01 = _mm_loadl_epi64((const __m128i *)(src + 1));
+    __m128i v10 = _mm_loadl_epi64((const __m128i *)(src + step));
+    __m128i v11 = _mm_loadl_epi64((const __m128i *)(src + step + 1));
+    __m128i t0 = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(v00, v01), qw0),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(v10, v11), qw1));
+    t0 = _mm_srai_epi32(_mm_add_epi32(t0, qdelta), LK_W_BITS);
+    return _mm_packs_epi32(t0, _mm_setzero_si128());
+}
+
+/* selects the lanes 0..3 of a 4 pixel step at or above the given lane */
+static LK_INLINE __m128i lk_tail_mask(vx_int32 first)
+{
+    return _mm_cmpgt_epi16(_mm_setr_epi16(0, 1, 2, 3, -1, -1, -1, -1), _mm_set1_epi16((vx_int16)(first - 1)));
+}
+
+static LK_INLINE vx_float64 lk_sum_ps(__m128 v)
+{
+    vx_float32 f[4];
+    _mm_storeu_ps(f, v);
+    return (vx_float64)f[0] + f[1] + f[2] + f[3];
+}
+#endif
+
+#ifdef LK_USE_AVX2
+static vx_bool lk_has_avx2(void)
+{
+    return (__builtin_cpu_supports("avx2") ? vx_true_e : vx_false_e);
+}
+
+/* bilinear interpolation of 16 consecutive U8 pixels, the lanes work as two 8 pixel steps */
+static LK_INLINE LK_TARGET_AVX2 __m256i lk_sample_u8_16(const vx_uint8 *src, vx_int32 step, __m256i qw0, __m256i qw1)
+{
+    const __m256i qdelta = _mm256_set1_epi32(1 << (LK_W_BITS - 5 - 1));
+    __m256i v00 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src)));
+    __m256i v01 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + 1)));
+    __m256i v10 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + step)));
+    __m256i v11 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + step + 1)));
+    __m256i t0 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(v00, v01), qw0),
+                                  _mm256_madd_epi16(_mm256_unpacklo_epi16(v10, v11), qw1));
+    __m256i t1 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(v00, v01), qw0),
+                                  _mm256_madd_epi16(_mm256_unpackhi_epi16(v10, v11), qw1));
+    t0 = _mm256_srai_epi32(_mm256_add_epi32(t0, qdelta), LK_W_BITS - 5);
+    t1 = _mm256_srai_epi32(_mm256_add_epi32(t1, qdelta), LK_W_BITS - 5);
+    return _mm256_packs_epi32(t0, t1);
+}
+
+/* bilinear interpolation of 16 consecutive S16 pixels, step is in elements */
+static LK_INLINE LK_TARGET_AVX2 __m256i lk_sample_s16_16(const vx_int16 *src, vx_int32 step, __m256i qw0, __m256i qw1)
 {
-    // <code>
+    const __m256i qdelta = _mm256_set1_epi32(1 << (LK_W_BITS - 1));
+    __m256i v00 = _mm256_loadu_si256((const __m256i *)(src));
+    __m256i v01 = _mm256_loadu_si256((const __m256i *)(src + 1));
+    __m256i v10 = _mm256_loadu_si256((const __m256i *)(src + step));
+    __m256i v11 = _mm256_loadu_si256((const __m256i *)(src + step + 1));
+    __m256i t0 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(v00, v01), qw0),
+                                  _mm256_madd_epi16(_mm256_unpacklo_epi16(v10, v11), qw1));
+    __m256i t1 = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(v00, v01), qw0),
+                                  _mm256_madd_epi16(_mm256_unpackhi_epi16(v10, v11), qw1));
+    t0 = _mm256_srai_epi32(_mm256_add_epi32(t0, qdelta), LK_W_BITS);
+    t1 = _mm256_srai_epi32(_mm256_add_epi32(t1, qdelta), LK_W_BITS);
+    return _mm256_packs_epi32(t0, t1);
+}
 
-    return VX_ERROR_NOT_IMPLEMENTED;
+/* adds the pair products of 16 pixels to a sum of the 8 pixel steps, the low pixels first
+ * so the float sum is the same as two SSE2 steps */
+static LK_INLINE LK_TARGET_AVX2 __m128 lk_add_madd_16(__m128 sum, __m256i a, __m256i b)
+{
+    __m256 p = _mm256_cvtepi32_ps(_mm256_madd_epi16(a, b));
+    sum = _mm_add_ps(sum, _mm256_castps256_ps128(p));
+    return _mm_add_ps(sum, _mm256_extractf128_ps(p, 1));
 }
 
+/* The 16 pixel steps of a row of lk_sample_window, returns the first pixel not done */
+static LK_TARGET_AVX2 vx_int32 lk_sample_row_avx2(const vx_uint8 *src, vx_int32 stepI,
+                                                  const vx_int16 *dsrc_x, vx_int32 dstep_x,
+                                                  const vx_int16 *dsrc_y, vx_int32 dstep_y,
+                                                  const vx_int32 iw[4], vx_int32 winSize,
+                                                  vx_int16 *Iptr, vx_int16 *dIptr_x, vx_int16 *dIptr_y,
+                                                  __m128 *qA11, __m128 *qA12, __m128 *qA22)
+{
+    __m256i qw0 = _mm256_broadcastsi128_si256(lk_weight_pair(iw[0], iw[1]));
+    __m256i qw1 = _mm256_broadcastsi128_si256(lk_weight_pair(iw[2], iw[3]));
+    vx_int32 x;
+    for (x = 0; x <= winSize - 16; x += 16)
+    {
+        __m256i ival = lk_sample_u8_16(src + x, stepI, qw0, qw1);
+        __m256i ixval = lk_sample_s16_16(dsrc_x + x, dstep_x, qw0, qw1);
+        __m256i iyval = lk_sample_s16_16(dsrc_y + x, dstep_y, qw0, qw1);
+
+        _mm256_storeu_si256((__m256i *)(Iptr + x), ival);
+        _mm256_storeu_si256((__m256i *)(dIptr_x + x), ixval);
+        _mm256_storeu_si256((__m256i *)(dIptr_y + x), iyval);
+
+        *qA11 = lk_add_madd_16(*qA11, ixval, ixval);
+        *qA12 = lk_add_madd_16(*qA12, ixval, iyval);
+        *qA22 = lk_add_madd_16(*qA22, iyval, iyval);
+    }
+    return x;
+}
+
+/* The 16 pixel steps of a row of lk_mismatch, returns the first pixel not done */
+static LK_TARGET_AVX2 vx_int32 lk_mismatch_row_avx2(const vx_uint8 *Jptr, vx_int32 stepJ, const vx_int32 iw[4],
+                                                    vx_int32 winSize, const vx_int16 *Iptr,
+                                                    const vx_int16 *dIptr_x, const vx_int16 *dIptr_y,
+                                                    __m128 *qb1, __m128 *qb2)
+{
+    __m256i qw0 = _mm256_broadcastsi128_si256(lk_weight_pair(iw[0], iw[1]));
+    __m256i qw1 = _mm256_broadcastsi128_si256(lk_weight_pair(iw[2], iw[3]));
+    vx_int32 x;
+    for (x = 0; x <= winSize - 16; x += 16)
+    {
+        __m256i diff = _mm256_sub_epi16(lk_sample_u8_16(Jptr + x, stepJ, qw0, qw1),
+                                        _mm256_loadu_si256((const __m256i *)(Iptr + x)));
+        *qb1 = lk_add_madd_16(*qb1, diff, _mm256_loadu_si256((const __m256i *)(dIptr_x + x)));
+        *qb2 = lk_add_madd_16(*qb2, diff, _mm256_loadu_si256((const __m256i *)(dIptr_y + x)));
+    }
+    return x;
+}
+#endif
+
+/*! \brief Samples the windows of the old image and its gradients around the
+ * top-left corner (ix + a, iy + b) and returns the spatial gradient matrix.
+ */
+static LK_INLINE void lk_sample_window(const vx_lk_level_t *level, vx_int32 ix, vx_int32 iy, const vx_int32 iw[4],
+                                       vx_int32 winSize, vx_int16 *Iwin, vx_int16 *dxwin, vx_int16 *dywin,
+                                       vx_bool avx2, vx_float64 *A11, vx_float64 *A12, vx_float64 *A22)
+{
+    vx_int32 x, y;
+    vx_int32 stepI = level->prev_stride;
+    vx_int32 dstep_x = level->dx_stride / (vx_int32)sizeof(vx_int16);
+    vx_int32 dstep_y = level->dy_stride / (vx_int32)sizeof(vx_int16);
+    vx_float64 a11 = 0, a12 = 0, a22 = 0;
+#ifdef LK_USE_SSE2
+    __m128i qw0 = lk_weight_pair(iw[0], iw[1]);
+    __m128i qw1 = lk_weight_pair(iw[2], iw[3]);
+    __m128 qA11 = _mm_setzero_ps(), qA12 = _mm_setzero_ps(), qA22 = _mm_setzero_ps();
+#endif
+
+    for (y = 0; y < winSize; y++)
+    {
+        const vx_uint8 *src = LK_ROW(vx_uint8, level->prev, stepI, iy + y) + ix;
+        const vx_int16 *dsrc_x = LK_ROW(vx_int16, level->prev_dx, level->dx_stride, iy + y) + ix;
+        const vx_int16 *dsrc_y = LK_ROW(vx_int16, level->prev_dy, level->dy_stride, iy + y) + ix;
+        vx_int16 *Iptr = Iwin + y * winSize;
+        vx_int16 *dIptr_x = dxwin + y * winSize;
+        vx_int16 *dIptr_y = dywin + y * winSize;
+
+        x = 0;
+#ifdef LK_USE_AVX2
+        if (avx2 == vx_true_e)
+            x = lk_sample_row_avx2(src, stepI, dsrc_x, dstep_x, dsrc_y, dstep_y, iw, winSize,
+                                   Iptr, dIptr_x, dIptr_y, &qA11, &qA12, &qA22);
+#endif
+#ifdef LK_USE_SSE2
+        for (; x <= winSize - 8; x += 8)
+        {
+            __m128i ival = lk_sample_u8(src + x, stepI, qw0, qw1);
+            __m128i ixval = lk_sample_s16(dsrc_x + x, dstep_x, qw0, qw1);
+            __m128i iyval = lk_sample_s16(dsrc_y + x, dstep_y, qw0, qw1);
+
+            _mm_storeu_si128((__m128i *)(Iptr + x), ival);
+            _mm_storeu_si128((__m128i *)(dIptr_x + x), ixval);
+            _mm_storeu_si128((__m128i *)(dIptr_y + x), iyval);
+
+            qA11 = _mm_add_ps(qA11, _mm_cvtepi32_ps(_mm_madd_epi16(ixval, ixval)));
+            qA12 = _mm_add_ps(qA12, _mm_cvtepi32_ps(_mm_madd_epi16(ixval, iyval)));
+            qA22 = _mm_add_ps(qA22, _mm_cvtepi32_ps(_mm_madd_epi16(iyval, iyval)));
+        }
+        for (; x <= winSize - 4; x += 4)
+        {
+            __m128i ival = lk_sample_u8_4(src + x, stepI, qw0, qw1);
+            __m128i ixval = lk_sample_s16_4(dsrc_x + x, dstep_x, qw0, qw1);
+            __m128i iyval = lk_sample_s16_4(dsrc_y + x, dstep_y, qw0, qw1);
+
+            _mm_storel_epi64((__m128i *)(Iptr + x), ival);
+            _mm_storel_epi64((__m128i *)(dIptr_x + x), ixval);
+            _mm_storel_epi64((__m128i *)(dIptr_y + x), iyval);
+
+            qA11 = _mm_add_ps(qA11, _mm_cvtepi32_ps(_mm_madd_epi16(ixval, ixval)));
+            qA12 = _mm_add_ps(qA12, _mm_cvtepi32_ps(_mm_madd_epi16(ixval, iyval)));
+            qA22 = _mm_add_ps(qA22, _mm_cvtepi32_ps(_mm_madd_epi16(iyval, iyval)));
+        }
+        /* the remaining pixels are covered by a step overlapping the previous one */
+        if (x < winSize && winSize >= 4)
+        {
+            vx_int32 xs = winSize - 4;
+            __m128i mask = lk_tail_mask(x - xs);
+            __m128i ival = lk_sample_u8_4(src + xs, stepI, qw0, qw1);
+            __m128i ixval = lk_sample_s16_4(dsrc_x + xs, dstep_x, qw0, qw1);
+            __m128i iyval = lk_sample_s16_4(dsrc_y + xs, dstep_y, qw0, qw1);
+
+            _mm_storel_epi64((__m128i *)(Iptr + xs), ival);
+            _mm_storel_epi64((__m128i *)(dIptr_x + xs), ixval);
+            _mm_storel_epi64((__m128i *)(dIptr_y + xs), iyval);
+
+            ixval = _mm_and_si128(ixval, mask);
+            iyval = _mm_and_si128(iyval, mask);
+            qA11 = _mm_add_ps(qA11, _mm_cvtepi32_ps(_mm_madd_epi16(ixval, ixval)));
+            qA12 = _mm_add_ps(qA12, _mm_cvtepi32_ps(_mm_madd_epi16(ixval, iyval)));
+            qA22 = _mm_add_ps(qA22, _mm_cvtepi32_ps(_mm_madd_epi16(iyval, iyval)));
+            x = winSize;
+        }
+#endif
+        for (; x < winSize; x++)
+        {
+            vx_int32 ival = LK_DESCALE(src[x]*iw[0] + src[x+1]*iw[1] +
+                                       src[x+stepI]*iw[2] + src[x+stepI+1]*iw[3], LK_W_BITS-5);
+            vx_int32 ixval = LK_DESCALE(dsrc_x[x]*iw[0] + dsrc_x[x+1]*iw[1] +
+                                        dsrc_x[x+dstep_x]*iw[2] + dsrc_x[x+dstep_x+1]*iw[3], LK_W_BITS);
+            vx_int32 iyval = LK_DESCALE(dsrc_y[x]*iw[0] + dsrc_y[x+1]*iw[1] +
+                                        dsrc_y[x+dstep_y]*iw[2] + dsrc_y[x+dstep_y+1]*iw[3], LK_W_BITS);
+
+            Iptr[x] = (vx_int16)ival;
+            dIptr_x[x] = (vx_int16)ixval;
+            dIptr_y[x] = (vx_int16)iyval;
+
+            a11 += (vx_float32)(ixval*ixval);
+            a12 += (vx_float32)(ixval*iyval);
+            a22 += (vx_float32)(iyval*iyval);
+        }
+    }
+#ifdef LK_USE_SSE2
+    a11 += lk_sum_ps(qA11);
+    a12 += lk_sum_ps(qA12);
+    a22 += lk_sum_ps(qA22);
+#endif
+    *A11 = a11 * LK_FLT_SCALE;
+    *A12 = a12 * LK_FLT_SCALE;
+    *A22 = a22 * LK_FLT_SCALE;
+}
+
+/*! \brief Computes the image mismatch vector of the new image window with the
+ * top-left corner at (ix + a, iy + b) against the sampled old image window.
+ */
+static LK_INLINE void lk_mismatch(const vx_lk_level_t *level, vx_int32 ix, vx_int32 iy, const vx_int32 iw[4],
+                                  vx_int32 winSize, const vx_int16 *Iwin, const vx_int16 *dxwin, const vx_int16 *dywin,
+                                  vx_bool avx2, vx_float64 *b1, vx_float64 *b2)
+{
+    vx_int32 x, y;
+    vx_int32 stepJ = level->next_stride;
+    vx_float64 s1 = 0, s2 = 0;
+#ifdef LK_USE_SSE2
+    __m128i qw0 = lk_weight_pair(iw[0], iw[1]);
+    __m128i qw1 = lk_weight_pair(iw[2], iw[3]);
+    __m128 qb1 = _mm_setzero_ps(), qb2 = _mm_setzero_ps();
+#endif
+
+    for (y = 0; y < winSize; y++)
+    {
+        const vx_uint8 *Jptr = LK_ROW(vx_uint8, level->next, stepJ, iy + y) + ix;
+        const vx_int16 *Iptr = Iwin + y * winSize;
+        const vx_int16 *dIptr_x = dxwin + y * winSize;
+        const vx_int16 *dIptr_y = dywin + y * winSize;
+
+        x = 0;
+#ifdef LK_USE_AVX2
+        if (avx2 == vx_true_e)
+            x = lk_mismatch_row_avx2(Jptr, stepJ, iw, winSize, Iptr, dIptr_x, dIptr_y, &qb1, &qb2);
+#endif
+#ifdef LK_USE_SSE2
+        for (; x <= winSize - 8; x += 8)
+        {
+            __m128i diff = _mm_sub_epi16(lk_sample_u8(Jptr + x, stepJ, qw0, qw1),
+                                         _mm_loadu_si128((const __m128i *)(Iptr + x)));
+            qb1 = _mm_add_ps(qb1, _mm_cvtepi32_ps(_mm_madd_epi16(diff, _mm_loadu_si128((const __m128i *)(dIptr_x + x)))));
+            qb2 = _mm_add_ps(qb2, _mm_cvtepi32_ps(_mm_madd_epi16(diff, _mm_loadu_si128((const __m128i *)(dIptr_y + x)))));
+        }
+        for (; x <= winSize - 4; x += 4)
+        {
+            __m128i diff = _mm_sub_epi16(lk_sample_u8_4(Jptr + x, stepJ, qw0, qw1),
+                                         _mm_loadl_epi64((const __m128i *)(Iptr + x)));
+            qb1 = _mm_add_ps(qb1, _mm_cvtepi32_ps(_mm_madd_epi16(diff, _mm_loadl_epi64((const __m128i *)(dIptr_x + x)))));
+            qb2 = _mm_add_ps(qb2, _mm_cvtepi32_ps(_mm_madd_epi16(diff, _mm_loadl_epi64((const __m128i *)(dIptr_y + x)))));
+        }
+        if (x < winSize && winSize >= 4)
+        {
+            vx_int32 xs = winSize - 4;
+            __m128i diff = _mm_sub_epi16(lk_sample_u8_4(Jptr + xs, stepJ, qw0, qw1),
+                                         _mm_loadl_epi64((const __m128i *)(Iptr + xs)));
+            diff = _mm_and_si128(diff, lk_tail_mask(x - xs));
+            qb1 = _mm_add_ps(qb1, _mm_cvtepi32_ps(_mm_madd_epi16(diff, _mm_loadl_epi64((const __m128i *)(dIptr_x + xs)))));
+            qb2 = _mm_add_ps(qb2, _mm_cvtepi32_ps(_mm_madd_epi16(diff, _mm_loadl_epi64((const __m128i *)(dIptr_y + xs)))));
+            x = winSize;
+        }
+#endif
+        for (; x < winSize; x++)
+        {
+            vx_int32 diff = LK_DESCALE(Jptr[x]*iw[0] + Jptr[x+1]*iw[1] +
+                                       Jptr[x+stepJ]*iw[2] + Jptr[x+stepJ+1]*iw[3],
+                                       LK_W_BITS-5) - Iptr[x];
+            s1 += (vx_float32)(diff*dIptr_x[x]);
+            s2 += (vx_float32)(diff*dIptr_y[x]);
+        }
+    }
+#ifdef LK_USE_SSE2
+    s1 += lk_sum_ps(qb1);
+    s2 += lk_sum_ps(qb2);
+#endif
+    *b1 = s1 * LK_FLT_SCALE;
+    *b2 = s2 * LK_FLT_SCALE;
+}
+
+static LK_INLINE void lk_track_points(const vx_lk_level_t *level, vx_lk_point_t *points, vx_size count,
+                                      vx_int32 winSize, vx_enum criteria, vx_float32 epsilon, vx_uint32 num_iterations,
+                                      vx_bool final_level, vx_int16 *scratch, vx_bool avx2)
+{
+    vx_float32 halfWin = (winSize - 1)*0.5f;
+    vx_int16 *Iwin = scratch;
+    vx_int16 *dxwin = scratch + winSize*winSize;
+    vx_int16 *dywin = scratch + 2*winSize*winSize;
+    vx_size i;
+
+    for (i = 0; i < count; i++)
+    {
+        vx_lk_point_t *pt = &points[i];
+        vx_float32 prev_x = pt->prev_x - halfWin;
+        vx_float32 prev_y = pt->prev_y - halfWin;
+        vx_float32 next_x = pt->next_x - halfWin;
+        vx_float32 next_y = pt->next_y - halfWin;
+        vx_float32 prevDelta_x = 0.0f, prevDelta_y = 0.0f;
+        vx_int32 iprev_x, iprev_y, iw[4];
+        vx_float64 A11, A12, A22, D;
+        vx_float32 minEig;
+        vx_uint32 j;
+
+        if (pt->status == 0)
+            continue;
+
+        iprev_x = (vx_int32)floorf(prev_x);
+        iprev_y = (vx_int32)floorf(prev_y);
+        if (iprev_x < 0 || iprev_x >= (vx_int32)level->width - winSize - 1 ||
+            iprev_y < 0 || iprev_y >= (vx_int32)level->height - winSize - 1)
+        {
+            if (final_level)
+            {
+                pt->status = 0;
+                pt->error = 0;
+            }
+            continue;
+        }
+
+        lk_weights(prev_x - iprev_x, prev_y - iprev_y, iw);
+        lk_sample_window(level, iprev_x, iprev_y, iw, winSize, Iwin, dxwin, dywin, avx2, &A11, &A12, &A22);
+
+        D = A11*A22 - A12*A12;
+        minEig = (vx_float32)((A22 + A11 - sqrt((A11-A22)*(A11-A22) + 4.f*A12*A12))/(2*winSize*winSize));
+        if (minEig < 1.0e-04F || D < 1.0e-07F)
+        {
+            if (final_level)
+                pt->status = 0;
+            continue;
+        }
+        D = 1.f/D;
+
+        for (j = 0; j < num_iterations || criteria == VX_TERM_CRITERIA_EPSILON; j++)
+        {
+            vx_int32 inext_x = (vx_int32)floorf(next_x);
+            vx_int32 inext_y = (vx_int32)floorf(next_y);
+            vx_float64 b1, b2;
+            vx_float32 delta_x, delta_y;
+
+            if (inext_x < 0 || inext_x >= (vx_int32)level->width - winSize - 1 ||
+                inext_y < 0 || inext_y >= (vx_int32)level->height - winSize - 1)
+            {
+                if (final_level)
+                    pt->status = 0;
+                break;
+            }
+
+            lk_weights(next_x - inext_x, next_y - inext_y, iw);
+            lk_mismatch(level, inext_x, inext_y, iw, winSize, Iwin, dxwin, dywin, avx2, &b1, &b2);
+
+            delta_x = (vx_float32)((A12*b2 - A22*b1) * D);
+            delta_y = (vx_float32)((A12*b1 - A11*b2) * D);
+
+            next_x += delta_x;
+            next_y += delta_y;
+            pt->next_x = next_x + halfWin;
+            pt->next_y = next_y + halfWin;
+
+            if ((delta_x*delta_x + delta_y*delta_y) <= epsilon &&
+                (criteria == VX_TERM_CRITERIA_EPSILON || criteria == VX_TERM_CRITERIA_BOTH))
+                break;
+
+            /* the point oscillates between two positions, settle in the middle */
+            if (j > 0 && fabsf(delta_x + prevDelta_x) < 0.01f &&
+                         fabsf(delta_y + prevDelta_y) < 0.01f)
+            {
+                pt->next_x -= delta_x*0.5f;
+                pt->next_y -= delta_y*0.5f;
+                break;
+            }
+            prevDelta_x = delta_x;
+            prevDelta_y = delta_y;
+        }
+    }
+}
+
+#ifdef LK_USE_AVX2
+static LK_TARGET_AVX2 void lk_track_points_avx2(const vx_lk_level_t *level, vx_lk_point_t *points, vx_size count,
+                                                vx_int32 winSize, vx_enum criteria, vx_float32 epsilon,
+                                                vx_uint32 num_iterations, vx_bool final_level, vx_int16 *scratch)
+{
+    lk_track_points(level, points, count, winSize, criteria, epsilon, num_iterations, final_level, scratch, vx_true_e);
+}
+#endif
+
+vx_status vxLKTrackLevel(const vx_lk_level_t *level, vx_lk_point_t *points, vx_size count,
+                         vx_size winSize_s, vx_enum criteria, vx_float32 epsilon, vx_uint32 num_iterations,
+                         vx_bool final_level, vx_int16 *scratch)
+{
+    vx_int32 winSize = (vx_int32)winSize_s;
+
+    if (winSize < 1 || scratch == NULL)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+#ifdef LK_USE_AVX2
+    /* the AVX2 steps are 16 pixels wide, smaller windows stay on SSE2 */
+    if (winSize >= 16 && lk_has_avx2() == vx_true_e)
+    {
+        lk_track_points_avx2(level, points, count, winSize, criteria, epsilon, num_iterations, final_level, scratch);
+        return VX_SUCCESS;
+    }
+#endif
+    lk_track_points(level, points, count, winSize, criteria, epsilon, num_iterations, final_level, scratch, vx_false_e);
+    return VX_SUCCESS;
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2012-2014 The Khronos Group Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and/or associated documentation files (the
+ * "Materials"), to deal in the Materials without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Materials, and to
+ * permit persons to whom the Materials are furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Materials.
+ *
+ * THE MATERIALS ARE PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * MATERIALS OR THE USE OR OTHER DEALINGS IN THE MATERIALS.
+ */
+
+#include <c_model.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PYR_USE_SSE2
+#endif
+
+/* The vertical pass keeps 2 extra columns on either side of the row. */
+#define PYR_PAD (2)
+
+/* The sample position of a nearest neighbor scale, see vxNearestScaling. */
+static vx_int32 pyr_nearest(vx_uint32 i, vx_float32 ratio, vx_uint32 size)
+{
+    vx_float32 src = ((vx_float32)i + 0.5f) * ratio - 0.5f;
+    vx_float32 src_min = floorf(src);
+    vx_int32 j = (vx_int32)src_min;
+    if (src - src_min >= 0.5f)
+        j++;
+    return (j < 0 ? 0 : j >= (vx_int32)size ? (vx_int32)size - 1 : j);
+}
+
+static const vx_uint8 *pyr_row(const void *base, const vx_imagepatch_addressing_t *addr, vx_int32 y,
+                               const vx_border_mode_t *borders, const vx_uint8 *constant_row)
+{
+    if (y < 0 || y >= (vx_int32)addr->dim_y)
+    {
+        if (borders->mode == VX_BORDER_MODE_CONSTANT)
+            return constant_row;
+        y = (y < 0 ? 0 : (vx_int32)addr->dim_y - 1);
+    }
+    return (const vx_uint8 *)base + y * addr->stride_y;
+}
+
+/* sum[x] = s0[x] + 4*s1[x] + 6*s2[x] + 4*s3[x] + s4[x], at most 16*255 */
+static void pyr_vertical(const vx_uint8 *s[5], vx_uint16 *sum, vx_uint32 width)
+{
+    vx_uint32 x = 0;
+#ifdef PYR_USE_SSE2
+    const __m128i z = _mm_setzero_si128();
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i r0 = _mm_loadu_si128((const __m128i *)&s[0][x]);
+        __m128i r1 = _mm_loadu_si128((const __m128i *)&s[1][x]);
+        __m128i r2 = _mm_loadu_si128((const __m128i *)&s[2][x]);
+        __m128i r3 = _mm_loadu_si128((const __m128i *)&s[3][x]);
+        __m128i r4 = _mm_loadu_si128((const __m128i *)&s[4][x]);
+        __m128i lo, hi, t;
+
+        lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, z), _mm_unpacklo_epi8(r4, z));
+        hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, z), _mm_unpackhi_epi8(r4, z));
+        t = _mm_add_epi16(_mm_unpacklo_epi8(r1, z), _mm_unpacklo_epi8(r3, z));
+        lo = _mm_add_epi16(lo, _mm_slli_epi16(t, 2));
+        t = _mm_add_epi16(_mm_unpackhi_epi8(r1, z), _mm_unpackhi_epi8(r3, z));
+        hi = _mm_add_epi16(hi, _mm_slli_epi16(t, 2));
+        t = _mm_unpacklo_epi8(r2, z);
+        lo = _mm_add_epi16(lo, _mm_add_epi16(_mm_slli_epi16(t, 2), _mm_slli_epi16(t, 1)));
+        t = _mm_unpackhi_epi8(r2, z);
+        hi = _mm_add_epi16(hi, _mm_add_epi16(_mm_slli_epi16(t, 2), _mm_slli_epi16(t, 1)));
+        _mm_storeu_si128((__m128i *)&sum[x], lo);
+        _mm_storeu_si128((__m128i *)&sum[x + 8], hi);
+    }
+#endif
+    for (; x < width; x++)
+    {
+        sum[x] = (vx_uint16)(s[0][x] + s[4][x] + 4 * (s[1][x] + s[3][x]) + 6 * s[2][x]);
+    }
+}
+
+#ifdef PYR_USE_SSE2
+/* splits 16 values starting at p into the even and the odd ones */
+static void pyr_deinterleave(const vx_uint16 *p, __m128i *even, __m128i *odd)
+{
+    const __m128i mask = _mm_set1_epi32(0xFFFF);
+    __m128i a = _mm_loadu_si128((const __m128i *)p);
+    __m128i b = _mm_loadu_si128((const __m128i *)(p + 8));
+    /* the sums fit in 15 bits so the signed pack does not saturate */
+    *even = _mm_packs_epi32(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+    *odd = _mm_packs_epi32(_mm_srli_epi32(a, 16), _mm_srli_epi32(b, 16));
+}
+#endif
+
+/* dst[i] = (sum of the 1-4-6-4-1 taps around sum[2*i+1]) / 256 */
+static void pyr_horizontal_half(const vx_uint16 *sum, vx_uint8 *dst, vx_uint32 width)
+{
+    vx_uint32 i = 0;
+#ifdef PYR_USE_SSE2
+    for (; i + 8 <= width; i += 8)
+    {
+        __m128i e0, o0, e1, o1, em, om, acc;
+        pyr_deinterleave(&sum[2 * i], &e0, &o0);
+        pyr_deinterleave(&sum[2 * i + 2], &e1, &o1);
+        pyr_deinterleave(&sum[2 * i] - 2, &em, &om);
+        /* at most 256*255, the unsigned 16 bit sums do not overflow */
+        acc = _mm_add_epi16(om, o1);
+        acc = _mm_add_epi16(acc, _mm_slli_epi16(_mm_add_epi16(e0, e1), 2));
+        acc = _mm_add_epi16(acc, _mm_add_epi16(_mm_slli_epi16(o0, 2), _mm_slli_epi16(o0, 1)));
+        acc = _mm_srli_epi16(acc, 8);
+        _mm_storel_epi64((__m128i *)&dst[i], _mm_packus_epi16(acc, acc));
+    }
+#endif
+    for (; i < width; i++)
+    {
+        const vx_uint16 *c = &sum[2 * i + 1];
+        dst[i] = (vx_uint8)((c[-2] + c[2] + 4 * (c[-1] + c[1]) + 6 * c[0]) >> 8);
+    }
+}
+
+static void pyr_horizontal(const vx_uint16 *sum, vx_uint8 *dst, vx_uint32 width, vx_float32 ratio, vx_uint32 src_width)
+{
+    vx_uint32 i;
+    for (i = 0; i < width; i++)
+    {
+        const vx_uint16 *c = &sum[pyr_nearest(i, ratio, src_width)];
+        dst[i] = (vx_uint8)((c[-2] + c[2] + 4 * (c[-1] + c[1]) + 6 * c[0]) >> 8);
+    }
+}
+
+vx_status vxHalfScaleGaussian(vx_image src, vx_image dst, vx_image copy, const vx_border_mode_t *borders, void *scratch)
+{
+    vx_status status = VX_SUCCESS;
+    void *src_base = NULL, *dst_base = NULL, *copy_base = NULL;
+    vx_imagepatch_addressing_t src_addr, dst_addr, copy_addr;
+    vx_rectangle_t src_rect = {0, 0, 0, 0}, dst_rect = {0, 0, 0, 0};
+    vx_uint16 *sum = (vx_uint16 *)scratch + PYR_PAD;
+    vx_uint8 *constant_row = NULL;
+    vx_uint32 y, copied = 0;
+    vx_float32 wr, hr;
+
+    vxQueryImage(src, VX_IMAGE_ATTRIBUTE_WIDTH, &src_rect.end_x, sizeof(src_rect.end_x));
+    vxQueryImage(src, VX_IMAGE_ATTRIBUTE_HEIGHT, &src_rect.end_y, sizeof(src_rect.end_y));
+    status |= vxAccessImagePatch(src, &src_rect, 0, &src_addr, &src_base, VX_READ_ONLY);
+    if (dst)
+    {
+        vxQueryImage(dst, VX_IMAGE_ATTRIBUTE_WIDTH, &dst_rect.end_x, sizeof(dst_rect.end_x));
+        vxQueryImage(dst, VX_IMAGE_ATTRIBUTE_HEIGHT, &dst_rect.end_y, sizeof(dst_rect.end_y));
+        status |= vxAccessImagePatch(dst, &dst_rect, 0, &dst_addr, &dst_base, VX_WRITE_ONLY);
+    }
+    if (copy)
+        status |= vxAccessImagePatch(copy, &src_rect, 0, &copy_addr, &copy_base, VX_WRITE_ONLY);
+
+    if (status == VX_SUCCESS)
+    {
+        wr = (dst ? (vx_float32)src_rect.end_x / (vx_float32)dst_rect.end_x : 0.0f);
+        hr = (dst ? (vx_float32)src_rect.end_y / (vx_float32)dst_rect.end_y : 0.0f);
+        if (borders->mode == VX_BORDER_MODE_CONSTANT)
+        {
+            constant_row = (vx_uint8 *)(sum + src_rect.end_x + PYR_PAD);
+            memset(constant_row, (vx_uint8)borders->constant_value, src_rect.end_x);
+        }
+
+        for (y = 0; y < dst_rect.end_y; y++)
+        {
+            vx_int32 cy = pyr_nearest(y, hr, src_rect.end_y);
+            vx_uint8 *d = (vx_uint8 *)dst_base + y * dst_addr.stride_y;
+            const vx_uint8 *s[5];
+            vx_int32 k;
+
+            for (k = 0; k < 5; k++)
+                s[k] = pyr_row(src_base, &src_addr, cy + k - 2, borders, constant_row);
+            /* the copy of the source follows the rows while they are in cache */
+            for (; copy_base && (vx_int32)copied <= cy + 2 && copied < src_rect.end_y; copied++)
+            {
+                memcpy((vx_uint8 *)copy_base + copied * copy_addr.stride_y,
+                       (vx_uint8 *)src_base + copied * src_addr.stride_y, src_rect.end_x);
+            }
+
+            pyr_vertical(s, sum, src_rect.end_x);
+            if (borders->mode == VX_BORDER_MODE_CONSTANT)
+            {
+                sum[-2] = sum[-1] = sum[src_rect.end_x] = sum[src_rect.end_x + 1] =
+                    (vx_uint16)(16 * borders->constant_value);
+            }
+            else
+            {
+                sum[-2] = sum[-1] = sum[0];
+                sum[src_rect.end_x] = sum[src_rect.end_x + 1] = sum[src_rect.end_x - 1];
+            }
+
+            if (src_rect.end_x == 2 * dst_rect.end_x)
+                pyr_horizontal_half(sum, d, dst_rect.end_x);
+            else
+                pyr_horizontal(sum, d, dst_rect.end_x, wr, src_rect.end_x);
+        }
+        for (; copy_base && copied < src_rect.end_y; copied++)
+        {
+            memcpy((vx_uint8 *)copy_base + copied * copy_addr.stride_y,
+                   (vx_uint8 *)src_base + copied * src_addr.stride_y, src_rect.end_x);
+        }
+    }
+
+    if (copy_base)
+        status |= vxCommitImagePatch(copy, &src_rect, 0, &copy_addr, copy_base);
+    if (dst_base)
+        status |= vxCommitImagePatch(dst, &dst_rect, 0, &dst_addr, dst_base);
+    if (src_base)
+        status |= vxCommitImagePatch(src, NULL, 0, &src_addr, src_base);
+    return status;
+}
@@ -33,332 +33,283 @@
 #include <vx_internal.h>
 #include <c_model.h>
 
-typedef struct _vx_keypoint_t_optpyrlk_internal {
-    vx_float32 x;                 /*!< \brief The x coordinate. */
-    vx_float32 y;                 /*!< \brief The y coordinate. */
-    vx_float32 strength;        /*!< \brief The strength of the keypoint. */
-    vx_float32 scale;           /*!< \brief Unused field reserved for future use. */
-    vx_float32 orientation;     /*!< \brief Unused field reserved for future use. */
-    vx_int32 tracking_status;   /*!< \brief A zero indicates a lost point. */
-    vx_float32 error;           /*!< \brief An tracking method specific error. */
-} vx_keypoint_t_optpyrlk_internal;
-
-#define  INT_ROUND(x,n)     (((x) + (1 << ((n)-1))) >> (n))
-
-static vx_status LKTracker(
-        const vx_image prevImg, const vx_image prevDerivIx, const vx_image prevDerivIy, const vx_image nextImg,
-        const vx_array prevPts, vx_array nextPts,
-        vx_scalar winSize_s, vx_scalar criteria_s,
-        vx_uint32 level,vx_scalar epsilon,
-        vx_scalar num_iterations)
+/*! \brief The maximum number of levels a pyramid may have (see \ref vxCreatePyramid). */
+#define VX_OPTPYRLK_MAX_LEVELS (8)
+
+/*! \brief The maximum number of jobs the points of a level are split into. */
+#define VX_OPTPYRLK_MAX_JOBS (VX_INT_MAX_WORKERS)
+
+/*! \brief The fewest points worth a job of their own. */
+#define VX_OPTPYRLK_MIN_JOB_POINTS (32)
+
+/*! \brief A contiguous range of points tracked over one level by one thread. */
+typedef struct _vx_optpyrlk_job_t {
+    /*! \brief The level being tracked. */
+    const vx_lk_level_t *level;
+    /*! \brief The first point of the range. */
+    vx_lk_point_t *points;
+    /*! \brief The number of points in the range. */
+    vx_size    count;
+    /*! \brief The window buffers of this job. */
+    vx_int16  *scratch;
+    vx_size    winSize;
+    vx_enum    criteria;
+    vx_float32 epsilon;
+    vx_uint32  num_iterations;
+    vx_bool    final_level;
+    /*! \brief The result of \ref vxLKTrackLevel for the range. */
+    vx_status  status;
+} vx_optpyrlk_job_t;
+
+/*! \brief The per-node state of the optical flow kernel, created once by the
+ * initializer and kept in the node local data across executions.
+ */
+typedef struct _vx_optpyrlk_data_t {
+    /*! \brief The graph computing the Scharr gradients of every old pyramid level. */
+    vx_graph   graph;
+    /*! \brief The Scharr node of each level. */
+    vx_node    nodes[VX_OPTPYRLK_MAX_LEVELS];
+    /*! \brief The x gradient of each level. */
+    vx_image   derivIx[VX_OPTPYRLK_MAX_LEVELS];
+    /*! \brief The y gradient of each level. */
+    vx_image   derivIy[VX_OPTPYRLK_MAX_LEVELS];
+    /*! \brief The number of levels in the graph. */
+    vx_size    levels;
+    /*! \brief The old pyramid the graph is currently bound to. */
+    vx_pyramid pyramid;
+    /*! \brief The window buffers of the tracker, one set per job, see \ref vxLKTrackLevel. */
+    vx_int16  *scratch;
+    /*! \brief The number of elements in the scratch buffer. */
+    vx_size    scratchCapacity;
+    /*! \brief The workers running all jobs but the first, NULL if single threaded. */
+    vx_threadpool_t *workers;
+    /*! \brief The number of threads including the caller, see \ref VX_NODE_ATTRIBUTE_THREADS. */
+    vx_uint32  numThreads;
+    /*! \brief The jobs of the level being tracked. */
+    vx_optpyrlk_job_t jobs[VX_OPTPYRLK_MAX_JOBS];
+    /*! \brief The work items handed to the workers. */
+    vx_value_set_t workitems[VX_OPTPYRLK_MAX_JOBS];
+    /*! \brief The sub-pixel state of every tracked point. */
+    vx_lk_point_t *points;
+    /*! \brief The output keypoints staged for \ref vxAddArrayItems. */
+    vx_keypoint_f32_t *items;
+    /*! \brief The number of points the buffers above can hold. */
+    vx_size    pointsCapacity;
+} vx_optpyrlk_data_t;
+
+static vx_status vxReserveOptPyrLKScratch(vx_optpyrlk_data_t *data, vx_size winSize, vx_size numPoints)
 {
-    vx_status status = VX_FAILURE;
-
-    vx_size winSize;
-    vxAccessScalarValue(winSize_s,&winSize);
-    vx_size halfWin = winSize*0.5f;
-    vx_size list_length,list_indx;
-    const vx_image I = prevImg;
-    const vx_image J = nextImg;
-    const vx_image derivIx = prevDerivIx;
-    const vx_image derivIy = prevDerivIy;
-
-    int j;
-    vx_enum termination_Criteria;
-
-    vx_image IWinBuf;
-    vx_image derivIWinBuf_x;
-    vx_image derivIWinBuf_y;
-
-    vx_df_image derivIx_format = 0;
-    vx_df_image J_format = 0;
-    vx_df_image derivIy_format = 0;
-    vx_df_image I_format = 0;
-    vx_rectangle_t rect;
-
-    void *derivIx_base = 0,*J_base = 0,*derivIy_base = 0,*I_base = 0;
-    vx_imagepatch_addressing_t  derivIx_addr,J_addr,derivIy_addr,I_addr;
-
-
-    void *IWinBuf_base = 0,*derivIWinBuf_x_base = 0,*derivIWinBuf_y_base = 0;
-    vx_df_image IWinBuf_format = 0;
-    vx_df_image derivIWinBuf_x_format = 0;
-    vx_df_image derivIWinBuf_y_format = 0;
-    vx_imagepatch_addressing_t  IWinBuf_addr,derivIWinBuf_x_addr,derivIWinBuf_y_addr;
-
-    vx_size prevPts_stride = 0;
-    vx_size nextPts_stride = 0;
-    void *prevPtsFirstItem = NULL;
-    void *nextPtsFirstItem = NULL;
-    vxQueryArray(prevPts,VX_ARRAY_ATTRIBUTE_NUMITEMS,&list_length,sizeof(list_length));
-    vxAccessArrayRange(prevPts, 0, list_length, &prevPts_stride, &prevPtsFirstItem, VX_READ_ONLY);
-    vxAccessArrayRange(nextPts, 0, list_length, &nextPts_stride, &nextPtsFirstItem, VX_READ_AND_WRITE);
-
-    vx_keypoint_t_optpyrlk_internal *nextPt_item = (vx_keypoint_t_optpyrlk_internal*)nextPtsFirstItem;
-    vx_keypoint_t_optpyrlk_internal *prevPt_item = (vx_keypoint_t_optpyrlk_internal*)prevPtsFirstItem;
-
-
-    int num_iterations_i;
-    vx_float32 epsilon_f;
-
-    vxAccessScalarValue(num_iterations,&num_iterations_i);
-    vxAccessScalarValue(epsilon,&epsilon_f);
-    vxAccessScalarValue(criteria_s,&termination_Criteria);
-
-    vx_context context_lk_internal = vxCreateContext();
-
-    IWinBuf = vxCreateImage(context_lk_internal,winSize,winSize,VX_DF_IMAGE_S16);
-    derivIWinBuf_x = vxCreateImage(context_lk_internal,winSize,winSize,VX_DF_IMAGE_S16);
-    derivIWinBuf_y = vxCreateImage(context_lk_internal,winSize,winSize,VX_DF_IMAGE_S16);
-
-    vxInitImage((vx_image_t*)IWinBuf,winSize,winSize,VX_DF_IMAGE_S16);
-    vxAllocateImage((vx_image_t*)IWinBuf);
-    vxInitImage((vx_image_t*)derivIWinBuf_x,winSize,winSize,VX_DF_IMAGE_S16);
-    vxAllocateImage((vx_image_t*)derivIWinBuf_x);
-    vxInitImage((vx_image_t*)derivIWinBuf_y,winSize,winSize,VX_DF_IMAGE_S16);
-    vxAllocateImage((vx_image_t*)derivIWinBuf_y);
-
-
-
-    vxQueryImage(derivIx, VX_IMAGE_ATTRIBUTE_FORMAT, &derivIx_format, sizeof(derivIx_format));
-    vxQueryImage(J, VX_IMAGE_ATTRIBUTE_FORMAT, &J_format, sizeof(J_format));
-    vxQueryImage(derivIy, VX_IMAGE_ATTRIBUTE_FORMAT, &derivIy_format, sizeof(derivIy_format));
-    vxQueryImage(I, VX_IMAGE_ATTRIBUTE_FORMAT, &I_format, sizeof(I_format));
-
-    vxGetValidRegionImage(derivIx,&rect);
-    status = VX_SUCCESS;
-
-    status |= vxAccessImagePatch(derivIx, &rect, 0, &derivIx_addr, (void **)&derivIx_base,VX_READ_ONLY);
-    status |= vxAccessImagePatch(J, &rect, 0, &J_addr, (void **)&J_base,VX_READ_ONLY);
-    status |= vxAccessImagePatch(derivIy, &rect, 0, &derivIy_addr, (void **)&derivIy_base,VX_READ_ONLY);
-    status |= vxAccessImagePatch(I, &rect, 0, &I_addr, (void **)&I_base,VX_READ_ONLY);
-
-    vxQueryImage(IWinBuf, VX_IMAGE_ATTRIBUTE_FORMAT, &IWinBuf_format, sizeof(IWinBuf_format));
-    vxQueryImage(derivIWinBuf_x, VX_IMAGE_ATTRIBUTE_FORMAT, &derivIWinBuf_x_format, sizeof(derivIWinBuf_x_format));
-    vxQueryImage(derivIWinBuf_y, VX_IMAGE_ATTRIBUTE_FORMAT, &derivIWinBuf_y_format, sizeof(derivIWinBuf_y_format));
-
-    vxGetValidRegionImage(IWinBuf,&rect);
-
-    status |= vxAccessImagePatch(IWinBuf, &rect, 0, &IWinBuf_addr, (void **)&IWinBuf_base,VX_READ_AND_WRITE);
-    status |= vxAccessImagePatch(derivIWinBuf_x, &rect, 0, &derivIWinBuf_x_addr, (void **)&derivIWinBuf_x_base,VX_READ_AND_WRITE);
-    status |= vxAccessImagePatch(derivIWinBuf_y, &rect, 0, &derivIWinBuf_y_addr, (void **)&derivIWinBuf_y_base,VX_READ_AND_WRITE);
-
-
-
-    for(list_indx=0;list_indx<list_length;list_indx++)
+    vx_size size = 3 * winSize * winSize * data->numThreads;
+    if (size > data->scratchCapacity)
     {
+        free(data->scratch);
+        data->scratch = (vx_int16 *)malloc(size * sizeof(vx_int16));
+        data->scratchCapacity = data->scratch ? size : 0;
+    }
+    if (numPoints > data->pointsCapacity)
+    {
+        free(data->points);
+        free(data->items);
+        data->points = (vx_lk_point_t *)malloc(numPoints * sizeof(vx_lk_point_t));
+        data->items = (vx_keypoint_f32_t *)malloc(numPoints * sizeof(vx_keypoint_f32_t));
+        data->pointsCapacity = (data->points && data->items) ? numPoints : 0;
+    }
+    if (data->scratchCapacity < size || data->pointsCapacity < numPoints)
+    {
+        return VX_ERROR_NO_MEMORY;
+    }
+    return VX_SUCCESS;
+}
 
+/*! \internal The objects are held by internal references only so that they
+ * outlive the garbage collection of external references in \ref vxReleaseContext
+ * until the node is destroyed.
+ */
+static void vxReleaseOptPyrLKData(vx_optpyrlk_data_t *data)
+{
+    vx_size lev;
+    for (lev = 0; lev < data->levels; lev++)
+    {
+        if (data->nodes[lev])
+            vxReleaseReferenceInt((vx_reference *)&data->nodes[lev], VX_TYPE_NODE, VX_INTERNAL, NULL);
+        if (data->derivIx[lev])
+            vxReleaseReferenceInt((vx_reference *)&data->derivIx[lev], VX_TYPE_IMAGE, VX_INTERNAL, NULL);
+        if (data->derivIy[lev])
+            vxReleaseReferenceInt((vx_reference *)&data->derivIy[lev], VX_TYPE_IMAGE, VX_INTERNAL, NULL);
+    }
+    if (data->graph)
+        vxReleaseReferenceInt((vx_reference *)&data->graph, VX_TYPE_GRAPH, VX_INTERNAL, NULL);
+    if (data->pyramid)
+        vxReleaseReferenceInt((vx_reference *)&data->pyramid, VX_TYPE_PYRAMID, VX_INTERNAL, NULL);
+    if (data->workers)
+        vxDestroyThreadpool(&data->workers);
+    free(data->scratch);
+    free(data->points);
+    free(data->items);
+    memset(data, 0, sizeof(*data));
+}
 
-        vx_keypoint_t_optpyrlk_internal nextPt,prevPt;
-
-
-        vx_keypoint_t_optpyrlk_internal iprevPt, inextPt;
-
-        prevPt.x = prevPt_item[list_indx].x;
-        prevPt.y = prevPt_item[list_indx].y;
-
-        // nextPt.x = prevPt.x;
-        // nextPt.y = prevPt.y;
-        nextPt.x = nextPt_item[list_indx].x;
-        nextPt.y = nextPt_item[list_indx].y;
-
-        prevPt.x -= halfWin;
-        prevPt.y -= halfWin;
-        nextPt.x -= halfWin;
-        nextPt.y -= halfWin;
-
-        iprevPt.x = floor(prevPt.x);
-        iprevPt.y = floor(prevPt.y);
-
-        if( iprevPt.x < 0 || iprevPt.x >= derivIx_addr.dim_x - winSize-1 ||
-            iprevPt.y < 0 || iprevPt.y >= derivIx_addr.dim_y - winSize-1 )
-        {
-            if( level == 0 )
-            {
-                nextPt.tracking_status = 0;
-                nextPt.error = 0;
-            }
-            continue;
-        }
-
-        float a = prevPt.x - iprevPt.x;
-        float b = prevPt.y - iprevPt.y;
-        const int W_BITS = 14, W_BITS1 = 14;
-        const float FLT_SCALE = 1.f/(1 << 20);
-        int iw00 = (int)(((1.f - a)*(1.f - b)*(1 << W_BITS))+0.5f);
-        int iw01 = (int)((a*(1.f - b)*(1 << W_BITS))+0.5f);
-        int iw10 = (int)(((1.f - a)*b*(1 << W_BITS))+0.5f);
-        int iw11 = (1 << W_BITS) - iw00 - iw01 - iw10;
-
-        int dstep_x = (int)(derivIx_addr.stride_y)/2;
-        int dstep_y = (int)(derivIy_addr.stride_y)/2;
-        int stepJ = (int)(J_addr.stride_y);
-        int stepI = (int)(I_addr.stride_y);
-        double A11 = 0, A12 = 0, A22 = 0;
-
-
-        // extract the patch from the first image, compute covariation matrix of derivatives
-        int x, y;
-        for( y = 0; y < winSize; y++ )
-        {
-            unsigned char *src = (unsigned char*)vxFormatImagePatchAddress2d(I_base, iprevPt.x, y + iprevPt.y, &I_addr);
-            short *dsrc_x = (short*)vxFormatImagePatchAddress2d(derivIx_base, iprevPt.x, y + iprevPt.y, &derivIx_addr);
-            short *dsrc_y = (short*)vxFormatImagePatchAddress2d(derivIy_base, iprevPt.x, y + iprevPt.y, &derivIy_addr);
-
-
-            short* Iptr = (short*)vxFormatImagePatchAddress2d(IWinBuf_base,0, y,&IWinBuf_addr);
-            short* dIptr_x = (short*)vxFormatImagePatchAddress2d(derivIWinBuf_x_base,0, y,&derivIWinBuf_x_addr);
-            short* dIptr_y = (short*)vxFormatImagePatchAddress2d(derivIWinBuf_y_base,0, y,&derivIWinBuf_y_addr);
-
-            x = 0;
-
-
-            for( ; x < winSize; x++, dsrc_x ++, dsrc_y ++)
-            {
-                int ival = INT_ROUND(src[x]*iw00 + src[x+1]*iw01 +
-                                      src[x+stepI]*iw10 + src[x+stepI+1]*iw11, W_BITS1-5);
-                int ixval = INT_ROUND(dsrc_x[0]*iw00 + dsrc_x[1]*iw01 +
-                                       dsrc_x[dstep_x]*iw10 + dsrc_x[dstep_x+1]*iw11, W_BITS1);
-                int iyval = INT_ROUND(dsrc_y[0]*iw00 + dsrc_y[1]*iw01 + dsrc_y[dstep_y]*iw10 +
-                                       dsrc_y[dstep_y+1]*iw11, W_BITS1);
-
-                Iptr[x] = (short)ival;
-                dIptr_x[x] = (short)ixval;
-                dIptr_y[x] = (short)iyval;
-
-                A11 += (float)(ixval*ixval);
-                A12 += (float)(ixval*iyval);
-                A22 += (float)(iyval*iyval);
-            }
-        }
-
-
-        A11 *= FLT_SCALE;
-        A12 *= FLT_SCALE;
-        A22 *= FLT_SCALE;
-
-        double D = A11*A22 - A12*A12;
-        float minEig = (A22 + A11 - sqrt((A11-A22)*(A11-A22) +
-                        4.f*A12*A12))/(2*winSize*winSize);
-
+/*! \internal Rebinds the gradient graph to the levels of another old pyramid,
+ * e.g. after a delay has been aged. The level dimensions are unchanged so
+ * the graph does not need to be verified again.
+ */
+static vx_status vxBindOptPyrLKPyramid(vx_optpyrlk_data_t *data, vx_pyramid pyramid)
+{
+    vx_status status = VX_SUCCESS;
+    vx_size lev;
+    if (data->pyramid == pyramid)
+        return VX_SUCCESS;
+    for (lev = 0; lev < data->levels && status == VX_SUCCESS; lev++)
+    {
+        vx_image level = vxGetPyramidLevel(pyramid, (vx_uint32)lev);
+        status = vxSetParameterByIndex(data->nodes[lev], 0, (vx_reference)level);
+        vxReleaseImage(&level);
+    }
+    if (status == VX_SUCCESS)
+    {
+        if (data->pyramid)
+            vxReleaseReferenceInt((vx_reference *)&data->pyramid, VX_TYPE_PYRAMID, VX_INTERNAL, NULL);
+        vxIncrementReference((vx_reference_t *)pyramid, VX_INTERNAL);
+        data->pyramid = pyramid;
+    }
+    return status;
+}
 
-        if( minEig < 1.0e-04F || D < 1.0e-07F  )
-        {
-            if( level == 0  )
-                nextPt.tracking_status = 0;
-            continue;
-        }
+/*! \internal Reads the coordinates of an item of a keypoint array of either type. */
+static void vxGetOptPyrLKCoordinates(const void *base, vx_size index, vx_size stride, vx_enum type,
+                                     vx_float32 *x, vx_float32 *y)
+{
+    if (type == VX_TYPE_KEYPOINT_F32)
+    {
+        *x = vxArrayItem(vx_keypoint_f32_t, base, index, stride).x;
+        *y = vxArrayItem(vx_keypoint_f32_t, base, index, stride).y;
+    }
+    else
+    {
+        *x = (vx_float32)vxArrayItem(vx_keypoint_t, base, index, stride).x;
+        *y = (vx_float32)vxArrayItem(vx_keypoint_t, base, index, stride).y;
+    }
+}
 
-        D = 1.f/D;
+static vx_bool vxOptPyrLKWorker(vx_threadpool_worker_t *worker)
+{
+    vx_optpyrlk_job_t *job = (vx_optpyrlk_job_t *)worker->data->v1;
+    job->status = vxLKTrackLevel(job->level, job->points, job->count, job->winSize, job->criteria,
+                                 job->epsilon, job->num_iterations, job->final_level, job->scratch);
+    return (job->status == VX_SUCCESS ? vx_true_e : vx_false_e);
+}
 
-        // nextPt.x -= halfWin;
-        // nextPt.y -= halfWin;
-        float prevDelta_x=0.0f,prevDelta_y=0.0f;
+/*! \internal Splits the points into contiguous ranges, one per thread. The
+ * points are independent and every job writes only its own range, so the
+ * result does not depend on the number of threads or the order of completion.
+ * The calling thread runs the first job itself.
+ */
+static vx_status vxRunOptPyrLKJobs(vx_optpyrlk_data_t *data, const vx_lk_level_t *lk, vx_size count,
+                                   vx_size winSize, vx_enum criteria, vx_float32 epsilon,
+                                   vx_uint32 num_iterations, vx_bool final_level)
+{
+    vx_status status = VX_SUCCESS;
+    vx_size numJobs = (count + VX_OPTPYRLK_MIN_JOB_POINTS - 1) / VX_OPTPYRLK_MIN_JOB_POINTS;
+    vx_size j, first = 0;
+
+    if (numJobs > data->numThreads)
+        numJobs = data->numThreads;
+    if (numJobs == 0 || data->workers == NULL)
+        numJobs = 1;
+    for (j = 0; j < numJobs; j++)
+    {
+        vx_optpyrlk_job_t *job = &data->jobs[j];
+        job->level = lk;
+        job->points = &data->points[first];
+        job->count = count / numJobs + (j < count % numJobs ? 1 : 0);
+        job->scratch = &data->scratch[j * 3 * winSize * winSize];
+        job->winSize = winSize;
+        job->criteria = criteria;
+        job->epsilon = epsilon;
+        job->num_iterations = num_iterations;
+        job->final_level = final_level;
+        job->status = VX_SUCCESS;
+        data->workitems[j].v1 = (vx_value_t)job;
+        first += job->count;
+    }
 
-        j = 0;
-        while(j < num_iterations_i || termination_Criteria == VX_TERM_CRITERIA_EPSILON)
+    if (numJobs > 1 &&
+        vxIssueThreadpool(data->workers, &data->workitems[1], (uint32_t)(numJobs - 1)) == vx_false_e)
+    {
+        /* some of the jobs may have been issued before the queues overflowed */
+        vxCompleteThreadpool(data->workers, vx_true_e);
+        return VX_ERROR_NO_RESOURCES;
+    }
+    status = vxLKTrackLevel(lk, data->jobs[0].points, data->jobs[0].count, winSize, criteria,
+                            epsilon, num_iterations, final_level, data->jobs[0].scratch);
+    if (numJobs > 1)
+    {
+        vxCompleteThreadpool(data->workers, vx_true_e);
+        for (j = 1; j < numJobs; j++)
         {
-            inextPt.x = floor(nextPt.x);
-            inextPt.y = floor(nextPt.y);
-
-            if( inextPt.x < 0 || inextPt.x >= J_addr.dim_x-winSize-1 ||
-               inextPt.y < 0 || inextPt.y >= J_addr.dim_y- winSize-1 )
-            {
-                if( level == 0  )
-                    nextPt.tracking_status = 0;
-                break;
-            }
-
-            a = nextPt.x - inextPt.x;
-            b = nextPt.y - inextPt.y;
-            iw00 = (int)(((1.f - a)*(1.f - b)*(1 << W_BITS))+0.5);
-            iw01 = (int)((a*(1.f - b)*(1 << W_BITS))+0.5);
-            iw10 = (int)(((1.f - a)*b*(1 << W_BITS))+0.5);
-            iw11 = (1 << W_BITS) - iw00 - iw01 - iw10;
-            double b1 = 0, b2 = 0;
-
-            for( y = 0; y < winSize; y++ )
-            {
-                unsigned char* Jptr = (unsigned char*)vxFormatImagePatchAddress2d(J_base, inextPt.x, y + inextPt.y, &J_addr);
-                short* Iptr = (short*)vxFormatImagePatchAddress2d(IWinBuf_base,0, y,&IWinBuf_addr);
-                short* dIptr_x = (short*)vxFormatImagePatchAddress2d(derivIWinBuf_x_base,0, y,&derivIWinBuf_x_addr);
-                short* dIptr_y = (short*)vxFormatImagePatchAddress2d(derivIWinBuf_y_base,0, y,&derivIWinBuf_y_addr);
-
-                x = 0;
-
-
-                for( ; x < winSize; x++)
-                {
-                    int diff = INT_ROUND(Jptr[x]*iw00 + Jptr[x+1]*iw01 +
-                                          Jptr[x+stepJ]*iw10 + Jptr[x+stepJ+1]*iw11,
-                                          W_BITS1-5) - Iptr[x];
-                    b1 += (float)(diff*dIptr_x[x]);
-                    b2 += (float)(diff*dIptr_y[x]);
-                }
-            }
-
-
-            b1 *= FLT_SCALE;
-            b2 *= FLT_SCALE;
-
-            float delta_x = (float)((A12*b2 - A22*b1) * D);
-            float delta_y = (float)((A12*b1 - A11*b2) * D);
-            //printf("lvl=%d pt=%d iter=%d   -> (%f, %f) += (%f, %f)\n", (int)level, (int)list_indx, (int)j, nextPt.x, nextPt.y, delta_x, delta_y);
-            //delta = -delta;
-
-            nextPt.x += delta_x;
-            nextPt.y += delta_y;
-            nextPt_item[list_indx].x = nextPt.x + halfWin;
-            nextPt_item[list_indx].y = nextPt.y + halfWin;
-
-            if( (delta_x*delta_x + delta_y*delta_y) <= epsilon_f && (termination_Criteria == VX_TERM_CRITERIA_EPSILON || termination_Criteria == VX_TERM_CRITERIA_BOTH))
-                break;
-
-            if( j > 0 && abs(delta_x + prevDelta_x) < 0.01 &&
-               abs(delta_y + prevDelta_y) < 0.01 )
-            {
-                nextPt_item[list_indx].x -= delta_x*0.5f;
-                nextPt_item[list_indx].y -= delta_y*0.5f;
-                break;
-            }
-            prevDelta_x = delta_x;
-            prevDelta_y = delta_y;
-            j++;
+            if (data->jobs[j].status != VX_SUCCESS)
+                status = data->jobs[j].status;
         }
     }
-    status |= vxCommitArrayRange(prevPts, 0, list_length,prevPtsFirstItem);
-    status |= vxCommitArrayRange(nextPts, 0, list_length,nextPtsFirstItem);
-
-    status |= vxCommitImagePatch(IWinBuf, &rect, 0, &IWinBuf_addr, (void *)IWinBuf_base);
-    status |= vxCommitImagePatch(derivIWinBuf_x, &rect, 0, &derivIWinBuf_x_addr, (void *)derivIWinBuf_x_base);
-    status |= vxCommitImagePatch(derivIWinBuf_y, &rect, 0, &derivIWinBuf_y_addr, (void *)derivIWinBuf_y_base);
-
-    status |= vxCommitImagePatch(derivIx, &rect, 0, &derivIx_addr, (void *)derivIx_base);
-    status |= vxCommitImagePatch(J, &rect, 0, &J_addr, (void *)J_base);
-    status |= vxCommitImagePatch(derivIy, &rect, 0, &derivIy_addr, (void *)derivIy_base);
-    status |= vxCommitImagePatch(I, &rect, 0, &I_addr, (void *)I_base);
-
-    vxFreeImage((vx_image_t*)IWinBuf);
-    vxFreeImage((vx_image_t*)derivIWinBuf_x);
-    vxFreeImage((vx_image_t*)derivIWinBuf_y);
+    return status;
+}
 
-    vxReleaseImage(&IWinBuf);
-    vxReleaseImage(&derivIWinBuf_x);
-    vxReleaseImage(&derivIWinBuf_y);
+/*! \internal Tracks all points over one level of the pyramids. */
+static vx_status vxTrackOptPyrLKLevel(vx_optpyrlk_data_t *data, vx_pyramid old_pyramid, vx_pyramid new_pyramid,
+                                      vx_uint32 level, vx_size count, vx_size winSize, vx_enum criteria,
+                                      vx_float32 epsilon, vx_uint32 num_iterations)
+{
+    vx_status status = VX_SUCCESS;
+    vx_image images[4];
+    void *base[4] = {NULL, NULL, NULL, NULL};
+    vx_imagepatch_addressing_t addr[4];
+    vx_rectangle_t rect = {0, 0, 0, 0};
+    vx_lk_level_t lk;
+    vx_uint32 i;
+
+    images[0] = vxGetPyramidLevel(old_pyramid, level);
+    images[1] = data->derivIx[level];
+    images[2] = data->derivIy[level];
+    images[3] = vxGetPyramidLevel(new_pyramid, level);
+
+    vxQueryImage(images[0], VX_IMAGE_ATTRIBUTE_WIDTH, &rect.end_x, sizeof(rect.end_x));
+    vxQueryImage(images[0], VX_IMAGE_ATTRIBUTE_HEIGHT, &rect.end_y, sizeof(rect.end_y));
+    for (i = 0; i < dimof(images); i++)
+    {
+        status |= vxMapImagePatchInt(images[i], &rect, 0, &addr[i], &base[i], VX_READ_ONLY);
+    }
 
-    vxReleaseContext(&context_lk_internal);
+    if (status == VX_SUCCESS)
+    {
+        lk.prev = (const vx_uint8 *)base[0];
+        lk.prev_dx = (const vx_int16 *)base[1];
+        lk.prev_dy = (const vx_int16 *)base[2];
+        lk.next = (const vx_uint8 *)base[3];
+        lk.prev_stride = addr[0].stride_y;
+        lk.dx_stride = addr[1].stride_y;
+        lk.dy_stride = addr[2].stride_y;
+        lk.next_stride = addr[3].stride_y;
+        lk.width = rect.end_x;
+        lk.height = rect.end_y;
+        status = vxRunOptPyrLKJobs(data, &lk, count, winSize, criteria, epsilon, num_iterations,
+                                   level == 0 ? vx_true_e : vx_false_e);
+    }
 
-    return VX_SUCCESS;
+    for (i = 0; i < dimof(images); i++)
+    {
+        if (base[i])
+            vxUnmapImagePatchInt(images[i], &rect, VX_READ_ONLY);
+    }
+    vxReleaseImage(&images[0]);
+    vxReleaseImage(&images[3]);
+    return status;
 }
 
-
 static vx_status VX_CALLBACK vxOpticalFlowPyrLKKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
 {
     vx_status status = VX_FAILURE;
     if (num == 10)
     {
-        vx_size maxLevel, list_length,list_indx;
-        vx_int32 level;
         vx_pyramid old_pyramid = (vx_pyramid)parameters[0];
         vx_pyramid new_pyramid = (vx_pyramid)parameters[1];
         vx_array prevPts =  (vx_array)parameters[2];
@@ -369,188 +320,129 @@ static vx_status VX_CALLBACK vxOpticalFlowPyrLKKernel(vx_node node, vx_reference
         vx_scalar num_iterations =  (vx_scalar)parameters[7];
         vx_scalar use_initial_estimate =  (vx_scalar)parameters[8];
         vx_scalar window_dimension =  (vx_scalar)parameters[9];
-        vx_size prevPts_stride = 0;
-        vx_size estimatedPts_stride = 0;
-        vx_size nextPts_stride = 0;
-        void *prevPtsFirstItem;
-        void *initialPtsFirstItem;
-        void *nextPtsFirstItem;
-
-        vx_bool use_initial_estimate_b;
-        vx_float32 pyramid_scale;
-        vx_keypoint_t_optpyrlk_internal *prevPt;
-        vx_keypoint_t *initialPt = NULL;
-        vx_keypoint_t_optpyrlk_internal *nextPt = NULL;
-
-        vxAccessScalarValue(use_initial_estimate,&use_initial_estimate_b);
+        vx_size maxLevel = 0, list_length = 0, list_indx;
+        vx_int32 level;
+        vx_enum prev_type = 0, estimated_type = 0, next_type = 0;
+        vx_size prevPts_stride = 0, estimatedPts_stride = 0;
+        void *prevPtsFirstItem = NULL, *estimatedPtsFirstItem = NULL;
+        vx_enum termination_criteria = VX_TERM_CRITERIA_BOTH;
+        vx_float32 epsilon_f = 0.0f, pyramid_scale = 1.0f, scale;
+        vx_uint32 num_iterations_u = 0;
+        vx_bool use_initial_estimate_b = vx_false_e;
+        vx_size winSize = 0;
+        vx_optpyrlk_data_t *data = NULL;
+
+        vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
         vxQueryPyramid(old_pyramid, VX_PYRAMID_ATTRIBUTE_LEVELS, &maxLevel, sizeof(maxLevel));
-        vxQueryPyramid(old_pyramid, VX_PYRAMID_ATTRIBUTE_SCALE , &pyramid_scale, sizeof(pyramid_scale));
-
-        // the point in the list are in integer coordinates of x,y
-        // The algorithm demand  a float so we convert the point first.
-        vxQueryArray(prevPts, VX_ARRAY_ATTRIBUTE_NUMITEMS, &list_length,sizeof(list_length));
-
-        for( level = maxLevel; level > 0; level-- )
+        if (data == NULL || data->graph == NULL || data->levels != maxLevel)
+            return VX_ERROR_INVALID_NODE;
+
+        vxAccessScalarValue(termination, &termination_criteria);
+        vxAccessScalarValue(epsilon, &epsilon_f);
+        vxAccessScalarValue(num_iterations, &num_iterations_u);
+        vxAccessScalarValue(use_initial_estimate, &use_initial_estimate_b);
+        vxAccessScalarValue(window_dimension, &winSize);
+        vxQueryPyramid(old_pyramid, VX_PYRAMID_ATTRIBUTE_SCALE, &pyramid_scale, sizeof(pyramid_scale));
+        vxQueryArray(prevPts, VX_ARRAY_ATTRIBUTE_NUMITEMS, &list_length, sizeof(list_length));
+        vxQueryArray(prevPts, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &prev_type, sizeof(prev_type));
+        vxQueryArray(estimatedPts, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &estimated_type, sizeof(estimated_type));
+        vxQueryArray(nextPts, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &next_type, sizeof(next_type));
+        if (use_initial_estimate_b)
         {
-            vx_image old_image = vxGetPyramidLevel(old_pyramid, level-1);
-            vx_image new_image = vxGetPyramidLevel(new_pyramid, level-1);
-            vx_rectangle_t rec;
+            vx_size list_length2 = 0;
+            vxQueryArray(estimatedPts, VX_ARRAY_ATTRIBUTE_NUMITEMS, &list_length2, sizeof(list_length2));
+            if (list_length2 != list_length)
+                return VX_ERROR_INVALID_PARAMETERS;
+        }
 
-            prevPtsFirstItem = NULL;
-            vxAccessArrayRange(prevPts, 0, list_length, &prevPts_stride, &prevPtsFirstItem, VX_READ_AND_WRITE);
-            prevPt = (vx_keypoint_t_optpyrlk_internal*)prevPtsFirstItem;
+        status = vxReserveOptPyrLKScratch(data, winSize, list_length);
+        if (status != VX_SUCCESS)
+            return status;
 
-            if (level == maxLevel)
-            {
-                if (use_initial_estimate_b)
-                {
-                    vx_size list_length2 = 0;
-                    vxQueryArray(estimatedPts, VX_ARRAY_ATTRIBUTE_NUMITEMS, &list_length2,sizeof(list_length2));
-                    if (list_length2 != list_length)
-                        return VX_ERROR_INVALID_PARAMETERS;
-
-                    initialPtsFirstItem = NULL;
-                    vxAccessArrayRange(estimatedPts, 0, list_length, &estimatedPts_stride, &initialPtsFirstItem, VX_READ_ONLY);
-                    initialPt = (vx_keypoint_t *)initialPtsFirstItem;
-                }
-                else
-                {
-                    initialPt = (vx_keypoint_t *)prevPt;
-                }
+        /* the gradients of all levels are computed by the graph built in the initializer */
+        status = vxBindOptPyrLKPyramid(data, old_pyramid);
+        if (status == VX_SUCCESS)
+            status = vxProcessGraph(data->graph);
+        if (status != VX_SUCCESS)
+            return status;
 
-                vxTruncateArray(nextPts, 0);
-            }
-            else
-            {
-                nextPtsFirstItem = NULL;
-                vxAccessArrayRange(nextPts, 0, list_length, &nextPts_stride, &nextPtsFirstItem, VX_READ_AND_WRITE);
-                nextPt = (vx_keypoint_t_optpyrlk_internal*)nextPtsFirstItem;
-            }
+        /* the points are tracked in float coordinates of the current level from the top down */
+        scale = (vx_float32)pow(pyramid_scale, (vx_float64)(maxLevel - 1));
+        if (list_length > 0)
+        {
+            status |= vxAccessArrayRange(prevPts, 0, list_length, &prevPts_stride, &prevPtsFirstItem, VX_READ_ONLY);
+            if (use_initial_estimate_b)
+                status |= vxAccessArrayRange(estimatedPts, 0, list_length, &estimatedPts_stride, &estimatedPtsFirstItem, VX_READ_ONLY);
+        }
+        if (status != VX_SUCCESS)
+            return status;
+        for (list_indx = 0; list_indx < list_length; list_indx++)
+        {
+            vx_lk_point_t *pt = &data->points[list_indx];
+            vx_float32 x, y;
+
+            vxGetOptPyrLKCoordinates(prevPtsFirstItem, list_indx, prevPts_stride, prev_type, &x, &y);
+            pt->prev_x = x * scale;
+            pt->prev_y = y * scale;
+            if (use_initial_estimate_b)
+                vxGetOptPyrLKCoordinates(estimatedPtsFirstItem, list_indx, estimatedPts_stride, estimated_type, &x, &y);
+            pt->next_x = x * scale;
+            pt->next_y = y * scale;
+            pt->status = 1;
+            pt->error = 0.0f;
+        }
+        if (use_initial_estimate_b && list_length > 0)
+            vxCommitArrayRange(estimatedPts, 0, 0, estimatedPtsFirstItem);
 
-            for(list_indx=0;list_indx<list_length;list_indx++)
+        for (level = (vx_int32)maxLevel - 1; level >= 0 && status == VX_SUCCESS; level--)
+        {
+            if (level != (vx_int32)maxLevel - 1)
             {
-                if(level == maxLevel)
+                for (list_indx = 0; list_indx < list_length; list_indx++)
                 {
-                    (prevPt)->x = (((vx_keypoint_t*)prevPt))->x *(float)((pow(pyramid_scale,level-1)));
-                    (prevPt)->y = (((vx_keypoint_t*)prevPt))->y *(float)((pow(pyramid_scale,level-1)));
-                    if (use_initial_estimate_b)
-                    {
-                        vx_keypoint_t_optpyrlk_internal keypoint;
-                        keypoint.x = (initialPt)->x*(float)((pow(pyramid_scale,level-1)));
-                        keypoint.y = (initialPt)->y*(float)((pow(pyramid_scale,level-1)));
-                        keypoint.strength = (initialPt)->strength;
-                        keypoint.tracking_status = (initialPt)->tracking_status;
-                        keypoint.error = (initialPt)->error;
-                        status |= vxAddArrayItems(nextPts, 1, &keypoint, 0);
-                    }
-                    else
-                    {
-                        vx_keypoint_t_optpyrlk_internal keypoint;
-                        keypoint.x = (prevPt)->x;
-                        keypoint.y = (prevPt)->y;
-                        keypoint.strength = 0;
-                        keypoint.tracking_status = 1;
-                        keypoint.error = 10000;
-                        status |= vxAddArrayItems(nextPts, 1, &keypoint, 0);
-                    }
+                    vx_lk_point_t *pt = &data->points[list_indx];
+                    pt->prev_x /= pyramid_scale;
+                    pt->prev_y /= pyramid_scale;
+                    pt->next_x /= pyramid_scale;
+                    pt->next_y /= pyramid_scale;
                 }
-                else
-                {
-                    (prevPt)->x = (prevPt)->x *(1.0f/pyramid_scale);
-                    (prevPt)->y = (prevPt)->y *(1.0f/pyramid_scale);
-                    (nextPt)->x = (nextPt)->x *(1.0f/pyramid_scale);
-                    (nextPt)->y = (nextPt)->y *(1.0f/pyramid_scale);
-                    nextPt++;
-                }
-                prevPt++;
-                initialPt++;
-
             }
-            vxCommitArrayRange(prevPts, 0, list_length,prevPtsFirstItem);
+            status = vxTrackOptPyrLKLevel(data, old_pyramid, new_pyramid, (vx_uint32)level, list_length,
+                                          winSize, termination_criteria, epsilon_f, num_iterations_u);
+        }
 
-            if (level !=maxLevel)
-            {
-                vxCommitArrayRange(nextPts, 0, list_length, nextPtsFirstItem);
-            }
-            else if (use_initial_estimate_b)
+        /* the sub-pixel positions are only kept by VX_TYPE_KEYPOINT_F32 outputs */
+        for (list_indx = 0; list_indx < list_length; list_indx++)
+        {
+            const vx_keypoint_f32_t *src = &vxArrayItem(vx_keypoint_f32_t, prevPtsFirstItem, list_indx, prevPts_stride);
+            vx_keypoint_f32_t *item = &data->items[list_indx];
+            vx_lk_point_t *pt = &data->points[list_indx];
+
+            if (next_type == VX_TYPE_KEYPOINT_F32)
             {
-                vxCommitArrayRange(estimatedPts, 0, list_length,initialPtsFirstItem);
+                item->x = pt->next_x;
+                item->y = pt->next_y;
             }
-
-            vxGetValidRegionImage(old_image,&rec);
-            // printf("%ux%u - %ux%u\n", rec.start_x, rec.start_y, rec.end_x, rec.end_y);
-
+            else
             {
-                vx_context context_scharr = vxCreateContext();
-                if(context_scharr)
-                {
-                    vx_uint32 width,height,n;
-
-                    width = rec.end_x - rec.start_x;
-                    height = rec.end_y - rec.start_y;
-
-                    vx_image shar_images[] = {
-                            old_image,     // index 0: Input 1
-                            vxCreateImage(context_scharr, width, height, VX_DF_IMAGE_S16),     // index 1: Input 2
-                            vxCreateImage(context_scharr, width, height, VX_DF_IMAGE_S16),       // index 2: Get Y channel
-                    };
-                    vx_graph graph_scharr = vxCreateGraph(context_scharr);
-                    vx_status extras_status = vxLoadKernels(context_scharr, "openvx-extras");
-                    if (graph_scharr && extras_status == VX_SUCCESS)
-                    {
-                        vx_node scharr_nodes[] = {
-                            vxScharr3x3Node(graph_scharr, shar_images[0], shar_images[1], shar_images[2]),
-                        };
-                        status = vxVerifyGraph(graph_scharr);
-                        if (status == VX_SUCCESS)
-                        {
-
-                            status = vxProcessGraph(graph_scharr);
-
-                            status |= LKTracker(old_image, shar_images[1], shar_images[2],
-                                        new_image, prevPts, nextPts,
-                                        window_dimension, termination, level-1,
-                                        epsilon,num_iterations);
-                        }
-                        for (n = 0; n < dimof(scharr_nodes); n++)
-                        {
-                            vxReleaseNode(&scharr_nodes[n]);
-                        }
-                        vxReleaseGraph(&graph_scharr);
-                    }
-                    for (n = 1; n < dimof(shar_images); n++)
-                    {
-                        vxReleaseImage(&shar_images[n]);
-                    }
-                    vxReleaseContext(&context_scharr);
-
-                }
+                vx_keypoint_t *ikey = (vx_keypoint_t *)item;
+                ikey->x = (vx_int32)floorf(pt->next_x + 0.5f);
+                ikey->y = (vx_int32)floorf(pt->next_y + 0.5f);
             }
-
-            vxReleaseImage(&new_image);
-            vxReleaseImage(&old_image);
+            /* both keypoint types share the layout of the remaining fields */
+            item->strength = src->strength;
+            item->scale = src->scale;
+            item->orientation = src->orientation;
+            item->tracking_status = pt->status;
+            item->error = pt->error;
         }
+        if (list_length > 0)
+            vxCommitArrayRange(prevPts, 0, 0, prevPtsFirstItem);
 
-        nextPtsFirstItem = NULL;
-        vxAccessArrayRange(nextPts, 0, list_length, &nextPts_stride, &nextPtsFirstItem, VX_READ_AND_WRITE);
-        nextPt = (vx_keypoint_t_optpyrlk_internal*)nextPtsFirstItem;
-
-        prevPt = (vx_keypoint_t_optpyrlk_internal*)prevPtsFirstItem;
-        initialPt = (vx_keypoint_t *)initialPtsFirstItem;
-        nextPt = (vx_keypoint_t_optpyrlk_internal*)nextPtsFirstItem;
-        for(list_indx=0;list_indx<list_length;list_indx++)
-        {
-            (((vx_keypoint_t*)nextPt))->x = (vx_int32)((nextPt)->x);
-            (((vx_keypoint_t*)nextPt))->y = (vx_int32)((nextPt)->y);
-            (((vx_keypoint_t*)prevPt))->x = (vx_int32)((prevPt)->x);
-            (((vx_keypoint_t*)prevPt))->y = (vx_int32)((prevPt)->y);
-            nextPt++;
-            prevPt++;
-        }
-
-        vxCommitArrayRange(nextPts, 0, list_length,nextPtsFirstItem);
-
-       return status;
+        status |= vxTruncateArray(nextPts, 0);
+        if (list_length > 0)
+            status |= vxAddArrayItems(nextPts, list_length, data->items, sizeof(vx_keypoint_f32_t));
+        return status;
     }
     return VX_ERROR_INVALID_PARAMETERS;
 }
@@ -589,7 +481,7 @@ static vx_status VX_CALLBACK vxOpticalFlowPyrLKInputValidator(vx_node node, vx_u
             {
                 vx_enum item_type = 0;
                 vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
-                if (item_type == VX_TYPE_KEYPOINT)
+                if (item_type == VX_TYPE_KEYPOINT || item_type == VX_TYPE_KEYPOINT_F32)
                 {
                     status = VX_SUCCESS;
                 }
@@ -726,19 +618,26 @@ static vx_status VX_CALLBACK vxOpticalFlowPyrLKOutputValidator(vx_node node, vx_
     vx_status status = VX_ERROR_INVALID_PARAMETERS;
     if (index == 4)
     {
-        vx_array arr = 0;
+        vx_array arr = 0, out = 0;
         vx_size capacity = 0;
+        vx_enum item_type = 0;
         vx_parameter param = vxGetParameterByIndex(node, 2);
+        vx_parameter out_param = vxGetParameterByIndex(node, index);
         vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &arr, sizeof(arr));
         vxQueryArray(arr, VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+        /* sub-pixel output is given if the output array asks for it */
+        vxQueryParameter(out_param, VX_PARAMETER_ATTRIBUTE_REF, &out, sizeof(out));
+        vxQueryArray(out, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
 
         ptr->type = VX_TYPE_ARRAY;
-        ptr->dim.array.item_type = VX_TYPE_KEYPOINT;
+        ptr->dim.array.item_type = (item_type == VX_TYPE_KEYPOINT_F32 ? VX_TYPE_KEYPOINT_F32 : VX_TYPE_KEYPOINT);
         ptr->dim.array.capacity = capacity;
 
         status = VX_SUCCESS;
 
+        vxReleaseArray(&out);
         vxReleaseArray(&arr);
+        vxReleaseParameter(&out_param);
         vxReleaseParameter(&param);
     }
     return status;
@@ -757,6 +656,173 @@ static vx_param_description_t optpyrlk_kernel_params[] = {
     {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
 };
 
+/*! \internal Trades the external reference of an object created by the
+ * initializer for an internal one, see \ref vxReleaseOptPyrLKData.
+ */
+static vx_status vxHoldOptPyrLKReference(vx_reference *ref)
+{
+    vx_status status = vxGetStatus(*ref);
+    if (status == VX_SUCCESS)
+    {
+        vxIncrementReference(*ref, VX_INTERNAL);
+        vxDecrementReference(*ref, VX_EXTERNAL);
+    }
+    else
+    {
+        *ref = NULL;
+    }
+    return status;
+}
+
+/*! \internal The Scharr node leaves the border of the gradients undefined but
+ * the windows of points close to the edge read it, so it's cleared once here and
+ * keeps being zero as the node never writes it.
+ */
+static vx_status vxClearOptPyrLKImage(vx_image image)
+{
+    vx_status status = VX_SUCCESS;
+    vx_rectangle_t rect = {0, 0, 0, 0};
+    vx_imagepatch_addressing_t addr;
+    void *base = NULL;
+    vx_uint32 y;
+
+    vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, &rect.end_x, sizeof(rect.end_x));
+    vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, &rect.end_y, sizeof(rect.end_y));
+    status = vxAccessImagePatch(image, &rect, 0, &addr, &base, VX_WRITE_ONLY);
+    if (status == VX_SUCCESS)
+    {
+        for (y = 0; y < addr.dim_y; y++)
+            memset(vxFormatImagePatchAddress2d(base, 0, y, &addr), 0, addr.dim_x * addr.stride_x);
+        status = vxCommitImagePatch(image, &rect, 0, &addr, base);
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK vxOpticalFlowPyrLKInitializer(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    if (num == dimof(optpyrlk_kernel_params))
+    {
+        vx_pyramid old_pyramid = (vx_pyramid)parameters[0];
+        vx_scalar window_dimension = (vx_scalar)parameters[9];
+        vx_context context = vxGetContext((vx_reference)node);
+        vx_optpyrlk_data_t *data = NULL;
+        vx_size lev, levels = 0, winSize = 0;
+        vx_uint32 numThreads = 0;
+
+        vxQueryPyramid(old_pyramid, VX_PYRAMID_ATTRIBUTE_LEVELS, &levels, sizeof(levels));
+        if (levels > VX_OPTPYRLK_MAX_LEVELS)
+        {
+            return VX_ERROR_INVALID_PARAMETERS;
+        }
+        status = vxLoadKernels(context, "openvx-extras");
+        if (status != VX_SUCCESS)
+        {
+            return status;
+        }
+
+        /* a graph which is verified again keeps the local data of its nodes */
+        vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+        if (data)
+        {
+            vxReleaseOptPyrLKData(data);
+        }
+        else
+        {
+            vx_size size = sizeof(vx_optpyrlk_data_t);
+            data = (vx_optpyrlk_data_t *)calloc(1, size);
+            if (data == NULL)
+            {
+                return VX_ERROR_NO_MEMORY;
+            }
+            status = vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size));
+            status |= vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+            if (status != VX_SUCCESS)
+            {
+                free(data);
+                return status;
+            }
+        }
+
+        vxQueryNode(node, VX_NODE_ATTRIBUTE_THREADS, &numThreads, sizeof(numThreads));
+        if (numThreads == 0)
+            numThreads = vxGetNumCores();
+        if (numThreads > VX_OPTPYRLK_MAX_JOBS)
+            numThreads = VX_OPTPYRLK_MAX_JOBS;
+        data->numThreads = numThreads;
+        if (numThreads > 1)
+        {
+            data->workers = vxCreateThreadpool(VX_THREADPOOL_ROUND_ROBIN, numThreads - 1, VX_OPTPYRLK_MAX_JOBS,
+                                               sizeof(vx_value_set_t), vxOptPyrLKWorker, data);
+            if (data->workers == NULL)
+            {
+                vxReleaseOptPyrLKData(data);
+                return VX_ERROR_NO_RESOURCES;
+            }
+        }
+
+        vxAccessScalarValue(window_dimension, &winSize);
+        status = vxReserveOptPyrLKScratch(data, winSize, 0);
+        if (status == VX_SUCCESS)
+        {
+            data->graph = vxCreateGraph(context);
+            status = vxHoldOptPyrLKReference((vx_reference *)&data->graph);
+        }
+        for (lev = 0; (lev < levels) && (status == VX_SUCCESS); lev++)
+        {
+            vx_image level = vxGetPyramidLevel(old_pyramid, (vx_uint32)lev);
+            vx_uint32 width = 0, height = 0;
+
+            vxQueryImage(level, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width));
+            vxQueryImage(level, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+            data->levels = lev + 1;
+            data->derivIx[lev] = vxCreateImage(context, width, height, VX_DF_IMAGE_S16);
+            data->derivIy[lev] = vxCreateImage(context, width, height, VX_DF_IMAGE_S16);
+            status |= vxHoldOptPyrLKReference((vx_reference *)&data->derivIx[lev]);
+            status |= vxHoldOptPyrLKReference((vx_reference *)&data->derivIy[lev]);
+            if (status == VX_SUCCESS)
+            {
+                status = vxClearOptPyrLKImage(data->derivIx[lev]);
+                status |= vxClearOptPyrLKImage(data->derivIy[lev]);
+            }
+            if (status == VX_SUCCESS)
+            {
+                data->nodes[lev] = vxScharr3x3Node(data->graph, level, data->derivIx[lev], data->derivIy[lev]);
+                status = vxHoldOptPyrLKReference((vx_reference *)&data->nodes[lev]);
+            }
+            vxReleaseImage(&level);
+        }
+        if (status == VX_SUCCESS)
+        {
+            vxIncrementReference((vx_reference)old_pyramid, VX_INTERNAL);
+            data->pyramid = old_pyramid;
+            status = vxVerifyGraph(data->graph);
+        }
+        if (status != VX_SUCCESS)
+        {
+            vxReleaseOptPyrLKData(data);
+        }
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK vxOpticalFlowPyrLKDeinitializer(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    if (num == dimof(optpyrlk_kernel_params))
+    {
+        vx_optpyrlk_data_t *data = NULL;
+        vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+        /* the structure itself is freed with the node */
+        if (data)
+        {
+            vxReleaseOptPyrLKData(data);
+        }
+        status = VX_SUCCESS;
+    }
+    return status;
+}
+
 #ifdef __cplusplus
 extern "C"
 #endif
@@ -767,4 +833,6 @@ vx_kernel_description_t optpyrlk_kernel = {
     optpyrlk_kernel_params, dimof(optpyrlk_kernel_params),
     vxOpticalFlowPyrLKInputValidator,
     vxOpticalFlowPyrLKOutputValidator,
+    vxOpticalFlowPyrLKInitializer,
+    vxOpticalFlowPyrLKDeinitializer,
 };
@@ -33,6 +33,7 @@
 #include <VX/vx_helper.h>
 
 #include <vx_internal.h>
+#include <c_model.h>
 #include <math.h>
 
 
@@ -53,13 +54,49 @@ static vx_param_description_t pyramid_kernel_params[] = {
 
 /*! \note Look at \ref vxPyramidNode to see how this pyramid construction works */
 
+/*! \internal Builds a half scale pyramid level by level, each level straight from
+ * the one above it. Level 0 is copied while the first decimation reads the input.
+ */
+static vx_status vxHalfScalePyramid(vx_node node, vx_image input, vx_pyramid gaussian)
+{
+    vx_status status = VX_SUCCESS;
+    vx_border_mode_t border;
+    vx_size lev, levels = 0;
+    void *scratch = NULL;
+    vx_image src = input;
+    vx_image level0 = vxGetPyramidLevel(gaussian, 0);
+
+    status |= vxQueryNode(node, VX_NODE_ATTRIBUTE_BORDER_MODE, &border, sizeof(border));
+    status |= vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &scratch, sizeof(scratch));
+    status |= vxQueryPyramid(gaussian, VX_PYRAMID_ATTRIBUTE_LEVELS, &levels, sizeof(levels));
+    if (status == VX_SUCCESS && scratch == NULL)
+        status = VX_ERROR_INVALID_NODE;
+    if (status == VX_SUCCESS && levels == 1)
+        status = vxHalfScaleGaussian(input, NULL, level0, &border, scratch);
+    for (lev = 1; lev < levels && status == VX_SUCCESS; lev++)
+    {
+        vx_image dst = vxGetPyramidLevel(gaussian, (vx_uint32)lev);
+        status = vxHalfScaleGaussian(src, dst, (lev == 1 ? level0 : NULL), &border, scratch);
+        if (src != input)
+            vxReleaseImage(&src);
+        src = dst;
+    }
+    if (src != input)
+        vxReleaseImage(&src);
+    vxReleaseImage(&level0);
+    return status;
+}
+
 static vx_status VX_CALLBACK vxPyramidKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
 {
     vx_status status = VX_FAILURE;
     if (num == dimof(pyramid_kernel_params))
     {
         vx_graph graph = vxGetChildGraphOfNode(node);
-        status = vxProcessGraph(graph);
+        if (graph)
+            status = vxProcessGraph(graph);
+        else
+            status = vxHalfScalePyramid(node, (vx_image)parameters[0], (vx_pyramid)parameters[1]);
     }
     return status;
 }
@@ -99,13 +136,39 @@ static vx_status VX_CALLBACK vxPyramidInitializer(vx_node node, vx_reference *pa
         vx_image input = (vx_image)parameters[0];
         vx_pyramid gaussian = (vx_pyramid)parameters[1];
         vx_context context = vxGetContext((vx_reference)node);
-        vx_graph graph = vxCreateGraph(context);
+        vx_graph graph = 0;
         vx_enum interp = VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR;
+        vx_float32 scale = 0.0f;
+
+        vxQueryPyramid(gaussian, VX_PYRAMID_ATTRIBUTE_SCALE, &scale, sizeof(scale));
+        if (scale == VX_SCALE_PYRAMID_HALF)
+        {
+            /* no child graph, the kernel only needs a row of scratch memory */
+            vx_uint32 width = 0;
+            vx_size size = 0, old_size = 0;
+            void *ptr = NULL;
+            vxQueryImage(input, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width));
+            vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &old_size, sizeof(old_size));
+            vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &ptr, sizeof(ptr));
+            size = C_HALF_SCALE_GAUSSIAN_SCRATCH(width);
+            if (ptr && old_size >= size)
+            {
+                return VX_SUCCESS;
+            }
+            /* the graph allocates the local data once the initializer returns */
+            free(ptr);
+            ptr = NULL;
+            status = vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &ptr, sizeof(ptr));
+            status |= vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size));
+            return status;
+        }
+
         status = vxLoadKernels(context, "openvx-debug");
         if (status != VX_SUCCESS)
         {
             return status;
         }
+        graph = vxCreateGraph(context);
 
         status = vxQueryNode(node, VX_NODE_ATTRIBUTE_BORDER_MODE, &border, sizeof(border));
         if (status != VX_SUCCESS)
@@ -157,9 +220,12 @@ static vx_status VX_CALLBACK vxPyramidDeinitializer(vx_node node, vx_reference *
     if (num == dimof(pyramid_kernel_params))
     {
         vx_graph graph = vxGetChildGraphOfNode(node);
-        vxReleaseGraph(&graph);
-        /* set graph to "null" */
-        vxSetChildGraphOfNode(node, 0);
+        if (graph)
+        {
+            vxReleaseGraph(&graph);
+            /* set graph to "null" */
+            vxSetChildGraphOfNode(node, 0);
+        }
         status = VX_SUCCESS;
     }
     return status;
@@ -1,6 +1,6 @@
 #include "add_kernels.h"
 
-vx_node vxRGBtoGrayNode(vx_graph graph, vx_image input, vx_image output)
+vx_node vxRGBtoGrayNode(vx_graph graph, vx_image input, vx_scalar order, vx_image output)
 {
     vx_node node = 0;
     vx_context context = vxGetContext((vx_reference)graph);
@@ -9,6 +9,7 @@ vx_node vxRGBtoGrayNode(vx_graph graph, vx_image input, vx_image output)
     {
         vx_reference params[] = {
             (vx_reference)input,
+            (vx_reference)order,
             (vx_reference)output,
         };
         node = vxCreateNodeByStructure(graph,
@@ -19,7 +20,8 @@ vx_node vxRGBtoGrayNode(vx_graph graph, vx_image input, vx_image output)
     return node;
 }
 
-vx_node vxFindWarpNode(vx_graph graph, vx_array def_pnts, vx_array moved_pnts, vx_matrix matr)
+vx_node vxFindWarpNode(vx_graph graph, vx_array def_pnts, vx_array moved_pnts, vx_scalar model,
+                       vx_scalar max_iter, vx_scalar threshold, vx_matrix matr)
 {
     vx_node node = 0;
     vx_context context = vxGetContext((vx_reference)graph);
@@ -29,6 +31,9 @@ vx_node vxFindWarpNode(vx_graph graph, vx_array def_pnts, vx_array moved_pnts, v
         vx_reference params[] = {
             (vx_reference)def_pnts,
             (vx_reference)moved_pnts,
+            (vx_reference)model,
+            (vx_reference)max_iter,
+            (vx_reference)threshold,
             (vx_reference)matr,
         };
         node = vxCreateNodeByStructure(graph,
@@ -166,3 +171,46 @@ vx_node vxMatrixModifyNode(vx_graph graph, vx_matrix input, vx_scalar width, vx_
     return node;
 }
 
+vx_node vxWarpCutScaleRGBNode(vx_graph graph, vx_image input, vx_matrix matr, vx_scalar inter, vx_scalar scale, vx_image output)
+{
+    vx_node node = 0;
+    vx_context context = vxGetContext((vx_reference)graph);
+    vx_status status = vxLoadKernels(context, VX_ADD_LIBRARY_NAME);
+    if (status == VX_SUCCESS)
+    {
+        vx_reference params[] = {
+            (vx_reference)input,
+            (vx_reference)matr,
+            (vx_reference)inter,
+            (vx_reference)scale,
+            (vx_reference)output
+        };
+        node = vxCreateNodeByStructure(graph,
+                                       VX_ADD_KERNEL_WARP_CUT_SCALE_RGB,
+                                       params,
+                                       dimof(params));
+    }
+    return node;
+}
+
+
+vx_node vxSmoothTrajectoryNode(vx_graph graph, vx_delay matrices, vx_scalar first, vx_array coeffs, vx_matrix output)
+{
+    vx_node node = 0;
+    vx_context context = vxGetContext((vx_reference)graph);
+    vx_status status = vxLoadKernels(context, VX_ADD_LIBRARY_NAME);
+    if (status == VX_SUCCESS)
+    {
+        vx_reference params[] = {
+            (vx_reference)matrices,
+            (vx_reference)first,
+            (vx_reference)coeffs,
+            (vx_reference)output
+        };
+        node = vxCreateNodeByStructure(graph,
+                                       VX_ADD_KERNEL_SMOOTH_TRAJECTORY,
+                                       params,
+                                       dimof(params));
+    }
+    return node;
+}
@@ -21,6 +21,8 @@
 #define VX_ADD_KERNEL_NAME_MATRIX_INVERT        "org.openvx.add.matrix_invert"
 #define VX_ADD_KERNEL_NAME_CUT                  "org.openvx.add.cut"
 #define VX_ADD_KERNEL_NAME_MATRIX_MODIFY        "org.openvx.add.matrix_modify"
+#define VX_ADD_KERNEL_NAME_WARP_CUT_SCALE_RGB   "org.openvx.add.warp_cut_scale_rgb"
+#define VX_ADD_KERNEL_NAME_SMOOTH_TRAJECTORY    "org.openvx.add.smooth_trajectory"
 
 enum vx_add_kernel_e {
     VX_ADD_KERNEL_RGB_TO_GRAY          = VX_KERNEL_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x0,
@@ -31,6 +33,23 @@ enum vx_add_kernel_e {
     VX_ADD_KERNEL_MATRIX_INVERT        = VX_KERNEL_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x5,
     VX_ADD_KERNEL_CUT                  = VX_KERNEL_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x6,
     VX_ADD_KERNEL_MATRIX_MODIFY        = VX_KERNEL_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x7,
+    VX_ADD_KERNEL_WARP_CUT_SCALE_RGB   = VX_KERNEL_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x8,
+    VX_ADD_KERNEL_SMOOTH_TRAJECTORY    = VX_KERNEL_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x9,
+};
+
+/* Channel order of the pixels of VX_DF_IMAGE_RGB images, OpenCV frames are BGR.
+ * The warps move whole pixels, only the gray conversion depends on it. */
+enum vx_add_channel_order_e {
+    VX_ADD_CHANNEL_ORDER_RGB = VX_ENUM_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x0,
+    VX_ADD_CHANNEL_ORDER_BGR = VX_ENUM_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x1,
+};
+
+/* Motion models of vxFindWarpNode, from the cheapest */
+enum vx_add_motion_model_e {
+    VX_ADD_MOTION_MODEL_TRANSLATION = VX_ENUM_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x2, /* 2 dof */
+    VX_ADD_MOTION_MODEL_SIMILARITY  = VX_ENUM_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x3, /* 4 dof, rotation and scale */
+    VX_ADD_MOTION_MODEL_AFFINE      = VX_ENUM_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x4, /* 6 dof */
+    VX_ADD_MOTION_MODEL_HOMOGRAPHY  = VX_ENUM_BASE(VX_ID_INTEL, VX_ADD_LIBRARY) + 0x5, /* 8 dof */
 };
 
 
@@ -38,14 +57,27 @@ enum vx_add_kernel_e {
 extern "C" {
 #endif
 
-vx_node vxRGBtoGrayNode(vx_graph graph, vx_image input, vx_image output);
-vx_node vxFindWarpNode(vx_graph graph, vx_array def_pnts, vx_array moved_pnts, vx_matrix matr);
+/* order is an optional VX_TYPE_ENUM scalar of vx_add_channel_order_e, RGB by default */
+vx_node vxRGBtoGrayNode(vx_graph graph, vx_image input, vx_scalar order, vx_image output);
+/* Finds the motion from def_pnts to moved_pnts with RANSAC. model is an optional VX_TYPE_ENUM scalar of
+ * vx_add_motion_model_e (homography by default), max_iter an optional VX_TYPE_UINT32 scalar with the
+ * iteration budget (2000 by default) and threshold an optional VX_TYPE_FLOAT32 scalar with the largest
+ * distance of an inlier in pixels (3 by default) */
+vx_node vxFindWarpNode(vx_graph graph, vx_array def_pnts, vx_array moved_pnts, vx_scalar model,
+                       vx_scalar max_iter, vx_scalar threshold, vx_matrix matr);
 vx_node vxWarpPerspectiveRGBNode(vx_graph graph, vx_image input, vx_matrix matr, vx_scalar inter, vx_image output);
 vx_node vxMatrixMultiplyNode(vx_graph graph, vx_matrix input1, vx_matrix input2, vx_scalar coeff, vx_matrix output);
 vx_node vxMatrixAddNode(vx_graph graph, vx_matrix input1, vx_matrix input2, vx_scalar coeff, vx_matrix output);
 vx_node vxMatrixInvertNode(vx_graph graph, vx_matrix input, vx_matrix output);
 vx_node vxCutNode(vx_graph graph, vx_image input, vx_scalar left, vx_scalar right, vx_scalar top, vx_scalar bottom, vx_image output);
 vx_node vxMatrixModifyNode(vx_graph graph, vx_matrix input, vx_scalar width, vx_scalar height, vx_scalar scale, vx_matrix output);
+/* Warps input by matr, crops the centered scale part of the warped image and rescales it to output in one pass */
+vx_node vxWarpCutScaleRGBNode(vx_graph graph, vx_image input, vx_matrix matr, vx_scalar inter, vx_scalar scale, vx_image output);
+/* Weighted sum of the transforms from the center of a window of 2 * radius slots of the matrices delay
+ * to each of its frames. first is an optional VX_TYPE_UINT32 scalar with the newest slot of the window
+ * (0 by default), coeffs a VX_TYPE_FLOAT32 array of 2 * radius + 1 weights from the newest frame.
+ * The node keeps the accumulated window between runs and only takes in the matrices aged into it */
+vx_node vxSmoothTrajectoryNode(vx_graph graph, vx_delay matrices, vx_scalar first, vx_array coeffs, vx_matrix output);
 
 #ifdef __cplusplus
 }
@@ -1,4 +1,5 @@
 #include "add_kernels.h"
+#include "vx_rows.h"
 
 extern vx_kernel_description_t add_rgb_to_gray_kernel;
 extern vx_kernel_description_t add_find_warp_kernel;
@@ -8,6 +9,8 @@ extern vx_kernel_description_t add_matrix_add_kernel;
 extern vx_kernel_description_t add_matrix_invert_kernel;
 extern vx_kernel_description_t add_cut_kernel;
 extern vx_kernel_description_t add_modify_matrix_kernel;
+extern vx_kernel_description_t add_warp_cut_scale_rgb_kernel;
+extern vx_kernel_description_t add_smooth_trajectory_kernel;
 
 
 static vx_kernel_description_t* add_kernels[] = {
@@ -19,14 +22,33 @@ static vx_kernel_description_t* add_kernels[] = {
     &add_matrix_invert_kernel,
     &add_cut_kernel,
     &add_modify_matrix_kernel,
+    &add_warp_cut_scale_rgb_kernel,
+    &add_smooth_trajectory_kernel,
 };
 
 static vx_uint32 num_add_kernels = dimof(add_kernels);
 
+extern vx_status VX_CALLBACK vxCutInputRows(vx_node node, const vx_reference parameters[], vx_uint32 index,
+                                            vx_uint32 start_y, vx_uint32 end_y,
+                                            vx_uint32 *in_start_y, vx_uint32 *in_end_y);
+extern vx_status VX_CALLBACK vxWarpPerspectiveRGBInputRows(vx_node node, const vx_reference parameters[], vx_uint32 index,
+                                                           vx_uint32 start_y, vx_uint32 end_y,
+                                                           vx_uint32 *in_start_y, vx_uint32 *in_end_y);
+
+/* The kernels which can run in the bands of a tiled graph, see vx_rows.h */
+static struct {
+    vx_enum enumeration;
+    vx_kernel_input_rows_f input_rows;
+} add_band_kernels[] = {
+    {VX_ADD_KERNEL_RGB_TO_GRAY,          vxRowsSameInputRows},
+    {VX_ADD_KERNEL_CUT,                  vxCutInputRows},
+    {VX_ADD_KERNEL_WARP_PERSPECTIVE_RGB, vxWarpPerspectiveRGBInputRows},
+};
+
 vx_status vxPublishKernels(vx_context context)
 {
     vx_status status = VX_SUCCESS;
-    int i = 0, p = 0;
+    int i = 0, p = 0, b = 0;
     vx_kernel_description_t* kernelDesc = NULL;
     vx_kernel kernel = NULL;
 
@@ -54,6 +76,13 @@ vx_status vxPublishKernels(vx_context context)
                 }
             }
 
+            for (b = 0; b < dimof(add_band_kernels) && status == VX_SUCCESS; b++)
+            {
+                if (add_band_kernels[b].enumeration == kernelDesc->enumeration)
+                    status = vxSetKernelAttribute(kernel, VX_KERNEL_ATTRIBUTE_INPUT_ROWS,
+                                                  &add_band_kernels[b].input_rows, sizeof(vx_kernel_input_rows_f));
+            }
+
             if (status == VX_SUCCESS)
             {
                 status = vxFinalizeKernel(kernel);
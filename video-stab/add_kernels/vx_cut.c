@@ -1,5 +1,27 @@
 #include "add_kernels.h"
 #include "vx_internal.h"
+#include "vx_rows.h"
+
+typedef struct _cut_t {
+    void *src_buff, *dst_buff;
+    vx_imagepatch_addressing_t src_addr, dst_addr;
+} cut_t;
+
+static vx_status cut_rows(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    cut_t *cut = (cut_t *)arg;
+    vx_uint32 x, y;
+    for (y = start_y; y < end_y; y++)
+    {
+        for (x = 0; x < cut->src_addr.dim_x; x++)
+        {
+            vx_uint8* dst = (vx_uint8*)vxFormatImagePatchAddress2d(cut->dst_buff, x, y, &cut->dst_addr);
+            vx_uint8* src = (vx_uint8*)vxFormatImagePatchAddress2d(cut->src_buff, x, y, &cut->src_addr);
+            memcpy(dst, src, 3);
+        }
+    }
+    return VX_SUCCESS;
+}
 
 static vx_status VX_CALLBACK vxCutKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
 {
@@ -9,10 +31,9 @@ static vx_status VX_CALLBACK vxCutKernel(vx_node node, vx_reference *parameters,
     vx_scalar scalar[4];
     vx_uint32 pnts[4];
     vx_rectangle_t rect, dst_rect;
-    vx_imagepatch_addressing_t dst_addr, src_addr;
-    void *dst_buff = NULL, *src_buff = NULL;
+    cut_t cut = {NULL, NULL};
 
-    int i, x, y;
+    int i;
     for(i = 0; i < 4; i++)
     {
        scalar[i] = (vx_scalar)parameters[i + 1];
@@ -22,22 +43,30 @@ static vx_status VX_CALLBACK vxCutKernel(vx_node node, vx_reference *parameters,
     rect.start_x = pnts[0]; rect.start_y = pnts[1];
     rect.end_x = pnts[2]; rect.end_y = pnts[3];
     status |= vxGetValidRegionImage(output, &dst_rect);
-    status |= vxAccessImagePatch(input, &rect, 0, &src_addr, (void **)&src_buff, VX_READ_AND_WRITE);
-    status |= vxAccessImagePatch(output, &dst_rect, 0, &dst_addr, (void **)&dst_buff, VX_READ_AND_WRITE);
-    for (y = 0; y < src_addr.dim_y; y++)
+    status |= vxMapImagePatchInt(input, &rect, 0, &cut.src_addr, &cut.src_buff, VX_READ_ONLY);
+    status |= vxMapImagePatchInt(output, &dst_rect, 0, &cut.dst_addr, &cut.dst_buff, VX_WRITE_ONLY);
+    if (status == VX_SUCCESS)
     {
-        for (x = 0; x < src_addr.dim_x; x++)
-        {
-            vx_uint8* dst = (vx_uint8*)vxFormatImagePatchAddress2d(dst_buff, x, y, &dst_addr);
-            vx_uint8* src = (vx_uint8*)vxFormatImagePatchAddress2d(src_buff, x, y, &src_addr);
-            memcpy(dst, src, 3);
-        }
+        status = vxRowsParallelFor(node, cut.src_addr.dim_y, cut_rows, &cut);
+        vxUnmapImagePatchInt(output, &dst_rect, VX_WRITE_ONLY);
     }
-    status |= vxCommitImagePatch(input, NULL, 0, &src_addr, src_buff);
-    status |= vxCommitImagePatch(output, &dst_rect, 0, &dst_addr, dst_buff);
     return status;
 }
 
+/* The cut reads the same rows of its rectangle of the input */
+vx_status VX_CALLBACK vxCutInputRows(vx_node node, const vx_reference parameters[], vx_uint32 index,
+                                     vx_uint32 start_y, vx_uint32 end_y,
+                                     vx_uint32 *in_start_y, vx_uint32 *in_end_y)
+{
+    vx_status status = VX_SUCCESS;
+    vx_uint32 offset = 0, height = 0;
+    status |= vxAccessScalarValue((vx_scalar)parameters[2], &offset);
+    status |= vxCommitScalarValue((vx_scalar)parameters[2], &offset);
+    status |= vxQueryImage((vx_image)parameters[0], VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+    *in_start_y = (start_y + offset < height ? start_y + offset : height);
+    *in_end_y = (end_y + offset < height ? end_y + offset : height);
+    return status;
+}
 
 static vx_status VX_CALLBACK vxCutInputValidator(vx_node node, vx_uint32 index)
 {
@@ -131,6 +160,7 @@ vx_kernel_description_t add_cut_kernel = {
     add_cut_kernel_params, dimof(add_cut_kernel_params),
     vxCutInputValidator,
     vxCutOutputValidator,
-    NULL, NULL
+    vxRowsInitializer,
+    vxRowsDeinitializer
 };
 
@@ -0,0 +1,372 @@
+#include <stdlib.h>
+#include <string.h>
+#include "add_kernels.h"
+#include "vx_internal.h"
+#include "vx_ransac.h"
+
+/* The seed of every run, the same tracks always give the same motion */
+#define FIND_WARP_SEED 0x2545f491u
+
+typedef struct _find_warp_point_t {
+    vx_float32 x, y, u, v;
+    vx_float32 strength;
+    vx_uint32  index;
+} find_warp_point_t;
+
+/* Buffers for the tracked points, sized to the capacity of the arrays */
+typedef struct _find_warp_data_t {
+    vx_size            capacity;
+    find_warp_point_t *points;
+    vx_float32        *coords;
+    vx_uint8          *mask;
+} find_warp_data_t;
+
+/* Reads a point of an array of either VX_TYPE_KEYPOINT or VX_TYPE_KEYPOINT_F32 */
+static void GetKeypoint(void *buff, vx_size i, vx_size stride, vx_enum type, vx_float32 *x, vx_float32 *y, vx_float32 *strength)
+{
+    if (type == VX_TYPE_KEYPOINT_F32)
+    {
+        vx_keypoint_f32_t *kp = &vxArrayItem(vx_keypoint_f32_t, buff, i, stride);
+        *x = kp->x;
+        *y = kp->y;
+        *strength = kp->strength;
+    }
+    else
+    {
+        vx_keypoint_t *kp = &vxArrayItem(vx_keypoint_t, buff, i, stride);
+        *x = (vx_float32)kp->x;
+        *y = (vx_float32)kp->y;
+        *strength = kp->strength;
+    }
+}
+
+/* The strongest corners first, PROSAC samples them first */
+static int ComparePoints(const void *a, const void *b)
+{
+    const find_warp_point_t *p1 = (const find_warp_point_t *)a;
+    const find_warp_point_t *p2 = (const find_warp_point_t *)b;
+    if (p1->strength != p2->strength)
+        return p1->strength > p2->strength ? -1 : 1;
+    return p1->index < p2->index ? -1 : (p1->index > p2->index ? 1 : 0);
+}
+
+static vx_status VX_CALLBACK vxFindWarpKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    if (num != 6)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    vx_status status = VX_SUCCESS;
+    vx_array  def_pnts   = (vx_array) parameters[0];
+    vx_array  moved_pnts = (vx_array) parameters[1];
+    vx_scalar smodel     = (vx_scalar)parameters[2];
+    vx_scalar smax_iter  = (vx_scalar)parameters[3];
+    vx_scalar sthreshold = (vx_scalar)parameters[4];
+    vx_matrix matrix     = (vx_matrix)parameters[5];
+
+    find_warp_data_t *data = NULL;
+    vx_ransac_params_t ransac = {VX_ADD_MOTION_MODEL_HOMOGRAPHY, RANSAC_DEFAULT_ITERATIONS,
+                                 RANSAC_DEFAULT_THRESHOLD, FIND_WARP_SEED};
+    vx_float32 matr_buff[9] = {1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f}, *out = NULL;
+    vx_size points_num = 0, tracked = 0, inliers = 0, i;
+    vx_enum def_type = 0, moved_type = 0;
+
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+    status |= vxQueryArray(def_pnts, VX_ARRAY_ATTRIBUTE_NUMITEMS, &points_num, sizeof(points_num));
+    status |= vxQueryArray(def_pnts, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &def_type, sizeof(def_type));
+    status |= vxQueryArray(moved_pnts, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &moved_type, sizeof(moved_type));
+    if (smodel)
+        status |= vxAccessScalarValue(smodel, &ransac.model);
+    if (smax_iter)
+        status |= vxAccessScalarValue(smax_iter, &ransac.max_iterations);
+    if (sthreshold)
+        status |= vxAccessScalarValue(sthreshold, &ransac.threshold);
+    if (status != VX_SUCCESS || data == NULL || points_num > data->capacity)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Can't query array attribute(%d)!\n", status);
+        return VX_FAILURE;
+    }
+
+    if (points_num > 0)
+    {
+        vx_size stride1 = 0ul, stride2 = 0ul;
+        void *def_buff = NULL, *moved_buff = NULL;
+        status |= vxAccessArrayRange(def_pnts, 0, points_num, &stride1, &def_buff, VX_READ_ONLY);
+        status |= vxAccessArrayRange(moved_pnts, 0, points_num, &stride2, &moved_buff, VX_READ_ONLY);
+        if (def_buff && moved_buff)
+        {
+            for (i = 0; i < points_num; i++)
+            {
+                // tracking_status has the same offset in both keypoint types
+                if (vxArrayItem(vx_keypoint_t, moved_buff, i, stride2).tracking_status)
+                {
+                    find_warp_point_t *pt = &data->points[tracked++];
+                    vx_float32 unused;
+                    GetKeypoint(def_buff, i, stride1, def_type, &pt->x, &pt->y, &pt->strength);
+                    GetKeypoint(moved_buff, i, stride2, moved_type, &pt->u, &pt->v, &unused);
+                    pt->index = (vx_uint32)i;
+                }
+            }
+        }
+        else
+        {
+            status = VX_FAILURE;
+        }
+        if (def_buff)
+            status |= vxCommitArrayRange(def_pnts, 0, 0, def_buff);
+        if (moved_buff)
+            status |= vxCommitArrayRange(moved_pnts, 0, 0, moved_buff);
+    }
+    VX_PRINT(VX_ZONE_LOG, "Number of points = (%d)!\n", tracked);
+
+    if (status == VX_SUCCESS && tracked > 0)
+    {
+        /* structure of arrays for the scoring of the models */
+        vx_float32 *xs = data->coords, *ys = xs + tracked, *us = ys + tracked, *vs = us + tracked;
+        qsort(data->points, tracked, sizeof(find_warp_point_t), ComparePoints);
+        for (i = 0; i < tracked; i++)
+        {
+            xs[i] = data->points[i].x;
+            ys[i] = data->points[i].y;
+            us[i] = data->points[i].u;
+            vs[i] = data->points[i].v;
+        }
+        inliers = vxRansacMotion(&ransac, xs, ys, us, vs, tracked, data->mask, matr_buff);
+        VX_PRINT(VX_ZONE_LOG, "Number of inliers = (%d)!\n", inliers);
+    }
+    if (inliers == 0)
+        VX_PRINT(VX_ZONE_WARNING, "No motion found in %d points!\n", tracked);
+
+    if (vxMapMatrixInt(matrix, (void **)&out, VX_WRITE_ONLY) == VX_SUCCESS)
+    {
+        memcpy(out, matr_buff, sizeof(matr_buff));
+        vxUnmapMatrixInt(matrix, VX_WRITE_ONLY);
+    }
+    else
+    {
+        status = VX_ERROR_NO_MEMORY;
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK vxFindWarpInitializer(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    vx_status status = VX_SUCCESS;
+    find_warp_data_t *data = NULL;
+    vx_size capacity = 0;
+
+    vxQueryArray((vx_array)parameters[0], VX_ARRAY_ATTRIBUTE_CAPACITY, &capacity, sizeof(capacity));
+    /* a graph which is verified again keeps the local data of its nodes */
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+    if (data == NULL)
+    {
+        vx_size size = sizeof(find_warp_data_t);
+        data = (find_warp_data_t *)calloc(1, size);
+        if (data == NULL)
+            return VX_ERROR_NO_MEMORY;
+        status = vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size));
+        status |= vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+        if (status != VX_SUCCESS)
+        {
+            free(data);
+            return status;
+        }
+    }
+    if (data->capacity != capacity)
+    {
+        free(data->points);
+        free(data->coords);
+        free(data->mask);
+        data->capacity = capacity;
+        data->points = (find_warp_point_t *)malloc(capacity * sizeof(find_warp_point_t) + 1);
+        data->coords = (vx_float32 *)malloc(4 * capacity * sizeof(vx_float32) + 1);
+        data->mask   = (vx_uint8 *)malloc(capacity + 1);
+        if (data->points == NULL || data->coords == NULL || data->mask == NULL)
+        {
+            data->capacity = 0;
+            return VX_ERROR_NO_MEMORY;
+        }
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK vxFindWarpDeinitializer(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    find_warp_data_t *data = NULL;
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+    /* the structure itself is freed with the node */
+    if (data)
+    {
+        free(data->points);
+        free(data->coords);
+        free(data->mask);
+        data->points = NULL;
+        data->coords = NULL;
+        data->mask = NULL;
+        data->capacity = 0;
+    }
+    return VX_SUCCESS;
+}
+
+static vx_status VX_CALLBACK vxFindWarpInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    if (index == 0 || index == 1 )
+    {
+        vx_parameter param1 = vxGetParameterByIndex(node, 0);
+        vx_parameter param2 = vxGetParameterByIndex(node, 1);
+        if (param1 && param2)
+        {
+            vx_array arr1 = 0, arr2 = 0;
+            vxQueryParameter(param1, VX_PARAMETER_ATTRIBUTE_REF, &arr1, sizeof(arr1));
+            vxQueryParameter(param2, VX_PARAMETER_ATTRIBUTE_REF, &arr2, sizeof(arr2));
+            if (arr1 && arr2)
+            {
+                vx_enum item_type1 = 0, item_type2 = 0;
+                vxQueryArray(arr1, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type1, sizeof(item_type1));
+                vxQueryArray(arr2, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type2, sizeof(item_type2));
+                if ((item_type1 == VX_TYPE_KEYPOINT || item_type1 == VX_TYPE_KEYPOINT_F32) &&
+                    (item_type2 == VX_TYPE_KEYPOINT || item_type2 == VX_TYPE_KEYPOINT_F32))
+                {
+                    vx_size num1, num2;
+                    vxQueryArray(arr1, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num1, sizeof(num1));
+                    vxQueryArray(arr2, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num2, sizeof(num2));
+                    if(num1 == num2)
+                    {
+                        status = VX_SUCCESS;
+                    }
+                }
+                vxReleaseArray(&arr1);
+                vxReleaseArray(&arr2);
+            }
+            vxReleaseParameter(&param1);
+            vxReleaseParameter(&param2);
+        }
+    }
+    else if (index == 2)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_scalar scalar = 0;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+            if (scalar)
+            {
+                vx_enum stype = 0;
+                vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, &stype, sizeof(stype));
+                if (stype == VX_TYPE_ENUM)
+                {
+                    vx_enum model = 0;
+                    vxAccessScalarValue(scalar, &model);
+                    if ((model == VX_ADD_MOTION_MODEL_TRANSLATION) ||
+                        (model == VX_ADD_MOTION_MODEL_SIMILARITY) ||
+                        (model == VX_ADD_MOTION_MODEL_AFFINE) ||
+                        (model == VX_ADD_MOTION_MODEL_HOMOGRAPHY))
+                    {
+                        status = VX_SUCCESS;
+                    }
+                    else
+                    {
+                        status = VX_ERROR_INVALID_VALUE;
+                    }
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_TYPE;
+                }
+                vxReleaseScalar(&scalar);
+            }
+            else
+            {
+                /* optional, homography by default */
+                status = VX_SUCCESS;
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    else if (index == 3 || index == 4)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_scalar scalar = 0;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+            if (scalar)
+            {
+                vx_enum stype = 0;
+                vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, &stype, sizeof(stype));
+                if (index == 3 && stype == VX_TYPE_UINT32)
+                {
+                    vx_uint32 max_iter = 0;
+                    vxAccessScalarValue(scalar, &max_iter);
+                    status = (max_iter > 0) ? VX_SUCCESS : VX_ERROR_INVALID_VALUE;
+                }
+                else if (index == 4 && stype == VX_TYPE_FLOAT32)
+                {
+                    vx_float32 threshold = 0.f;
+                    vxAccessScalarValue(scalar, &threshold);
+                    status = (threshold > 0.f) ? VX_SUCCESS : VX_ERROR_INVALID_VALUE;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_TYPE;
+                }
+                vxReleaseScalar(&scalar);
+            }
+            else
+            {
+                /* optional, the defaults of cv::findHomography */
+                status = VX_SUCCESS;
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK vxFindWarpOutputValidator(vx_node node, vx_uint32 index, vx_meta_format_t *ptr)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    if (index == 5)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_matrix matrix;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &matrix, sizeof(matrix));
+            if (matrix)
+            {
+                vx_enum data_type = 0;
+                vx_size rows = 0ul, columns = 0ul;
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_TYPE, &data_type, sizeof(data_type));
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_ROWS, &rows, sizeof(rows));
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_COLUMNS, &columns, sizeof(columns));
+                if ((data_type == VX_TYPE_FLOAT32) && (columns == 3) && (rows == 3))
+                {
+                    status = VX_SUCCESS;
+                }
+                vxReleaseMatrix(&matrix);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    return status;
+}
+
+static vx_param_description_t add_find_warp_kernel_params[] = {
+    {VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_ARRAY, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_OUTPUT, VX_TYPE_MATRIX, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t add_find_warp_kernel = {
+    VX_ADD_KERNEL_FIND_WARP,
+    VX_ADD_KERNEL_NAME_FIND_WARP,
+    vxFindWarpKernel,
+    add_find_warp_kernel_params, dimof(add_find_warp_kernel_params),
+    vxFindWarpInputValidator, vxFindWarpOutputValidator,
+    vxFindWarpInitializer,
+    vxFindWarpDeinitializer
+};
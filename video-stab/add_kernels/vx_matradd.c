@@ -14,10 +14,10 @@ static vx_status VX_CALLBACK vxMatrixAddKernel(vx_node node, vx_reference *param
     if(use_coef)
         vxAccessScalarValue(scalar, &coeff);
 
-    vx_float32 matr1[9], matr2[9], res[9];
-    status |= vxAccessMatrix(matrix1, matr1);
-    status |= vxAccessMatrix(matrix2, matr2);
-    status |= vxAccessMatrix(out_matr, res);
+    vx_float32 *matr1 = NULL, *matr2 = NULL, *res = NULL;
+    status |= vxMapMatrixInt(matrix1, (void **)&matr1, VX_READ_ONLY);
+    status |= vxMapMatrixInt(matrix2, (void **)&matr2, VX_READ_ONLY);
+    status |= vxMapMatrixInt(out_matr, (void **)&res, VX_WRITE_ONLY);
     if(status != VX_SUCCESS)
     {
         VX_PRINT(VX_ZONE_ERROR, "Cann't access to matrix(%d)!\n", status);
@@ -36,9 +36,9 @@ static vx_status VX_CALLBACK vxMatrixAddKernel(vx_node node, vx_reference *param
     }
     if(use_coef)
         status |= vxCommitScalarValue(scalar, &coeff);
-    status |= vxCommitMatrix(matrix1, matr1);
-    status |= vxCommitMatrix(matrix2, matr2);
-    status |= vxCommitMatrix(out_matr, res);
+    vxUnmapMatrixInt(matrix1, VX_READ_ONLY);
+    vxUnmapMatrixInt(matrix2, VX_READ_ONLY);
+    vxUnmapMatrixInt(out_matr, VX_WRITE_ONLY);
     return status;
 }
 
@@ -9,9 +9,9 @@ static vx_status VX_CALLBACK vxMatrixInvertKernel(vx_node node, vx_reference *pa
     vx_matrix input = (vx_matrix)parameters[0];
     vx_matrix output = (vx_matrix)parameters[1];
 
-    vx_float32 in_matr[9], out_matr[9];
-    status |= vxAccessMatrix(input, in_matr);
-    status |= vxAccessMatrix(output, out_matr);
+    void *in_matr = NULL, *out_matr = NULL;
+    status |= vxMapMatrixInt(input, &in_matr, VX_READ_ONLY);
+    status |= vxMapMatrixInt(output, &out_matr, VX_WRITE_ONLY);
     if(status != VX_SUCCESS)
     {
         VX_PRINT(VX_ZONE_ERROR, "Cann't access to matrix(%d)!\n", status);
@@ -19,14 +19,13 @@ static vx_status VX_CALLBACK vxMatrixInvertKernel(vx_node node, vx_reference *pa
     }
 
     /*** CV invert matrix ***/
-    cv::Mat_<float> cv_matr(3, 3);
-    memcpy(cv_matr.data, in_matr, sizeof(vx_float32) * 9);
-    cv_matr = cv_matr.inv();
-    memcpy(out_matr, cv_matr.data,sizeof(vx_float32) * 9);
+    cv::Mat_<float> cv_in(3, 3, (float*)in_matr);
+    cv::Mat_<float> cv_out(3, 3, (float*)out_matr);
+    cv::invert(cv_in, cv_out);
     /************************/
 
-    status |= vxCommitMatrix(input, in_matr);
-    status |= vxCommitMatrix(output, out_matr);
+    vxUnmapMatrixInt(input, VX_READ_ONLY);
+    vxUnmapMatrixInt(output, VX_WRITE_ONLY);
     return status;
 }
 
@@ -0,0 +1,64 @@
+#include <string.h>
+#include "vx_matrix3x3.h"
+
+void vxMatrix3x3Multiply(const vx_float64 a[9], const vx_float64 b[9], vx_float64 res[9])
+{
+    vx_float64 tmp[9];
+    int i, j, k;
+    for (i = 0; i < 3; i++)
+    {
+        for (j = 0; j < 3; j++)
+        {
+            tmp[i * 3 + j] = 0.;
+            for (k = 0; k < 3; k++)
+                tmp[i * 3 + j] += a[i * 3 + k] * b[k * 3 + j];
+        }
+    }
+    memcpy(res, tmp, sizeof(tmp));
+}
+
+void vxMatrix3x3AddScaled(const vx_float64 a[9], vx_float64 coeff, vx_float64 res[9])
+{
+    int i;
+    for (i = 0; i < 9; i++)
+        res[i] += a[i] * coeff;
+}
+
+void vxMatrix3x3Adjugate(const vx_float64 a[9], vx_float64 res[9])
+{
+    vx_float64 tmp[9];
+    tmp[0] = a[4] * a[8] - a[5] * a[7];
+    tmp[1] = a[2] * a[7] - a[1] * a[8];
+    tmp[2] = a[1] * a[5] - a[2] * a[4];
+    tmp[3] = a[5] * a[6] - a[3] * a[8];
+    tmp[4] = a[0] * a[8] - a[2] * a[6];
+    tmp[5] = a[2] * a[3] - a[0] * a[5];
+    tmp[6] = a[3] * a[7] - a[4] * a[6];
+    tmp[7] = a[1] * a[6] - a[0] * a[7];
+    tmp[8] = a[0] * a[4] - a[1] * a[3];
+    memcpy(res, tmp, sizeof(tmp));
+}
+
+vx_bool vxMatrix3x3Invert(const vx_float64 a[9], vx_float64 res[9])
+{
+    vx_float64 tmp[9], det;
+    int i;
+
+    /* adjugate over the determinant */
+    vxMatrix3x3Adjugate(a, tmp);
+    det = a[0] * tmp[0] + a[1] * tmp[3] + a[2] * tmp[6];
+    if (det == 0.)
+    {
+        memset(res, 0, 9 * sizeof(vx_float64));
+        return vx_false_e;
+    }
+    for (i = 0; i < 9; i++)
+        res[i] = tmp[i] / det;
+    return vx_true_e;
+}
+
+void vxMatrix3x3Identity(vx_float64 res[9])
+{
+    memset(res, 0, 9 * sizeof(vx_float64));
+    res[0] = res[4] = res[8] = 1.;
+}
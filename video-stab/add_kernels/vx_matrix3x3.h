@@ -0,0 +1,32 @@
+#ifndef VX_MATRIX3X3_H
+#define VX_MATRIX3X3_H
+
+#include <VX/vx.h>
+
+/* Plain helpers for the row-major 3x3 matrices of the stabilization kernels,
+ * so they don't pay a node or a matrix copy for each operation. They work in
+ * double, the products of many homographies lose too much in float. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* res = a * b, res may be a or b */
+void vxMatrix3x3Multiply(const vx_float64 a[9], const vx_float64 b[9], vx_float64 res[9]);
+
+/* res += coeff * a */
+void vxMatrix3x3AddScaled(const vx_float64 a[9], vx_float64 coeff, vx_float64 res[9]);
+
+/* res = adj(a), the transposed cofactors, res may be a */
+void vxMatrix3x3Adjugate(const vx_float64 a[9], vx_float64 res[9]);
+
+/* res = a^-1, res may be a. A singular a gives a zero matrix and vx_false_e, like cv::Mat::inv */
+vx_bool vxMatrix3x3Invert(const vx_float64 a[9], vx_float64 res[9]);
+
+void vxMatrix3x3Identity(vx_float64 res[9]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VX_MATRIX3X3_H
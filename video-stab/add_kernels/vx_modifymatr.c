@@ -1,80 +1,70 @@
 #include "add_kernels.h"
 #include "vx_internal.h"
-#include "opencv2/core/core.hpp"
-#include "opencv2/imgproc/imgproc.hpp"
+#include "vx_matrix3x3.h"
+#include <math.h>
 
-#define ACCURACY 0.01
+/* The matrix is moved towards the identity, m(a) = a * M + (1 - a) * I, until the inverse
+ * warp keeps the corners of the crop rectangle inside the frame. With p a corner,
+ * adj(m(a)) * p is quadratic in a: adj(I + a * E) = I + a * (tr(E) * I - E) + a^2 * adj(E)
+ * for E = M - I. Every bound of a corner is then a quadratic which is positive at a = 0,
+ * and the largest a is the first of their roots in (0, 1]. */
 
-static void TransformPerspective(vx_coordinates2d_t point, vx_coordinates2d_t& tpoint, const vx_float32 m[])
+/* The first a in (0, 1] where c0 + c1 * a + c2 * a^2 stops being positive, 1 when it doesn't */
+static vx_float64 FirstRoot(vx_float64 c0, vx_float64 c1, vx_float64 c2)
 {
-    vx_float32 z = point.x * m[6] + point.y * m[7] + m[8];
-    tpoint.x = (point.x * m[0] + point.y * m[1] + m[2]) / z;
-    tpoint.y = (point.x * m[3] + point.y * m[4] + m[5]) / z;
-}
-
-static bool CheckPointArea(vx_coordinates2d_t point, vx_rectangle_t rect)
-{
-    if(point.x < rect.start_x || point.x >= rect.end_x ||
-            point.y < rect.start_y || point.y >= rect.end_y)
-        return false;
-    return true;
-}
-
-static bool CheckRectArea(vx_coordinates2d_t points[4], vx_rectangle_t rect, const vx_float32 m[])
-{
-    bool in_area = true;
-    for(int i = 0; i < 4; i++)
+    vx_float64 disc, q, r1, r2, root = 1.;
+    if (c0 <= 0.)
+        return 0.;
+    if (c2 == 0.)
     {
-        TransformPerspective(points[i], points[i], m);
-        in_area &= CheckPointArea(points[i], rect);
+        if (c1 < 0.)
+            root = -c0 / c1;
+        return root < 1. ? root : 1.;
     }
-    return in_area;
+    disc = c1 * c1 - 4. * c2 * c0;
+    if (disc < 0.)
+        return 1.;
+    /* the roots without the cancellation of -c1 +- sqrt(disc) */
+    q  = -0.5 * (c1 + (c1 < 0. ? -sqrt(disc) : sqrt(disc)));
+    r1 = q / c2;
+    r2 = (q != 0.) ? c0 / q : r1;
+    if (r1 > 0. && r1 < root)
+        root = r1;
+    if (r2 > 0. && r2 < root)
+        root = r2;
+    return root;
 }
 
-static vx_status ModifyMatrix(vx_matrix in_matr, vx_matrix out_matr, vx_uint32 width, vx_uint32 height, vx_float32 scale)
+/* The largest a for which the corners stay in [0, width) x [0, height) */
+static vx_float64 MaxAlpha(const vx_float32 m[9], const vx_float64 corners[4][2], vx_uint32 width, vx_uint32 height)
 {
-    vx_rectangle_t rect = { 0, 0, width, height};
-    vx_uint32 w_mod = (width * (1 - scale)) / 2.;
-    vx_uint32 h_mod = (height * (1 - scale)) / 2.;
-    vx_coordinates2d_t srect[4] = { {w_mod, h_mod}, {width - w_mod, h_mod},
-                                    {width - w_mod, height - h_mod}, {w_mod, height - h_mod}};
-    vx_float32 m[9];
-    vx_float32 res[9];
-    vx_float32 inv[9];
-    vxAccessMatrix(in_matr, m);
-    vxAccessMatrix(out_matr, res);
-
-    // invert
-    cv::Mat_<float> cv_matr(3, 3), cv_inv(3, 3);
-    memcpy(cv_matr.data, m, sizeof(vx_float32) * 9);
-    cv_inv = cv_matr.inv();
-    memcpy(inv, cv_inv.data,sizeof(vx_float32) * 9);
-    // check need modify
-    bool do_modify = !CheckRectArea(srect, rect, inv);
+    vx_float64 e[9], lin[9], quad[9], alpha = 1., tr;
+    int i, c;
+    for (i = 0; i < 9; i++)
+        e[i] = (vx_float64)m[i] - ((i % 4 == 0) ? 1. : 0.);
+    tr = e[0] + e[4] + e[8];
+    for (i = 0; i < 9; i++)
+        lin[i] = ((i % 4 == 0) ? tr : 0.) - e[i];
+    vxMatrix3x3Adjugate(e, quad);
 
-    if(do_modify)
+    for (c = 0; c < 4; c++)
     {
-        vx_float32 left = 0., right = 1.;
-        cv::Mat_<float> cv_eye = cv::Mat::eye(3, 3, CV_32FC1);
-        cv::Mat_<float> cv_res(3, 3);
-        while(right - left > ACCURACY)
+        const vx_float64 *p = corners[c];
+        /* adj(m(a)) * p = n0 + n1 * a + n2 * a^2, n0 = p */
+        vx_float64 n1[3], n2[3];
+        for (i = 0; i < 3; i++)
         {
-            vx_float32 alpha = (left + right) / 2.;
-            cv_res = alpha * cv_matr + (1. - alpha) * cv_eye;
-            cv_inv = cv_res.inv();
-            bool check = CheckRectArea(srect, rect, (vx_float32*)cv_inv.data);
-            if(check) left  = alpha;
-            else      right = alpha;
+            n1[i] = lin[3 * i] * p[0] + lin[3 * i + 1] * p[1] + lin[3 * i + 2];
+            n2[i] = quad[3 * i] * p[0] + quad[3 * i + 1] * p[1] + quad[3 * i + 2];
         }
-        memcpy(res, cv_res.data, sizeof(vx_float32) * 9);
-    }
-    else
-    {
-        memcpy(res, m, sizeof(vx_float32) * 9);
+        /* z > 0, x >= 0, width * z - x > 0, y >= 0, height * z - y > 0 */
+        alpha = fmin(alpha, FirstRoot(1., n1[2], n2[2]));
+        alpha = fmin(alpha, FirstRoot(p[0], n1[0], n2[0]));
+        alpha = fmin(alpha, FirstRoot(width - p[0], width * n1[2] - n1[0], width * n2[2] - n2[0]));
+        alpha = fmin(alpha, FirstRoot(p[1], n1[1], n2[1]));
+        alpha = fmin(alpha, FirstRoot(height - p[1], height * n1[2] - n1[1], height * n2[2] - n2[1]));
     }
-    vxCommitMatrix(in_matr, m);
-    vxCommitMatrix(out_matr, res);
-    return VX_SUCCESS;
+    return alpha;
 }
 
 static vx_status VX_CALLBACK vxMatrixModifyKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
@@ -86,20 +76,40 @@ static vx_status VX_CALLBACK vxMatrixModifyKernel(vx_node node, vx_reference *pa
     vx_scalar s_scale  = (vx_scalar)parameters[3];
     vx_matrix out_matr = (vx_matrix)parameters[4];
 
-    vx_uint32 width, height;
-    vx_float32 scale;
+    vx_uint32 width, height, w_mod, h_mod;
+    vx_float32 scale, *m = NULL, *out = NULL, res[9], alpha;
+    int i;
     status |= vxAccessScalarValue(s_width,  &width);
     status |= vxAccessScalarValue(s_height, &height);
     status |= vxAccessScalarValue(s_scale,  &scale);
-    if(status == VX_SUCCESS)
+    if(status != VX_SUCCESS)
     {
-        status = ModifyMatrix(in_matr, out_matr, width, height, scale);
+        VX_PRINT(VX_ZONE_ERROR, "Access scalar values failure!\n");
+        return status;
     }
-    else
+    status |= vxMapMatrixInt(in_matr, (void **)&m, VX_READ_ONLY);
+    status |= vxMapMatrixInt(out_matr, (void **)&out, VX_WRITE_ONLY);
+    if(status != VX_SUCCESS)
     {
-        VX_PRINT(VX_ZONE_ERROR, "Access scalar values failure!\n");
+        VX_PRINT(VX_ZONE_ERROR, "Cann't access to matrix(%d)!\n", status);
+        return status;
     }
-    return status;
+
+    w_mod = (vx_uint32)((width * (1 - scale)) / 2.);
+    h_mod = (vx_uint32)((height * (1 - scale)) / 2.);
+    {
+        const vx_float64 corners[4][2] = { {w_mod, h_mod}, {width - w_mod, h_mod},
+                                           {width - w_mod, height - h_mod}, {w_mod, height - h_mod} };
+        alpha = (vx_float32)MaxAlpha(m, corners, width, height);
+    }
+    /* the output may be the input */
+    for (i = 0; i < 9; i++)
+        res[i] = alpha * m[i] + ((i % 4 == 0) ? 1.f - alpha : 0.f);
+    memcpy(out, res, sizeof(res));
+
+    vxUnmapMatrixInt(in_matr, VX_READ_ONLY);
+    vxUnmapMatrixInt(out_matr, VX_WRITE_ONLY);
+    return VX_SUCCESS;
 }
 
 static vx_status VX_CALLBACK vxMatrixModifyInputValidator(vx_node node, vx_uint32 index)
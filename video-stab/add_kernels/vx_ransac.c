@@ -0,0 +1,492 @@
+#include <math.h>
+#include <string.h>
+#include "add_kernels.h"
+#include "vx_ransac.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RANSAC_USE_SSE2
+#endif
+
+/* A homography takes the largest sample */
+#define RANSAC_MAX_SAMPLE 4
+
+typedef struct _ransac_points_t {
+    const vx_float32 *sx, *sy, *dx, *dy;
+    vx_size num;
+} ransac_points_t;
+
+/* Either the points of a sample or the points set in a mask */
+typedef struct _ransac_set_t {
+    const vx_uint32 *index;
+    const vx_uint8  *mask;
+    vx_size          count;
+} ransac_set_t;
+
+static vx_bool set_next(const ransac_set_t *set, vx_size *k, vx_size *i)
+{
+    if (set->index)
+    {
+        if (*k >= set->count)
+            return vx_false_e;
+        *i = set->index[(*k)++];
+        return vx_true_e;
+    }
+    while (*k < set->count && set->mask[*k] == 0)
+        (*k)++;
+    if (*k >= set->count)
+        return vx_false_e;
+    *i = (*k)++;
+    return vx_true_e;
+}
+
+static vx_uint32 sample_size(vx_enum model)
+{
+    switch (model)
+    {
+        case VX_ADD_MOTION_MODEL_TRANSLATION:
+            return 1;
+        case VX_ADD_MOTION_MODEL_SIMILARITY:
+            return 2;
+        case VX_ADD_MOTION_MODEL_AFFINE:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+/* xorshift32, the state is never 0 */
+static vx_uint32 next_random(vx_uint32 *state)
+{
+    vx_uint32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/* Uniform in [0, n) */
+static vx_uint32 random_index(vx_uint32 *state, vx_uint32 n)
+{
+    return (vx_uint32)(((vx_uint64)next_random(state) * n) >> 32);
+}
+
+static void identity(vx_float64 h[9])
+{
+    memset(h, 0, 9 * sizeof(vx_float64));
+    h[0] = h[4] = h[8] = 1.;
+}
+
+/* Least squares translation, similarity or affine transform of the set, in centered coordinates */
+static vx_bool fit_linear(vx_enum model, const ransac_points_t *pts, const ransac_set_t *set, vx_float64 h[9])
+{
+    vx_float64 n = 0., mx = 0., my = 0., mu = 0., mv = 0.;
+    vx_float64 sxx = 0., sxy = 0., syy = 0., sxu = 0., sxv = 0., syu = 0., syv = 0.;
+    vx_size k = 0, i;
+
+    while (set_next(set, &k, &i))
+    {
+        mx += pts->sx[i];
+        my += pts->sy[i];
+        mu += pts->dx[i];
+        mv += pts->dy[i];
+        n += 1.;
+    }
+    if (n == 0.)
+        return vx_false_e;
+    mx /= n;
+    my /= n;
+    mu /= n;
+    mv /= n;
+    identity(h);
+    if (model == VX_ADD_MOTION_MODEL_TRANSLATION)
+    {
+        h[2] = mu - mx;
+        h[5] = mv - my;
+        return vx_true_e;
+    }
+
+    k = 0;
+    while (set_next(set, &k, &i))
+    {
+        vx_float64 x = pts->sx[i] - mx, y = pts->sy[i] - my;
+        vx_float64 u = pts->dx[i] - mu, v = pts->dy[i] - mv;
+        sxx += x * x;
+        sxy += x * y;
+        syy += y * y;
+        sxu += x * u;
+        sxv += x * v;
+        syu += y * u;
+        syv += y * v;
+    }
+    if (model == VX_ADD_MOTION_MODEL_SIMILARITY)
+    {
+        /* u = a x - b y, v = b x + a y */
+        vx_float64 d = sxx + syy;
+        if (d <= 1e-8)
+            return vx_false_e;
+        h[0] = h[4] = (sxu + syv) / d;
+        h[3] = (sxv - syu) / d;
+        h[1] = -h[3];
+    }
+    else
+    {
+        vx_float64 det = sxx * syy - sxy * sxy;
+        /* collinear points */
+        if (det <= 1e-6 * (sxx + syy) * (sxx + syy) || det <= 1e-8)
+            return vx_false_e;
+        h[0] = (syy * sxu - sxy * syu) / det;
+        h[1] = (sxx * syu - sxy * sxu) / det;
+        h[3] = (syy * sxv - sxy * syv) / det;
+        h[4] = (sxx * syv - sxy * sxv) / det;
+    }
+    h[2] = mu - h[0] * mx - h[1] * my;
+    h[5] = mv - h[3] * mx - h[4] * my;
+    return vx_true_e;
+}
+
+/* Solves a x = b in place by Gaussian elimination with partial pivoting */
+static vx_bool solve8(vx_float64 a[8][8], vx_float64 b[8])
+{
+    int r, c, k;
+    for (c = 0; c < 8; c++)
+    {
+        int pivot = c;
+        for (r = c + 1; r < 8; r++)
+        {
+            if (fabs(a[r][c]) > fabs(a[pivot][c]))
+                pivot = r;
+        }
+        if (fabs(a[pivot][c]) < 1e-12)
+            return vx_false_e;
+        if (pivot != c)
+        {
+            vx_float64 tmp;
+            for (k = 0; k < 8; k++)
+            {
+                tmp = a[c][k];
+                a[c][k] = a[pivot][k];
+                a[pivot][k] = tmp;
+            }
+            tmp = b[c];
+            b[c] = b[pivot];
+            b[pivot] = tmp;
+        }
+        for (r = c + 1; r < 8; r++)
+        {
+            vx_float64 f = a[r][c] / a[c][c];
+            for (k = c; k < 8; k++)
+                a[r][k] -= f * a[c][k];
+            b[r] -= f * b[c];
+        }
+    }
+    for (c = 7; c >= 0; c--)
+    {
+        for (k = c + 1; k < 8; k++)
+            b[c] -= a[c][k] * b[k];
+        b[c] /= a[c][c];
+    }
+    return vx_true_e;
+}
+
+/* Least squares DLT homography of the set with h33 = 1. The points are normalized first,
+ * the centroid moves to the origin and the mean distance from it becomes sqrt(2). */
+static vx_bool fit_homography(const ransac_points_t *pts, const ransac_set_t *set, vx_float64 h[9])
+{
+    vx_float64 n = 0., mx = 0., my = 0., mu = 0., mv = 0., ds = 0., dd = 0., ss, sd;
+    vx_float64 a[8][8], b[8], hn[9];
+    vx_size k = 0, i;
+    int r, c;
+
+    while (set_next(set, &k, &i))
+    {
+        mx += pts->sx[i];
+        my += pts->sy[i];
+        mu += pts->dx[i];
+        mv += pts->dy[i];
+        n += 1.;
+    }
+    if (n < 4.)
+        return vx_false_e;
+    mx /= n;
+    my /= n;
+    mu /= n;
+    mv /= n;
+    k = 0;
+    while (set_next(set, &k, &i))
+    {
+        ds += sqrt((pts->sx[i] - mx) * (pts->sx[i] - mx) + (pts->sy[i] - my) * (pts->sy[i] - my));
+        dd += sqrt((pts->dx[i] - mu) * (pts->dx[i] - mu) + (pts->dy[i] - mv) * (pts->dy[i] - mv));
+    }
+    if (ds <= 1e-8 || dd <= 1e-8)
+        return vx_false_e;
+    ss = sqrt(2.) * n / ds;
+    sd = sqrt(2.) * n / dd;
+
+    /* normal equations of
+     *     [x y 1 0 0 0 -ux -uy] h = u
+     *     [0 0 0 x y 1 -vx -vy] h = v */
+    memset(a, 0, sizeof(a));
+    memset(b, 0, sizeof(b));
+    k = 0;
+    while (set_next(set, &k, &i))
+    {
+        vx_float64 x = (pts->sx[i] - mx) * ss, y = (pts->sy[i] - my) * ss;
+        vx_float64 u = (pts->dx[i] - mu) * sd, v = (pts->dy[i] - mv) * sd;
+        vx_float64 r1[8] = {x, y, 1., 0., 0., 0., -u * x, -u * y};
+        vx_float64 r2[8] = {0., 0., 0., x, y, 1., -v * x, -v * y};
+        for (r = 0; r < 8; r++)
+        {
+            for (c = r; c < 8; c++)
+                a[r][c] += r1[r] * r1[c] + r2[r] * r2[c];
+            b[r] += r1[r] * u + r2[r] * v;
+        }
+    }
+    for (r = 1; r < 8; r++)
+    {
+        for (c = 0; c < r; c++)
+            a[r][c] = a[c][r];
+    }
+    if (solve8(a, b) == vx_false_e)
+        return vx_false_e;
+    memcpy(hn, b, sizeof(b));
+    hn[8] = 1.;
+
+    /* h = Td^-1 * hn * Ts, Ts = |ss 0 -ss*mx|, Td^-1 = |1/sd 0 mu|
+     *                           |0 ss -ss*my|          |0 1/sd mv|
+     *                           |0  0    1  |          |0   0   1| */
+    for (r = 0; r < 3; r++)
+    {
+        vx_float64 h0 = hn[3 * r + 0] * ss, h1 = hn[3 * r + 1] * ss;
+        vx_float64 h2 = hn[3 * r + 2] - hn[3 * r + 0] * ss * mx - hn[3 * r + 1] * ss * my;
+        h[3 * r + 0] = h0;
+        h[3 * r + 1] = h1;
+        h[3 * r + 2] = h2;
+    }
+    for (c = 0; c < 3; c++)
+    {
+        h[0 + c] = h[0 + c] / sd + mu * h[6 + c];
+        h[3 + c] = h[3 + c] / sd + mv * h[6 + c];
+    }
+    if (fabs(h[8]) < 1e-12)
+        return vx_false_e;
+    for (c = 0; c < 9; c++)
+        h[c] /= h[8];
+    h[8] = 1.;
+    return vx_true_e;
+}
+
+static vx_float64 cross(const vx_float32 *x, const vx_float32 *y, vx_uint32 i, vx_uint32 j, vx_uint32 k)
+{
+    return ((vx_float64)x[j] - x[i]) * ((vx_float64)y[k] - y[i]) - ((vx_float64)y[j] - y[i]) * ((vx_float64)x[k] - x[i]);
+}
+
+/* Rejects samples of a homography with three collinear points or with a triangle which is
+ * mirrored between the frames, no camera motion gives one */
+static vx_bool good_sample(const ransac_points_t *pts, const vx_uint32 *sample)
+{
+    static const vx_uint32 triangles[4][3] = {{0, 1, 2}, {0, 1, 3}, {0, 2, 3}, {1, 2, 3}};
+    int t;
+    for (t = 0; t < 4; t++)
+    {
+        vx_uint32 i = sample[triangles[t][0]], j = sample[triangles[t][1]], k = sample[triangles[t][2]];
+        vx_float64 cs = cross(pts->sx, pts->sy, i, j, k);
+        vx_float64 cd = cross(pts->dx, pts->dy, i, j, k);
+        if (fabs(cs) < 1e-2 || fabs(cd) < 1e-2 || (cs < 0.) != (cd < 0.))
+            return vx_false_e;
+    }
+    return vx_true_e;
+}
+
+static vx_bool fit_model(vx_enum model, const ransac_points_t *pts, const ransac_set_t *set, vx_float32 h[9])
+{
+    vx_float64 hd[9];
+    vx_bool ok;
+    int i;
+    if (model == VX_ADD_MOTION_MODEL_HOMOGRAPHY)
+        ok = fit_homography(pts, set, hd);
+    else
+        ok = fit_linear(model, pts, set, hd);
+    if (ok == vx_false_e)
+        return vx_false_e;
+    for (i = 0; i < 9; i++)
+        h[i] = (vx_float32)hd[i];
+    return vx_true_e;
+}
+
+#ifdef RANSAC_USE_SSE2
+static const vx_uint8 bit_count[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+#endif
+
+/* Counts the points within the threshold of their model position, mask gets them when given.
+ * The SSE2 and the scalar path do the same float operations, so they agree to the bit. */
+static vx_size score_model(const vx_float32 h[9], vx_bool projective, const ransac_points_t *pts,
+                           vx_float32 thr2, vx_uint8 *mask)
+{
+    vx_size i = 0, count = 0;
+#ifdef RANSAC_USE_SSE2
+    const __m128 h0 = _mm_set1_ps(h[0]), h1 = _mm_set1_ps(h[1]), h2 = _mm_set1_ps(h[2]);
+    const __m128 h3 = _mm_set1_ps(h[3]), h4 = _mm_set1_ps(h[4]), h5 = _mm_set1_ps(h[5]);
+    const __m128 h6 = _mm_set1_ps(h[6]), h7 = _mm_set1_ps(h[7]), h8 = _mm_set1_ps(h[8]);
+    const __m128 one = _mm_set1_ps(1.f), thr = _mm_set1_ps(thr2);
+    for (; i + 4 <= pts->num; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(pts->sx + i), y = _mm_loadu_ps(pts->sy + i);
+        __m128 u = _mm_add_ps(_mm_add_ps(_mm_mul_ps(h0, x), _mm_mul_ps(h1, y)), h2);
+        __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(h3, x), _mm_mul_ps(h4, y)), h5);
+        __m128 du, dv;
+        int bits;
+        if (projective)
+        {
+            __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(h6, x), _mm_mul_ps(h7, y)), h8);
+            __m128 iw = _mm_div_ps(one, w);
+            u = _mm_mul_ps(u, iw);
+            v = _mm_mul_ps(v, iw);
+        }
+        du = _mm_sub_ps(u, _mm_loadu_ps(pts->dx + i));
+        dv = _mm_sub_ps(v, _mm_loadu_ps(pts->dy + i));
+        /* NaN and infinity of points at w = 0 compare false */
+        bits = _mm_movemask_ps(_mm_cmple_ps(_mm_add_ps(_mm_mul_ps(du, du), _mm_mul_ps(dv, dv)), thr));
+        count += bit_count[bits];
+        if (mask)
+        {
+            mask[i + 0] = (vx_uint8)(bits & 1);
+            mask[i + 1] = (vx_uint8)((bits >> 1) & 1);
+            mask[i + 2] = (vx_uint8)((bits >> 2) & 1);
+            mask[i + 3] = (vx_uint8)((bits >> 3) & 1);
+        }
+    }
+#endif
+    for (; i < pts->num; i++)
+    {
+        vx_float32 x = pts->sx[i], y = pts->sy[i];
+        vx_float32 u = h[0] * x + h[1] * y + h[2];
+        vx_float32 v = h[3] * x + h[4] * y + h[5];
+        vx_float32 du, dv;
+        vx_bool inlier;
+        if (projective)
+        {
+            vx_float32 iw = 1.f / (h[6] * x + h[7] * y + h[8]);
+            u = u * iw;
+            v = v * iw;
+        }
+        du = u - pts->dx[i];
+        dv = v - pts->dy[i];
+        inlier = (du * du + dv * dv <= thr2) ? vx_true_e : vx_false_e;
+        count += inlier ? 1 : 0;
+        if (mask)
+            mask[i] = (vx_uint8)(inlier ? 1 : 0);
+    }
+    return count;
+}
+
+/* Draws m distinct points. While the PROSAC set has not grown to all the points, the
+ * sample takes its last point and the others from the points before it. */
+static void draw_sample(vx_uint32 *state, vx_uint32 m, vx_uint32 n, vx_bool with_last, vx_uint32 *sample)
+{
+    vx_uint32 k = 0, j;
+    if (with_last)
+        sample[k++] = n - 1;
+    while (k < m)
+    {
+        vx_uint32 idx = random_index(state, with_last ? n - 1 : n);
+        for (j = 0; j < k; j++)
+        {
+            if (sample[j] == idx)
+                break;
+        }
+        if (j == k)
+            sample[k++] = idx;
+    }
+}
+
+vx_size vxRansacMotion(const vx_ransac_params_t *params,
+                       const vx_float32 *src_x, const vx_float32 *src_y,
+                       const vx_float32 *dst_x, const vx_float32 *dst_y,
+                       vx_size num, vx_uint8 *mask, vx_float32 model[9])
+{
+    ransac_points_t pts = {src_x, src_y, dst_x, dst_y, num};
+    vx_enum type = params->model;
+    vx_uint32 m = sample_size(type);
+    vx_bool projective = (type == VX_ADD_MOTION_MODEL_HOMOGRAPHY) ? vx_true_e : vx_false_e;
+    vx_float32 thr2 = params->threshold * params->threshold;
+    vx_float32 h[9];
+    vx_uint32 sample[RANSAC_MAX_SAMPLE];
+    vx_uint32 state = params->seed ? params->seed : 0x9e3779b9u;
+    vx_uint32 iterations = params->max_iterations, it, n = m, refine;
+    vx_float64 tn = params->max_iterations, tn_prime = 1.;
+    vx_size best = 0, i;
+
+    for (i = 0; i < 9; i++)
+        model[i] = (i % 4 == 0) ? 1.f : 0.f;
+    memset(mask, 0, num);
+    if (num < m)
+        return 0;
+
+    /* PROSAC growth of the sampled set: T_n, the number of samples from the first n points
+     * a plain RANSAC would draw in the whole budget, and T'_n, the iteration at which the
+     * set takes its next point */
+    for (i = 0; i < m; i++)
+        tn *= (vx_float64)(m - i) / (vx_float64)(num - i);
+
+    for (it = 1; it <= iterations; it++)
+    {
+        ransac_set_t set = {sample, NULL, m};
+        vx_size count;
+        if ((vx_float64)it > tn_prime && n < num)
+        {
+            vx_float64 tn1 = tn * (n + 1) / (n + 1 - m);
+            tn_prime += ceil(tn1 - tn);
+            tn = tn1;
+            n++;
+        }
+        draw_sample(&state, m, n, (n < num && tn_prime >= (vx_float64)it) ? vx_true_e : vx_false_e, sample);
+        if (projective && good_sample(&pts, sample) == vx_false_e)
+            continue;
+        if (fit_model(type, &pts, &set, h) == vx_false_e)
+            continue;
+
+        count = score_model(h, projective, &pts, thr2, NULL);
+        if (count > best)
+        {
+            vx_float64 ratio = (vx_float64)count / num;
+            best = count;
+            memcpy(model, h, sizeof(h));
+            /* stop once a sample without outliers was drawn with the wanted confidence */
+            if (ratio >= 1.)
+            {
+                iterations = it;
+            }
+            else
+            {
+                vx_float64 den = log(1. - pow(ratio, (vx_float64)m));
+                if (den < 0.)
+                {
+                    vx_float64 need = ceil(log(1. - RANSAC_CONFIDENCE) / den);
+                    if (need < (vx_float64)iterations)
+                        iterations = (need > (vx_float64)it) ? (vx_uint32)need : it;
+                }
+            }
+        }
+    }
+    if (best == 0)
+        return 0;
+
+    /* refine on all the inliers while it keeps them */
+    score_model(model, projective, &pts, thr2, mask);
+    for (refine = 0; refine < 2; refine++)
+    {
+        ransac_set_t set = {NULL, mask, num};
+        vx_size count;
+        if (fit_model(type, &pts, &set, h) == vx_false_e)
+            break;
+        count = score_model(h, projective, &pts, thr2, NULL);
+        if (count < best)
+            break;
+        best = count;
+        memcpy(model, h, sizeof(h));
+        score_model(model, projective, &pts, thr2, mask);
+    }
+    return best;
+}
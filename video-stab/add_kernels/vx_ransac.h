@@ -0,0 +1,38 @@
+#ifndef VX_RANSAC_H
+#define VX_RANSAC_H
+
+#include <VX/vx.h>
+
+/* Default iteration budget, as cv::findHomography */
+#define RANSAC_DEFAULT_ITERATIONS 2000
+/* Default reprojection threshold in pixels, as cv::findHomography */
+#define RANSAC_DEFAULT_THRESHOLD  3.f
+/* Probability that one of the samples is free of outliers when the search stops early */
+#define RANSAC_CONFIDENCE         0.995
+
+typedef struct _vx_ransac_params_t {
+    vx_enum    model;          /* vx_add_motion_model_e */
+    vx_uint32  max_iterations; /* the search never draws more samples */
+    vx_float32 threshold;      /* largest distance of an inlier from its model position */
+    vx_uint32  seed;           /* the same seed and points always give the same model */
+} vx_ransac_params_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Finds the model of the motion from the points (src_x, src_y) to (dst_x, dst_y) with PROSAC:
+ * the samples are drawn from the first points first, so the points go from the most reliable.
+ * The row-major 3x3 model is refined on its inliers and written to model, mask gets 1 for the
+ * inliers and 0 for the others. Returns the number of inliers, with no model found it is 0 and
+ * model is the identity. mask must hold num points. */
+vx_size vxRansacMotion(const vx_ransac_params_t *params,
+                       const vx_float32 *src_x, const vx_float32 *src_y,
+                       const vx_float32 *dst_x, const vx_float32 *dst_y,
+                       vx_size num, vx_uint8 *mask, vx_float32 model[9]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // VX_RANSAC_H
@@ -1,36 +1,143 @@
 #include "add_kernels.h"
 #include "vx_internal.h"
+#include "vx_rows.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GRAY_USE_SSE2
+#endif
+
+/* BT.601 luma weights in 15 bit fixed point, they sum up to 1 << GRAY_BITS */
+#define GRAY_BITS 15
+#define GRAY_R 9798
+#define GRAY_G 19235
+#define GRAY_B 3735
+
+typedef struct _rgb_to_gray_t {
+    void *src_buff, *dst_buff;
+    vx_imagepatch_addressing_t src_addr, dst_addr;
+    /* weights of the channels in memory order */
+    vx_int32 w[3];
+} rgb_to_gray_t;
+
+#ifdef GRAY_USE_SSE2
+/* One round of the unpack network, five rounds turn 32 interleaved RGB pixels
+ * in v[0..5] into R0-15, R16-31, G0-15, G16-31, B0-15, B16-31 */
+static void deinterleave_round(__m128i v[6])
+{
+    __m128i c0 = _mm_unpacklo_epi8(v[0], v[3]);
+    __m128i c1 = _mm_unpackhi_epi8(v[0], v[3]);
+    __m128i c2 = _mm_unpacklo_epi8(v[1], v[4]);
+    __m128i c3 = _mm_unpackhi_epi8(v[1], v[4]);
+    __m128i c4 = _mm_unpacklo_epi8(v[2], v[5]);
+    __m128i c5 = _mm_unpackhi_epi8(v[2], v[5]);
+    v[0] = c0; v[1] = c1; v[2] = c2; v[3] = c3; v[4] = c4; v[5] = c5;
+}
+
+/* Luma of 8 pixels with 16 bit channels in memory order */
+static __m128i gray8(__m128i c0, __m128i c1, __m128i c2, __m128i w01, __m128i w2)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(c0, c1), w01),
+                               _mm_madd_epi16(_mm_unpacklo_epi16(c2, zero), w2));
+    __m128i hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(c0, c1), w01),
+                               _mm_madd_epi16(_mm_unpackhi_epi16(c2, zero), w2));
+    return _mm_packs_epi32(_mm_srli_epi32(lo, GRAY_BITS), _mm_srli_epi32(hi, GRAY_BITS));
+}
+
+/* Converts 32 pixels */
+static void gray32(const vx_uint8 *src, vx_uint8 *dst, __m128i w01, __m128i w2)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i v[6];
+    vx_uint32 i;
+    for (i = 0; i < 6; i++)
+        v[i] = _mm_loadu_si128((const __m128i *)(src + 16 * i));
+    for (i = 0; i < 5; i++)
+        deinterleave_round(v);
+    for (i = 0; i < 2; i++)
+    {
+        __m128i lo = gray8(_mm_unpacklo_epi8(v[i], zero), _mm_unpacklo_epi8(v[2 + i], zero),
+                           _mm_unpacklo_epi8(v[4 + i], zero), w01, w2);
+        __m128i hi = gray8(_mm_unpackhi_epi8(v[i], zero), _mm_unpackhi_epi8(v[2 + i], zero),
+                           _mm_unpackhi_epi8(v[4 + i], zero), w01, w2);
+        _mm_storeu_si128((__m128i *)(dst + 16 * i), _mm_packus_epi16(lo, hi));
+    }
+}
+#endif
+
+static vx_uint8 gray_pixel(const vx_uint8 *src, const vx_int32 *w)
+{
+    return (vx_uint8)((src[0] * w[0] + src[1] * w[1] + src[2] * w[2]) >> GRAY_BITS);
+}
+
+static vx_status rgb_to_gray_rows(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    rgb_to_gray_t *conv = (rgb_to_gray_t *)arg;
+    vx_uint32 y, x, width = conv->src_addr.dim_x;
+    /* packed rows are walked with plain pointers */
+    vx_bool packed = (vx_bool)(conv->src_addr.stride_x == 3 && conv->dst_addr.stride_x == 1 &&
+                               conv->src_addr.scale_x == VX_SCALE_UNITY && conv->src_addr.scale_y == VX_SCALE_UNITY &&
+                               conv->dst_addr.scale_x == VX_SCALE_UNITY && conv->dst_addr.scale_y == VX_SCALE_UNITY);
+#ifdef GRAY_USE_SSE2
+    __m128i w01 = _mm_set1_epi32((conv->w[1] << 16) | conv->w[0]);
+    __m128i w2  = _mm_set1_epi32(conv->w[2]);
+#endif
+    for (y = start_y; y < end_y; y++)
+    {
+        if (packed)
+        {
+            const vx_uint8 *src = (const vx_uint8 *)conv->src_buff + y * conv->src_addr.stride_y;
+            vx_uint8 *dst = (vx_uint8 *)conv->dst_buff + y * conv->dst_addr.stride_y;
+            x = 0;
+#ifdef GRAY_USE_SSE2
+            for (; x + 32 <= width; x += 32)
+                gray32(&src[3 * x], &dst[x], w01, w2);
+#endif
+            for (; x < width; x++)
+                dst[x] = gray_pixel(&src[3 * x], conv->w);
+        }
+        else
+        {
+            for (x = 0; x < width; x++)
+            {
+                vx_uint8* src = vxFormatImagePatchAddress2d(conv->src_buff, x, y, &conv->src_addr);
+                vx_uint8* dst = vxFormatImagePatchAddress2d(conv->dst_buff, x, y, &conv->dst_addr);
+                *dst = gray_pixel(src, conv->w);
+            }
+        }
+    }
+    return VX_SUCCESS;
+}
 
 static vx_status VX_CALLBACK vxRGBtoGrayKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
 {
-    if(num != 2)
+    if(num != 3)
         return VX_ERROR_INVALID_PARAMETERS;
 
     vx_image input = (vx_image)parameters[0];
-    vx_image output = (vx_image)parameters[1];
+    vx_scalar sorder = (vx_scalar)parameters[1];
+    vx_image output = (vx_image)parameters[2];
 
-    vx_uint32 y, x, width = 0, height = 0;
-    void *dst_buff   = NULL, *src_buff = NULL;
     vx_status status = VX_SUCCESS;
-    vx_imagepatch_addressing_t dst_addr, src_addr;
+    rgb_to_gray_t conv = {NULL, NULL};
+    vx_enum order = VX_ADD_CHANNEL_ORDER_RGB;
     vx_rectangle_t rect;
 
-    status  = vxGetValidRegionImage(input, &rect);
-    status |= vxAccessImagePatch(input, &rect, 0, &src_addr, (void **)&src_buff, VX_READ_AND_WRITE);
-    status |= vxAccessImagePatch(output, &rect, 0, &dst_addr, (void **)&dst_buff, VX_READ_AND_WRITE);
-    height = src_addr.dim_y;
-    width = src_addr.dim_x;
-    for (y = 0; y < height; y++)
+    if (sorder)
+        status |= vxAccessScalarValue(sorder, &order);
+    conv.w[0] = order == VX_ADD_CHANNEL_ORDER_BGR ? GRAY_B : GRAY_R;
+    conv.w[1] = GRAY_G;
+    conv.w[2] = order == VX_ADD_CHANNEL_ORDER_BGR ? GRAY_R : GRAY_B;
+
+    status |= vxGetValidRegionImage(input, &rect);
+    status |= vxMapImagePatchInt(input, &rect, 0, &conv.src_addr, &conv.src_buff, VX_READ_ONLY);
+    status |= vxMapImagePatchInt(output, &rect, 0, &conv.dst_addr, &conv.dst_buff, VX_WRITE_ONLY);
+    if (status == VX_SUCCESS)
     {
-        for (x = 0; x < width; x++)
-        {
-            vx_uint8* src = vxFormatImagePatchAddress2d(src_buff, x, y, &src_addr);
-            vx_uint8* dst = vxFormatImagePatchAddress2d(dst_buff, x, y, &dst_addr);
-            *dst = src[0] * 0.299 + src[1] * 0.587 + src[2] * 0.114;
-        }
+        status = vxRowsParallelFor(node, conv.src_addr.dim_y, rgb_to_gray_rows, &conv);
+        vxUnmapImagePatchInt(output, &rect, VX_WRITE_ONLY);
     }
-    status |= vxCommitImagePatch(input, NULL, 0, &src_addr, src_buff);
-    status |= vxCommitImagePatch(output, &rect, 0, &dst_addr, dst_buff);
     return status;
 }
 
@@ -53,13 +160,52 @@ static vx_status VX_CALLBACK vxRGBtoGrayInputValidator(vx_node node, vx_uint32 i
         }
         vxReleaseParameter(&param);
     }
+    else if (index == 1)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_scalar scalar = 0;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+            if (scalar)
+            {
+                vx_enum stype = 0;
+                vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, &stype, sizeof(stype));
+                if (stype == VX_TYPE_ENUM)
+                {
+                    vx_enum order = 0;
+                    vxAccessScalarValue(scalar, &order);
+                    if ((order == VX_ADD_CHANNEL_ORDER_RGB) ||
+                        (order == VX_ADD_CHANNEL_ORDER_BGR))
+                    {
+                        status = VX_SUCCESS;
+                    }
+                    else
+                    {
+                        status = VX_ERROR_INVALID_VALUE;
+                    }
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_TYPE;
+                }
+                vxReleaseScalar(&scalar);
+            }
+            else
+            {
+                /* optional, RGB by default */
+                status = VX_SUCCESS;
+            }
+            vxReleaseParameter(&param);
+        }
+    }
     return status;
 }
 
 static vx_status VX_CALLBACK vxRGBtoGrayOutputValidator(vx_node node, vx_uint32 index, vx_meta_format_t *ptr)
 {
     vx_status status = VX_ERROR_INVALID_PARAMETERS;
-    if (index == 1)
+    if (index == 2)
     {
         vx_parameter param = vxGetParameterByIndex(node, 0);
         if (param)
@@ -86,6 +232,7 @@ static vx_status VX_CALLBACK vxRGBtoGrayOutputValidator(vx_node node, vx_uint32
 
 static vx_param_description_t add_rgb_to_gray_kernel_params[] = {
     {VX_INPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT, VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
     {VX_OUTPUT, VX_TYPE_IMAGE, VX_PARAMETER_STATE_REQUIRED},
 };
 
@@ -95,5 +242,5 @@ vx_kernel_description_t add_rgb_to_gray_kernel = {
     vxRGBtoGrayKernel,
     add_rgb_to_gray_kernel_params, dimof(add_rgb_to_gray_kernel_params),
     vxRGBtoGrayInputValidator, vxRGBtoGrayOutputValidator,
-    NULL, NULL
+    vxRowsInitializer, vxRowsDeinitializer
 };
@@ -0,0 +1,142 @@
+#include "add_kernels.h"
+#include "vx_internal.h"
+#include "vx_rows.h"
+
+/* Rows of a band below which no more threads are used */
+#define ROWS_MIN_BAND 16
+#define ROWS_MAX_JOBS (VX_INT_MAX_WORKERS)
+
+typedef struct _rows_job_t {
+    vx_rows_f func;
+    void *arg;
+    vx_uint32 start_y, end_y;
+    vx_status status;
+} rows_job_t;
+
+/* The node local data of row-separable kernels */
+typedef struct _rows_data_t {
+    /* runs all bands but the first, NULL if single threaded */
+    vx_threadpool_t *workers;
+    vx_uint32 numThreads;
+    rows_job_t jobs[ROWS_MAX_JOBS];
+    vx_value_set_t workitems[ROWS_MAX_JOBS];
+} rows_data_t;
+
+static vx_bool vxRowsWorker(vx_threadpool_worker_t *worker)
+{
+    rows_job_t *job = (rows_job_t *)worker->data->v1;
+    job->status = job->func(job->arg, job->start_y, job->end_y);
+    return (job->status == VX_SUCCESS ? vx_true_e : vx_false_e);
+}
+
+vx_status vxRowsParallelFor(vx_node node, vx_uint32 height, vx_rows_f func, void *arg)
+{
+    vx_status status = VX_SUCCESS;
+    rows_data_t *data = NULL;
+    vx_rectangle_t band = {0, 0, 0, 0};
+    vx_uint32 numJobs, rows, j, first = 0;
+
+    /* a node of a tiled graph computes one band of its rows at a time */
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_BAND, &band, sizeof(band));
+    if (band.end_y > band.start_y)
+    {
+        first = (band.start_y < height ? band.start_y : height);
+        height = (band.end_y < height ? band.end_y : height);
+    }
+    rows = height - first;
+    numJobs = rows / ROWS_MIN_BAND;
+
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+    if (data == NULL || data->workers == NULL || numJobs < 2)
+        return func(arg, first, height);
+    if (numJobs > data->numThreads)
+        numJobs = data->numThreads;
+    for (j = 0; j < numJobs; j++)
+    {
+        rows_job_t *job = &data->jobs[j];
+        job->func = func;
+        job->arg = arg;
+        job->start_y = first;
+        job->end_y = first + rows / numJobs + (j < rows % numJobs ? 1 : 0);
+        job->status = VX_SUCCESS;
+        data->workitems[j].v1 = (vx_value_t)job;
+        first = job->end_y;
+    }
+    if (vxIssueThreadpool(data->workers, &data->workitems[1], numJobs - 1) == vx_false_e)
+    {
+        /* some of the bands may have been issued before the queues overflowed */
+        vxCompleteThreadpool(data->workers, vx_true_e);
+        return VX_ERROR_NO_RESOURCES;
+    }
+    status = func(arg, data->jobs[0].start_y, data->jobs[0].end_y);
+    vxCompleteThreadpool(data->workers, vx_true_e);
+    /* the status of the topmost band which failed */
+    for (j = 1; j < numJobs && status == VX_SUCCESS; j++)
+        status = data->jobs[j].status;
+    return status;
+}
+
+vx_status VX_CALLBACK vxRowsSameInputRows(vx_node node, const vx_reference parameters[], vx_uint32 index,
+                                          vx_uint32 start_y, vx_uint32 end_y,
+                                          vx_uint32 *in_start_y, vx_uint32 *in_end_y)
+{
+    vx_uint32 height = 0;
+    vx_status status = vxQueryImage((vx_image)parameters[index], VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+    *in_start_y = (start_y < height ? start_y : height);
+    *in_end_y = (end_y < height ? end_y : height);
+    return status;
+}
+
+vx_status VX_CALLBACK vxRowsInitializer(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    vx_status status = VX_SUCCESS;
+    rows_data_t *data = NULL;
+    vx_uint32 numThreads = 0;
+
+    /* a graph which is verified again keeps the local data of its nodes */
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+    if (data)
+    {
+        if (data->workers)
+            vxDestroyThreadpool(&data->workers);
+    }
+    else
+    {
+        vx_size size = sizeof(rows_data_t);
+        data = (rows_data_t *)calloc(1, size);
+        if (data == NULL)
+            return VX_ERROR_NO_MEMORY;
+        status = vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size));
+        status |= vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+        if (status != VX_SUCCESS)
+        {
+            free(data);
+            return status;
+        }
+    }
+
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_THREADS, &numThreads, sizeof(numThreads));
+    if (numThreads == 0)
+        numThreads = vxGetNumCores();
+    if (numThreads > ROWS_MAX_JOBS)
+        numThreads = ROWS_MAX_JOBS;
+    data->numThreads = numThreads;
+    if (numThreads > 1)
+    {
+        data->workers = vxCreateThreadpool(VX_THREADPOOL_ROUND_ROBIN, numThreads - 1, ROWS_MAX_JOBS,
+                                           sizeof(vx_value_set_t), vxRowsWorker, data);
+        if (data->workers == NULL)
+            return VX_ERROR_NO_RESOURCES;
+    }
+    return status;
+}
+
+vx_status VX_CALLBACK vxRowsDeinitializer(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    rows_data_t *data = NULL;
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &data, sizeof(data));
+    /* the structure itself is freed with the node */
+    if (data && data->workers)
+        vxDestroyThreadpool(&data->workers);
+    return VX_SUCCESS;
+}
@@ -0,0 +1,32 @@
+#ifndef VX_ROWS_H
+#define VX_ROWS_H
+
+#include <VX/vx.h>
+#include <VX/vx_ext_tiled_graph.h>
+
+/* Row-separable kernels: a kernel whose output rows can be computed independently
+ * lists vxRowsInitializer and vxRowsDeinitializer in its kernel description and
+ * runs its body through vxRowsParallelFor. The rows are split into contiguous
+ * horizontal bands, one per thread of the node (VX_NODE_ATTRIBUTE_THREADS, 0 - one
+ * per core), and the calling thread computes the first band itself. */
+
+/* Computes the rows [start_y, end_y) */
+typedef vx_status (*vx_rows_f)(void *arg, vx_uint32 start_y, vx_uint32 end_y);
+
+/* Calls func over the rows [0, height) split into bands, returns the status of the
+ * first band, from the top, which failed.
+ * The rows are the rows of the output image: in a tiled graph the node computes only the
+ * rows of its VX_NODE_ATTRIBUTE_BAND in each call. */
+vx_status vxRowsParallelFor(vx_node node, vx_uint32 height, vx_rows_f func, void *arg);
+
+/* The input rows of a band of a row-separable kernel which reads the same rows of its input,
+ * as vx_kernel_input_rows_f. Listed in add_band_kernels the kernel can run in the bands of a
+ * tiled graph (VX_GRAPH_ATTRIBUTE_TILE_HEIGHT). */
+vx_status VX_CALLBACK vxRowsSameInputRows(vx_node node, const vx_reference parameters[], vx_uint32 index,
+                                          vx_uint32 start_y, vx_uint32 end_y,
+                                          vx_uint32 *in_start_y, vx_uint32 *in_end_y);
+
+vx_status VX_CALLBACK vxRowsInitializer(vx_node node, vx_reference *parameters, vx_uint32 num);
+vx_status VX_CALLBACK vxRowsDeinitializer(vx_node node, vx_reference *parameters, vx_uint32 num);
+
+#endif // VX_ROWS_H
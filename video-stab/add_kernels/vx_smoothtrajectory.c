@@ -0,0 +1,384 @@
+#include "add_kernels.h"
+#include "vx_internal.h"
+#include "vx_matrix3x3.h"
+
+/* The largest radius of the smoothing window */
+#define SMOOTH_MAX_RADIUS 32
+#define SMOOTH_MAX_FRAMES (2 * SMOOTH_MAX_RADIUS + 1)
+
+/* The window keeps 2 * radius + 1 frames, frame 0 is the newest and the matrix of slot
+ * first + f of the delay moves frame f to frame f + 1. The smoothed correction is
+ *     res = sum_f w[f] * T_f,   T_f the transform from frame f to the center frame radius.
+ * With the cumulative transforms A_f from frame f to an older anchor frame,
+ * A_f = A_{f+1} * m[f] and T_f = A_radius^-1 * A_f, so
+ *     res = A_radius^-1 * sum_f w[f] * A_f
+ * and a new frame costs one multiply for its A and one inverse of the center. */
+typedef struct _smooth_state_t {
+    vx_uint32  radius;
+    vx_uint32  first;
+    vx_bool    valid;
+    /* the matrices of the window at the last run and their write counts, newest first */
+    vx_matrix  matrices[2 * SMOOTH_MAX_RADIUS];
+    vx_uint32  writes[2 * SMOOTH_MAX_RADIUS];
+    /* ring of A_f, newest is at head */
+    vx_float64 cumulative[SMOOTH_MAX_FRAMES][9];
+    vx_uint32  head;
+    /* frames from the newest to the anchor, the anchor moves up once it is a window behind */
+    vx_uint32  anchor_age;
+} smooth_state_t;
+
+/* The matrix vxAgeDelay binds to a node parameter of the given slot. vxGetReferenceFromDelay
+ * moves the other way once the delay is aged, so only its slot 0 can be used at run time.
+ * The index is read under the lock of the delay, vxAgeDelay moves it under the same lock. */
+static vx_matrix delay_slot(vx_delay delay, vx_uint32 slot)
+{
+    vx_matrix matrix;
+    vxSemWait(&delay->base.lock);
+    matrix = (vx_matrix)delay->refs[(delay->index + delay->count - slot % delay->count) % delay->count];
+    vxSemPost(&delay->base.lock);
+    return matrix;
+}
+
+/* The write count of the matrix, under its lock as vxWroteToReference changes it */
+static vx_uint32 write_count(vx_matrix matrix)
+{
+    vx_uint32 count;
+    vxSemWait(&matrix->base.lock);
+    count = matrix->base.write_count;
+    vxSemPost(&matrix->base.lock);
+    return count;
+}
+
+/* Reads the matrix with a map, a commit would count as a write */
+static vx_status read_matrix(vx_matrix matrix, vx_float64 m[9])
+{
+    vx_float32 *ptr = NULL;
+    int i;
+    vx_status status = vxMapMatrixInt(matrix, (void **)&ptr, VX_READ_ONLY);
+    if (status != VX_SUCCESS)
+        return status;
+    for (i = 0; i < 9; i++)
+        m[i] = ptr[i];
+    vxUnmapMatrixInt(matrix, VX_READ_ONLY);
+    return VX_SUCCESS;
+}
+
+static vx_float64 *state_frame(smooth_state_t *state, vx_uint32 frame)
+{
+    vx_uint32 frames = 2 * state->radius + 1;
+    return state->cumulative[(state->head + frames - frame) % frames];
+}
+
+/* How many new matrices were pushed into the window since the last run, the matrices which are
+ * still in the window must be the same objects and must not have been written since then */
+static vx_uint32 window_shift(smooth_state_t *state, vx_delay delay)
+{
+    vx_uint32 n = 2 * state->radius, s, i;
+    if (state->valid == vx_false_e)
+        return n;
+    for (s = 0; s < n; s++)
+    {
+        for (i = s; i < n; i++)
+        {
+            vx_matrix matrix = delay_slot(delay, state->first + i);
+            if (matrix != state->matrices[i - s] || write_count(matrix) != state->writes[i - s])
+                break;
+        }
+        if (i == n)
+            return s;
+    }
+    return n;
+}
+
+/* Moves the anchor to the oldest frame of the window */
+static vx_status rebase(smooth_state_t *state)
+{
+    vx_uint32 f;
+    vx_float64 inv[9];
+    if (vxMatrix3x3Invert(state_frame(state, 2 * state->radius), inv) == vx_false_e)
+        return VX_FAILURE;
+    for (f = 0; f < 2 * state->radius + 1; f++)
+        vxMatrix3x3Multiply(inv, state_frame(state, f), state_frame(state, f));
+    state->anchor_age = 2 * state->radius;
+    return VX_SUCCESS;
+}
+
+static vx_status smooth_window(smooth_state_t *state, vx_delay delay, const vx_float32 *w, vx_float32 res[9])
+{
+    vx_status status = VX_SUCCESS;
+    vx_uint32 frames = 2 * state->radius + 1;
+    vx_uint32 shift = window_shift(state, delay), f;
+    vx_float64 m[9], sum[9], inv[9], out[9];
+
+    if (shift == 2 * state->radius)
+    {
+        /* nothing to reuse, the anchor is the oldest frame */
+        state->head = 0;
+        state->anchor_age = 0;
+        vxMatrix3x3Identity(state_frame(state, 0));
+    }
+    state->valid = vx_false_e;
+    for (f = shift; f-- > 0 && status == VX_SUCCESS; )
+    {
+        vx_float64 *prev = state_frame(state, 0);
+        status = read_matrix(delay_slot(delay, state->first + f), m);
+        state->head = (state->head + 1) % frames;
+        vxMatrix3x3Multiply(prev, m, state_frame(state, 0));
+        state->anchor_age++;
+    }
+    if (status == VX_SUCCESS && state->anchor_age >= 2 * frames)
+        status = rebase(state);
+    if (status != VX_SUCCESS)
+        return status;
+    for (f = 0; f < 2 * state->radius; f++)
+    {
+        state->matrices[f] = delay_slot(delay, state->first + f);
+        state->writes[f] = write_count(state->matrices[f]);
+    }
+    state->valid = vx_true_e;
+
+    memset(sum, 0, sizeof(sum));
+    for (f = 0; f < frames; f++)
+        vxMatrix3x3AddScaled(state_frame(state, f), w[f], sum);
+    vxMatrix3x3Invert(state_frame(state, state->radius), inv);
+    vxMatrix3x3Multiply(inv, sum, out);
+    for (f = 0; f < 9; f++)
+        res[f] = (vx_float32)out[f];
+    return VX_SUCCESS;
+}
+
+static vx_status VX_CALLBACK vxSmoothTrajectoryKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    if (num != 4)
+        return VX_ERROR_INVALID_PARAMETERS;
+
+    vx_delay  matrices = (vx_delay) parameters[0];
+    vx_scalar sfirst   = (vx_scalar)parameters[1];
+    vx_array  coeffs   = (vx_array) parameters[2];
+    vx_matrix output   = (vx_matrix)parameters[3];
+
+    vx_status status = VX_SUCCESS;
+    smooth_state_t *state = NULL;
+    vx_float32 w[SMOOTH_MAX_FRAMES], *res = NULL;
+    vx_uint32 first = 0, radius, i;
+    vx_size num_coeffs = 0, stride = 0;
+    void *base = NULL;
+
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &state, sizeof(state));
+    if (sfirst)
+        status |= vxAccessScalarValue(sfirst, &first);
+    status |= vxQueryArray(coeffs, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_coeffs, sizeof(num_coeffs));
+    if (status != VX_SUCCESS || state == NULL || num_coeffs == 0 || num_coeffs > dimof(w))
+        return VX_ERROR_INVALID_PARAMETERS;
+    radius = (vx_uint32)(num_coeffs / 2);
+
+    status = vxAccessArrayRange(coeffs, 0, num_coeffs, &stride, &base, VX_READ_ONLY);
+    if (status != VX_SUCCESS)
+        return status;
+    for (i = 0; i < num_coeffs; i++)
+        w[i] = vxArrayItem(vx_float32, base, i, stride);
+    vxCommitArrayRange(coeffs, 0, 0, base);
+
+    if (state->radius != radius || state->first != first)
+    {
+        state->radius = radius;
+        state->first  = first;
+        state->valid  = vx_false_e;
+    }
+    status = vxMapMatrixInt(output, (void **)&res, VX_WRITE_ONLY);
+    if (status != VX_SUCCESS)
+        return status;
+    status = smooth_window(state, matrices, w, res);
+    vxUnmapMatrixInt(output, VX_WRITE_ONLY);
+    if (status != VX_SUCCESS)
+    {
+        state->valid = vx_false_e;
+        VX_PRINT(VX_ZONE_ERROR, "Can't accumulate the matrices of the window(%d)!\n", status);
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK vxSmoothTrajectoryInitializer(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    vx_status status = VX_SUCCESS;
+    smooth_state_t *state = NULL;
+
+    /* a graph which is verified again keeps the local data of its nodes */
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &state, sizeof(state));
+    if (state == NULL)
+    {
+        vx_size size = sizeof(smooth_state_t);
+        state = (smooth_state_t *)calloc(1, size);
+        if (state == NULL)
+            return VX_ERROR_NO_MEMORY;
+        status = vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_SIZE, &size, sizeof(size));
+        status |= vxSetNodeAttribute(node, VX_NODE_ATTRIBUTE_LOCAL_DATA_PTR, &state, sizeof(state));
+        if (status != VX_SUCCESS)
+        {
+            free(state);
+            return status;
+        }
+    }
+    /* the parameters may be other objects now */
+    state->valid = vx_false_e;
+    return status;
+}
+
+static vx_bool IsMatrix3x3(vx_matrix matrix)
+{
+    vx_enum data_type = 0;
+    vx_size rows = 0ul, columns = 0ul;
+    vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_TYPE, &data_type, sizeof(data_type));
+    vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_ROWS, &rows, sizeof(rows));
+    vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_COLUMNS, &columns, sizeof(columns));
+    return (vx_bool)((data_type == VX_TYPE_FLOAT32) && (columns == 3) && (rows == 3));
+}
+
+static vx_status VX_CALLBACK vxSmoothTrajectoryInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    if (index == 0)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_delay delay = 0;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &delay, sizeof(delay));
+            if (delay)
+            {
+                vx_enum type = 0;
+                vxQueryDelay(delay, VX_DELAY_ATTRIBUTE_TYPE, &type, sizeof(type));
+                if (type == VX_TYPE_MATRIX && IsMatrix3x3((vx_matrix)vxGetReferenceFromDelay(delay, 0)))
+                {
+                    status = VX_SUCCESS;
+                }
+                vxReleaseDelay(&delay);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    else if (index == 1)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_scalar scalar = 0;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+            if (scalar)
+            {
+                vx_enum stype = 0;
+                vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, &stype, sizeof(stype));
+                if (stype == VX_TYPE_UINT32)
+                {
+                    status = VX_SUCCESS;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_TYPE;
+                }
+                vxReleaseScalar(&scalar);
+            }
+            else
+            {
+                /* optional, the window starts at the newest slot by default */
+                status = VX_SUCCESS;
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    else if (index == 2)
+    {
+        /* the window has to fit into the delay */
+        vx_parameter dparam = vxGetParameterByIndex(node, 0);
+        vx_parameter sparam = vxGetParameterByIndex(node, 1);
+        vx_parameter param  = vxGetParameterByIndex(node, index);
+        if (dparam && sparam && param)
+        {
+            vx_delay  delay = 0;
+            vx_scalar sfirst = 0;
+            vx_array  coeffs = 0;
+            vxQueryParameter(dparam, VX_PARAMETER_ATTRIBUTE_REF, &delay, sizeof(delay));
+            vxQueryParameter(sparam, VX_PARAMETER_ATTRIBUTE_REF, &sfirst, sizeof(sfirst));
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &coeffs, sizeof(coeffs));
+            if (delay && coeffs)
+            {
+                vx_enum item_type = 0;
+                vx_size num_coeffs = 0;
+                vx_uint32 first = 0, count = 0;
+                if (sfirst)
+                    vxAccessScalarValue(sfirst, &first);
+                vxQueryDelay(delay, VX_DELAY_ATTRIBUTE_COUNT, &count, sizeof(count));
+                vxQueryArray(coeffs, VX_ARRAY_ATTRIBUTE_ITEMTYPE, &item_type, sizeof(item_type));
+                vxQueryArray(coeffs, VX_ARRAY_ATTRIBUTE_NUMITEMS, &num_coeffs, sizeof(num_coeffs));
+                if (item_type != VX_TYPE_FLOAT32)
+                {
+                    status = VX_ERROR_INVALID_TYPE;
+                }
+                else if ((num_coeffs % 2 == 1) && (num_coeffs <= 2 * SMOOTH_MAX_RADIUS + 1) &&
+                         (first + num_coeffs - 1 <= count))
+                {
+                    status = VX_SUCCESS;
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_VALUE;
+                }
+            }
+            if (delay)
+                vxReleaseDelay(&delay);
+            if (sfirst)
+                vxReleaseScalar(&sfirst);
+            if (coeffs)
+                vxReleaseArray(&coeffs);
+        }
+        if (dparam)
+            vxReleaseParameter(&dparam);
+        if (sparam)
+            vxReleaseParameter(&sparam);
+        if (param)
+            vxReleaseParameter(&param);
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK vxSmoothTrajectoryOutputValidator(vx_node node, vx_uint32 index, vx_meta_format_t *ptr)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    if (index == 3)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_matrix matrix = 0;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &matrix, sizeof(matrix));
+            if (matrix)
+            {
+                if (IsMatrix3x3(matrix))
+                {
+                    status = VX_SUCCESS;
+                }
+                vxReleaseMatrix(&matrix);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    return status;
+}
+
+static vx_param_description_t add_smooth_trajectory_kernel_params[] = {
+    {VX_INPUT,  VX_TYPE_DELAY,  VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_INPUT,  VX_TYPE_ARRAY,  VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_MATRIX, VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t add_smooth_trajectory_kernel = {
+    VX_ADD_KERNEL_SMOOTH_TRAJECTORY,
+    VX_ADD_KERNEL_NAME_SMOOTH_TRAJECTORY,
+    vxSmoothTrajectoryKernel,
+    add_smooth_trajectory_kernel_params, dimof(add_smooth_trajectory_kernel_params),
+    vxSmoothTrajectoryInputValidator,
+    vxSmoothTrajectoryOutputValidator,
+    vxSmoothTrajectoryInitializer,
+    NULL
+};
@@ -0,0 +1,13 @@
+#ifndef VX_WARP_RGB_H
+#define VX_WARP_RGB_H
+
+#include <VX/vx.h>
+
+/* Fills every pixel (x, y) of dst_image with src_image sampled at m * (x, y, 1),
+ * m is the row-major 3x3 homography from dst_image to src_image. The rows are
+ * split across the threads of the node, so the calling kernel must be row-separable,
+ * see vx_rows.h. */
+vx_status vxWarpPerspectiveRGBImage(vx_node node, vx_image src_image, vx_image dst_image, const vx_float32 m[9],
+                                    vx_enum type, const vx_border_mode_t *borders);
+
+#endif // VX_WARP_RGB_H
@@ -0,0 +1,252 @@
+#include "add_kernels.h"
+#include "vx_internal.h"
+#include "vx_warp_rgb.h"
+#include "vx_rows.h"
+
+/* The crop is centered and keeps the scale part of each side, as vxCutNode did in WarpGaussAndCutGraph */
+static void crop_rect(vx_uint32 width, vx_uint32 height, vx_float32 scale, vx_rectangle_t *rect)
+{
+    vx_uint32 sub_width  = (width * (1. - scale)) / 2.;
+    vx_uint32 sub_height = (height * (1. - scale)) / 2.;
+    rect->start_x = sub_width;
+    rect->start_y = sub_height;
+    rect->end_x   = width - sub_width;
+    rect->end_y   = height - sub_height;
+}
+
+static vx_status VX_CALLBACK vxWarpCutScaleRGBKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    vx_image  src_image = (vx_image) parameters[0];
+    vx_matrix matrix    = (vx_matrix)parameters[1];
+    vx_scalar stype     = (vx_scalar)parameters[2];
+    vx_scalar sscale    = (vx_scalar)parameters[3];
+    vx_image  dst_image = (vx_image) parameters[4];
+
+    vx_border_mode_t borders;
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_BORDER_MODE, &borders, sizeof(borders));
+
+    vx_status status = VX_SUCCESS;
+    vx_uint32 src_width, src_height, dst_width, dst_height;
+    vx_float32 *m = NULL, wm[9];
+    vx_float32 scale = 1.f;
+    vx_enum type = VX_INTERPOLATION_TYPE_BILINEAR;
+    vx_rectangle_t rect;
+    int r;
+
+    vxQueryImage(src_image, VX_IMAGE_ATTRIBUTE_WIDTH, &src_width, sizeof(src_width));
+    vxQueryImage(src_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &src_height, sizeof(src_height));
+    vxQueryImage(dst_image, VX_IMAGE_ATTRIBUTE_WIDTH, &dst_width, sizeof(dst_width));
+    vxQueryImage(dst_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &dst_height, sizeof(dst_height));
+
+    status |= vxMapMatrixInt(matrix, (void **)&m, VX_READ_ONLY);
+    if (stype)
+        status |= vxAccessScalarValue(stype, &type);
+    status |= vxAccessScalarValue(sscale, &scale);
+    if (status == VX_SUCCESS)
+    {
+        /* Output pixel centers map linearly onto the crop rectangle of the warped image,
+         * so the crop and the rescale are folded into the homography: wm = m * A with
+         * A = | rx 0  ox |
+         *     | 0  ry oy |
+         *     | 0  0  1  |
+         */
+        vx_float32 rx, ry, ox, oy;
+        crop_rect(src_width, src_height, scale, &rect);
+        rx = (vx_float32)(rect.end_x - rect.start_x) / dst_width;
+        ry = (vx_float32)(rect.end_y - rect.start_y) / dst_height;
+        ox = rect.start_x + 0.5f * rx - 0.5f;
+        oy = rect.start_y + 0.5f * ry - 0.5f;
+        for (r = 0; r < 3; r++)
+        {
+            wm[3 * r + 0] = m[3 * r + 0] * rx;
+            wm[3 * r + 1] = m[3 * r + 1] * ry;
+            wm[3 * r + 2] = m[3 * r + 0] * ox + m[3 * r + 1] * oy + m[3 * r + 2];
+        }
+        status = vxWarpPerspectiveRGBImage(node, src_image, dst_image, wm, type, &borders);
+    }
+    if (m)
+        vxUnmapMatrixInt(matrix, VX_READ_ONLY);
+
+    return status;
+}
+
+static vx_status VX_CALLBACK vxWarpCutScaleRGBInputValidator(vx_node node, vx_uint32 index)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    if (index == 0)
+    {
+        vx_image input = 0;
+        vx_parameter param = vxGetParameterByIndex(node, index);
+
+        vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &input, sizeof(input));
+        if (input)
+        {
+            vx_df_image format = 0;
+            vxQueryImage(input, VX_IMAGE_ATTRIBUTE_FORMAT, &format, sizeof(format));
+            if (format == VX_DF_IMAGE_RGB)
+            {
+                status = VX_SUCCESS;
+            }
+            vxReleaseImage(&input);
+        }
+        vxReleaseParameter(&param);
+    }
+    else if (index == 1)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_matrix matrix;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &matrix, sizeof(matrix));
+            if (matrix)
+            {
+                vx_enum data_type = 0;
+                vx_size rows = 0ul, columns = 0ul;
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_TYPE, &data_type, sizeof(data_type));
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_ROWS, &rows, sizeof(rows));
+                vxQueryMatrix(matrix, VX_MATRIX_ATTRIBUTE_COLUMNS, &columns, sizeof(columns));
+                if ((data_type == VX_TYPE_FLOAT32) && (columns == 3) && (rows == 3))
+                {
+                    status = VX_SUCCESS;
+                }
+                vxReleaseMatrix(&matrix);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    else if (index == 2)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_scalar scalar = 0;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+            if (scalar)
+            {
+                vx_enum stype = 0;
+                vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, &stype, sizeof(stype));
+                if (stype == VX_TYPE_ENUM)
+                {
+                    vx_enum interp = 0;
+                    vxAccessScalarValue(scalar, &interp);
+                    if ((interp == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR) ||
+                        (interp == VX_INTERPOLATION_TYPE_BILINEAR))
+                    {
+                        status = VX_SUCCESS;
+                    }
+                    else
+                    {
+                        status = VX_ERROR_INVALID_VALUE;
+                    }
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_TYPE;
+                }
+                vxReleaseScalar(&scalar);
+            }
+            else
+            {
+                /* optional, bilinear by default */
+                status = VX_SUCCESS;
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    else if (index == 3)
+    {
+        vx_parameter param = vxGetParameterByIndex(node, index);
+        if (param)
+        {
+            vx_scalar scalar = 0;
+            vxQueryParameter(param, VX_PARAMETER_ATTRIBUTE_REF, &scalar, sizeof(scalar));
+            if (scalar)
+            {
+                vx_enum stype = 0;
+                vxQueryScalar(scalar, VX_SCALAR_ATTRIBUTE_TYPE, &stype, sizeof(stype));
+                if (stype == VX_TYPE_FLOAT32)
+                {
+                    vx_float32 scale = 0.f;
+                    vxAccessScalarValue(scalar, &scale);
+                    if (scale > 0.f && scale <= 1.f)
+                    {
+                        status = VX_SUCCESS;
+                    }
+                    else
+                    {
+                        status = VX_ERROR_INVALID_VALUE;
+                    }
+                }
+                else
+                {
+                    status = VX_ERROR_INVALID_TYPE;
+                }
+                vxReleaseScalar(&scalar);
+            }
+            vxReleaseParameter(&param);
+        }
+    }
+    return status;
+}
+
+static vx_status VX_CALLBACK vxWarpCutScaleRGBOutputValidator(vx_node node, vx_uint32 index, vx_meta_format_t *ptr)
+{
+    vx_status status = VX_ERROR_INVALID_PARAMETERS;
+    if (index == 4)
+    {
+        vx_parameter src_param = vxGetParameterByIndex(node, 0);
+        vx_parameter dst_param = vxGetParameterByIndex(node, index);
+        if (src_param && dst_param)
+        {
+            vx_image src = 0, dst = 0;
+            vxQueryParameter(src_param, VX_PARAMETER_ATTRIBUTE_REF, &src, sizeof(src));
+            vxQueryParameter(dst_param, VX_PARAMETER_ATTRIBUTE_REF, &dst, sizeof(dst));
+            if (src && dst)
+            {
+                vx_uint32 w1 = 0, h1 = 0;
+
+                /* the crop is scaled back to the input size unless the output has its own */
+                vxQueryImage(dst, VX_IMAGE_ATTRIBUTE_WIDTH, &w1, sizeof(w1));
+                vxQueryImage(dst, VX_IMAGE_ATTRIBUTE_HEIGHT, &h1, sizeof(h1));
+                if (w1 == 0 || h1 == 0)
+                {
+                    vxQueryImage(src, VX_IMAGE_ATTRIBUTE_WIDTH, &w1, sizeof(w1));
+                    vxQueryImage(src, VX_IMAGE_ATTRIBUTE_HEIGHT, &h1, sizeof(h1));
+                }
+                ptr->type = VX_TYPE_IMAGE;
+                ptr->dim.image.format = VX_DF_IMAGE_RGB;
+                ptr->dim.image.width = w1;
+                ptr->dim.image.height = h1;
+                status = VX_SUCCESS;
+            }
+            if (src)
+                vxReleaseImage(&src);
+            if (dst)
+                vxReleaseImage(&dst);
+        }
+        if (src_param)
+            vxReleaseParameter(&src_param);
+        if (dst_param)
+            vxReleaseParameter(&dst_param);
+    }
+    return status;
+}
+
+static vx_param_description_t add_warp_cut_scale_rgb_kernel_params[] = {
+    {VX_INPUT,  VX_TYPE_IMAGE,  VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_MATRIX, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_IMAGE,  VX_PARAMETER_STATE_REQUIRED},
+};
+
+vx_kernel_description_t add_warp_cut_scale_rgb_kernel = {
+    VX_ADD_KERNEL_WARP_CUT_SCALE_RGB,
+    VX_ADD_KERNEL_NAME_WARP_CUT_SCALE_RGB,
+    vxWarpCutScaleRGBKernel,
+    add_warp_cut_scale_rgb_kernel_params, dimof(add_warp_cut_scale_rgb_kernel_params),
+    vxWarpCutScaleRGBInputValidator,
+    vxWarpCutScaleRGBOutputValidator,
+    vxRowsInitializer,
+    vxRowsDeinitializer
+};
@@ -1,19 +1,48 @@
 #include "add_kernels.h"
 #include "vx_internal.h"
+#include "vx_warp_rgb.h"
+#include "vx_rows.h"
 
-static vx_bool read_pixel(void *base, vx_imagepatch_addressing_t *addr,
-                          vx_float32 x, vx_float32 y, const vx_border_mode_t *borders, vx_uint32 *pixel)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WARP_USE_SSE2
+#endif
+
+/* The bilinear weights are fixed point with W_BITS fractional bits */
+#define W_BITS 11
+#define W_ONE  (1 << W_BITS)
+/* The horizontal sums lose H_SHIFT bits to fit the vertical pass in 16 bits */
+#define H_SHIFT 4
+
+/* Pixels whose coordinates are computed per iteration */
+#define WARP_BLOCK 8
+
+/* Everything a band of rows needs to be warped */
+typedef struct _warp_rgb_t {
+    const vx_uint8 *src;
+    vx_imagepatch_addressing_t src_addr;
+    vx_uint8 *dst;
+    vx_imagepatch_addressing_t dst_addr;
+    /* the homography from destination to source pixels */
+    vx_float32 m[9];
+    /* the start of the valid region of the source */
+    vx_float32 off_x, off_y;
+    vx_enum type;
+    const vx_border_mode_t *borders;
+} warp_rgb_t;
+
+static vx_bool read_pixel(const vx_uint8 *base, const vx_imagepatch_addressing_t *addr,
+                          vx_float32 x, vx_float32 y, const vx_border_mode_t *borders, vx_uint8 pixel[3])
 {
     vx_bool out_of_bounds = (x < 0 || y < 0 || x >= addr->dim_x || y >= addr->dim_y);
     vx_uint32 bx, by;
-    vx_uint32 *bpixel;
     if (out_of_bounds)
     {
         if (borders->mode == VX_BORDER_MODE_UNDEFINED)
             return vx_false_e;
         if (borders->mode == VX_BORDER_MODE_CONSTANT)
         {
-            *pixel = borders->constant_value;
+            memcpy(pixel, &borders->constant_value, 3);
             return vx_true_e;
         }
     }
@@ -21,30 +50,174 @@ static vx_bool read_pixel(void *base, vx_imagepatch_addressing_t *addr,
     bx = x < 0 ? 0 : x >= addr->dim_x ? addr->dim_x - 1 : (vx_uint32)x;
     by = y < 0 ? 0 : y >= addr->dim_y ? addr->dim_y - 1 : (vx_uint32)y;
 
-    bpixel = vxFormatImagePatchAddress2d(base, bx, by, addr);
-    *pixel = *bpixel;
-
+    memcpy(pixel, base + by * addr->stride_y + bx * addr->stride_x, 3);
     return vx_true_e;
 }
 
-static void transform_perspective(vx_uint32 dst_x, vx_uint32 dst_y, const vx_float32 m[], vx_float32 *src_x, vx_float32 *src_y)
+/* The reference path, used on spans touching the border and without SSE2 */
+static void warp_pixel(const warp_rgb_t *warp, vx_float32 xf, vx_float32 yf, vx_uint8 *dst)
+{
+    const vx_uint8 *src = warp->src;
+    const vx_imagepatch_addressing_t *addr = &warp->src_addr;
+    if (warp->type == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR)
+    {
+        read_pixel(src, addr, xf, yf, warp->borders, dst);
+    }
+    else if (warp->type == VX_INTERPOLATION_TYPE_BILINEAR)
+    {
+        vx_uint8 tl[3], tr[3], bl[3], br[3];
+        vx_bool defined = vx_true_e;
+        vx_uint32 c;
+        defined &= read_pixel(src, addr, floorf(xf), floorf(yf), warp->borders, tl);
+        defined &= read_pixel(src, addr, floorf(xf) + 1, floorf(yf), warp->borders, tr);
+        defined &= read_pixel(src, addr, floorf(xf), floorf(yf) + 1, warp->borders, bl);
+        defined &= read_pixel(src, addr, floorf(xf) + 1, floorf(yf) + 1, warp->borders, br);
+        if (defined)
+        {
+            vx_float32 ar = xf - floorf(xf);
+            vx_float32 ab = yf - floorf(yf);
+            vx_float32 al = 1.0f - ar;
+            vx_float32 at = 1.0f - ab;
+            for (c = 0; c < 3; c++)
+                dst[c] = tl[c] * al * at + tr[c] * ar * at + bl[c] * al * ab + br[c] * ar * ab;
+        }
+    }
+}
+
+#ifdef WARP_USE_SSE2
+/* Blends the 2x2 neighbourhood at top/bottom with the fixed point weights, returns
+ * the RGB result in the low bytes. The rows are read 8 bytes wide, so the caller
+ * makes sure one more pixel to the right exists.
+ */
+static vx_uint32 blend_pixel(const vx_uint8 *top, const vx_uint8 *bottom, __m128i wx, __m128i wy)
 {
-    vx_float32 z = dst_x * m[6] + dst_y * m[7] + m[8];
+    __m128i zero = _mm_setzero_si128();
+    /* [r0 g0 b0 r1 g1 b1 . .] -> [r0 r1 g0 g1 b0 b1 . .] */
+    __m128i t = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)top), zero);
+    __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)bottom), zero);
+    t = _mm_unpacklo_epi16(t, _mm_srli_si128(t, 6));
+    b = _mm_unpacklo_epi16(b, _mm_srli_si128(b, 6));
+    t = _mm_srai_epi32(_mm_madd_epi16(t, wx), H_SHIFT);
+    b = _mm_srai_epi32(_mm_madd_epi16(b, wx), H_SHIFT);
+    /* [t_r b_r t_g b_g t_b b_b . .] */
+    t = _mm_packs_epi32(t, b);
+    t = _mm_unpacklo_epi16(t, _mm_srli_si128(t, 8));
+    t = _mm_srai_epi32(_mm_madd_epi16(t, wy), 2 * W_BITS - H_SHIFT);
+    t = _mm_packs_epi32(t, t);
+    return (vx_uint32)_mm_cvtsi128_si32(_mm_packus_epi16(t, t));
+}
 
-    *src_x = (dst_x * m[0] + dst_y * m[1] + m[2]) / z;
-    *src_y = (dst_x * m[3] + dst_y * m[4] + m[5]) / z;
+/* packs a pair of 16 bit weights for _mm_madd_epi16 */
+static __m128i weight_pair(vx_int32 w)
+{
+    return _mm_set1_epi32(((vx_uint32)w << 16) | (vx_uint32)(W_ONE - w));
 }
 
-static vx_status VX_CALLBACK vxWarpPerspectiveRGBKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
+/* Warps the pixels [x, x + WARP_BLOCK) of a row, returns vx_false_e without
+ * writing anything when one of them needs the border.
+ */
+static vx_bool warp_block(const warp_rgb_t *warp, vx_uint32 x, vx_uint32 y, vx_uint8 *dst)
 {
-    vx_image  src_image = (vx_image) parameters[0];
-    vx_matrix matrix    = (vx_matrix)parameters[1];
-    vx_scalar stype     = (vx_scalar)parameters[2];
-    vx_image  dst_image = (vx_image) parameters[3];
+    const vx_float32 *m = warp->m;
+    const vx_uint8 *src = warp->src;
+    vx_int32 stride = warp->src_addr.stride_y;
+    vx_int32 ix[WARP_BLOCK], iy[WARP_BLOCK], fx[WARP_BLOCK], fy[WARP_BLOCK];
+    __m128 ramp = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+    __m128 lim_x = _mm_set1_ps((vx_float32)warp->src_addr.dim_x - 2.f);
+    __m128 lim_y = _mm_set1_ps((vx_float32)warp->src_addr.dim_y - 1.f);
+    __m128 w_one = _mm_set1_ps((vx_float32)W_ONE);
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 zero = _mm_setzero_ps();
+    vx_float32 fy0 = (vx_float32)y;
+    vx_uint32 i;
+    int inside = 0xF;
 
-    vx_border_mode_t borders;
-    vxQueryNode(node, VX_NODE_ATTRIBUTE_BORDER_MODE, &borders, sizeof(borders));
+    for (i = 0; i < WARP_BLOCK; i += 4)
+    {
+        __m128 vx = _mm_add_ps(_mm_set1_ps((vx_float32)(x + i)), ramp);
+        /* summed in the order of the reference path, nearest neighbour is exact then */
+        __m128 X = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(m[0])), _mm_set1_ps(fy0 * m[1])), _mm_set1_ps(m[2]));
+        __m128 Y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(m[3])), _mm_set1_ps(fy0 * m[4])), _mm_set1_ps(m[5]));
+        __m128 Z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(m[6])), _mm_set1_ps(fy0 * m[7])), _mm_set1_ps(m[8]));
+        __m128 xs = _mm_sub_ps(_mm_div_ps(X, Z), _mm_set1_ps(warp->off_x));
+        __m128 ys = _mm_sub_ps(_mm_div_ps(Y, Z), _mm_set1_ps(warp->off_y));
+        __m128i xi, yi;
+        /* x + 1 is read 8 bytes wide and y + 1 is read, NaN fails as well */
+        inside &= _mm_movemask_ps(_mm_and_ps(_mm_and_ps(_mm_cmpge_ps(xs, zero), _mm_cmplt_ps(xs, lim_x)),
+                                             _mm_and_ps(_mm_cmpge_ps(ys, zero), _mm_cmplt_ps(ys, lim_y))));
+        if (inside != 0xF)
+            return vx_false_e;
+        xi = _mm_cvttps_epi32(xs);
+        yi = _mm_cvttps_epi32(ys);
+        _mm_storeu_si128((__m128i *)&ix[i], xi);
+        _mm_storeu_si128((__m128i *)&iy[i], yi);
+        xs = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(xs, _mm_cvtepi32_ps(xi)), w_one), half);
+        ys = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(ys, _mm_cvtepi32_ps(yi)), w_one), half);
+        _mm_storeu_si128((__m128i *)&fx[i], _mm_cvttps_epi32(xs));
+        _mm_storeu_si128((__m128i *)&fy[i], _mm_cvttps_epi32(ys));
+    }
+
+    for (i = 0; i < WARP_BLOCK; i++)
+    {
+        const vx_uint8 *top = src + iy[i] * stride + ix[i] * 3;
+        if (warp->type == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR)
+        {
+            memcpy(&dst[3 * i], top, 3);
+        }
+        else
+        {
+            vx_uint32 rgb = blend_pixel(top, top + stride, weight_pair(fx[i]), weight_pair(fy[i]));
+            memcpy(&dst[3 * i], &rgb, 3);
+        }
+    }
+    return vx_true_e;
+}
+#endif
+
+/* Warps the rows [start_y, end_y) of the destination */
+static vx_status warp_rows(void *arg, vx_uint32 start_y, vx_uint32 end_y)
+{
+    const warp_rgb_t *warp = (const warp_rgb_t *)arg;
+    const vx_float32 *m = warp->m;
+    vx_uint32 width = warp->dst_addr.dim_x;
+    vx_uint32 x, y;
+    for (y = start_y; y < end_y; y++)
+    {
+        vx_uint8 *dst = warp->dst + y * warp->dst_addr.stride_y;
+        /* the homogeneous coordinates step by the first column of m along a row */
+        vx_float32 X = y * m[1], Y = y * m[4], Z = y * m[7];
+        x = 0;
+#ifdef WARP_USE_SSE2
+        if (warp->dst_addr.stride_x == 3 && warp->src_addr.stride_x == 3)
+        {
+            for (; x + WARP_BLOCK <= width; x += WARP_BLOCK)
+            {
+                if (warp_block(warp, x, y, &dst[3 * x]) == vx_false_e)
+                {
+                    vx_uint32 i;
+                    for (i = x; i < x + WARP_BLOCK; i++)
+                    {
+                        vx_float32 z = i * m[6] + Z + m[8];
+                        warp_pixel(warp, (i * m[0] + X + m[2]) / z - warp->off_x, (i * m[3] + Y + m[5]) / z - warp->off_y,
+                                   &dst[i * warp->dst_addr.stride_x]);
+                    }
+                }
+            }
+        }
+#endif
+        for (; x < width; x++)
+        {
+            vx_float32 z = x * m[6] + Z + m[8];
+            warp_pixel(warp, (x * m[0] + X + m[2]) / z - warp->off_x, (x * m[3] + Y + m[5]) / z - warp->off_y,
+                       &dst[x * warp->dst_addr.stride_x]);
+        }
+    }
+    return VX_SUCCESS;
+}
 
+vx_status vxWarpPerspectiveRGBImage(vx_node node, vx_image src_image, vx_image dst_image, const vx_float32 m[9],
+                                    vx_enum type, const vx_border_mode_t *borders)
+{
     vx_status status = VX_SUCCESS;
     void *src_base = NULL;
     void *dst_base = NULL;
@@ -53,11 +226,6 @@ static vx_status VX_CALLBACK vxWarpPerspectiveRGBKernel(vx_node node, vx_referen
     vx_rectangle_t src_rect;
     vx_rectangle_t dst_rect;
 
-    vx_float32 m[9];
-    vx_enum type = 0;
-
-    vx_uint32 y = 0u, x = 0u;
-
     vxQueryImage(dst_image, VX_IMAGE_ATTRIBUTE_WIDTH, &dst_width, sizeof(dst_width));
     vxQueryImage(dst_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &dst_height, sizeof(dst_height));
 
@@ -67,63 +235,109 @@ static vx_status VX_CALLBACK vxWarpPerspectiveRGBKernel(vx_node node, vx_referen
     dst_rect.end_x = dst_width;
     dst_rect.end_y = dst_height;
 
-    status |= vxAccessImagePatch(src_image, &src_rect, 0, &src_addr, &src_base, VX_READ_ONLY);
-    status |= vxAccessImagePatch(dst_image, &dst_rect, 0, &dst_addr, &dst_base, VX_WRITE_ONLY);
-
-    status |= vxAccessMatrix(matrix, m);
-    status |= vxAccessScalarValue(stype, &type);
+    status |= vxMapImagePatchInt(src_image, &src_rect, 0, &src_addr, &src_base, VX_READ_ONLY);
+    status |= vxMapImagePatchInt(dst_image, &dst_rect, 0, &dst_addr, &dst_base, VX_WRITE_ONLY);
 
     if (status == VX_SUCCESS)
     {
-        for (y = 0u; y < dst_addr.dim_y; y++)
-        {
-            for (x = 0u; x < dst_addr.dim_x; x++)
-            {
-                vx_uint32 *dst = vxFormatImagePatchAddress2d(dst_base, x, y, &dst_addr);
+        warp_rgb_t warp;
+        warp.src = (const vx_uint8 *)src_base;
+        warp.src_addr = src_addr;
+        warp.dst = (vx_uint8 *)dst_base;
+        warp.dst_addr = dst_addr;
+        memcpy(warp.m, m, sizeof(warp.m));
+        warp.off_x = (vx_float32)src_rect.start_x;
+        warp.off_y = (vx_float32)src_rect.start_y;
+        warp.type = type;
+        warp.borders = borders;
+        status = vxRowsParallelFor(node, dst_addr.dim_y, warp_rows, &warp);
+        vxUnmapImagePatchInt(dst_image, &dst_rect, VX_WRITE_ONLY);
+    }
+    return status;
+}
 
-                vx_float32 xf;
-                vx_float32 yf;
-                transform_perspective(x, y, m, &xf, &yf);
-                xf -= (vx_float32)src_rect.start_x;
-                yf -= (vx_float32)src_rect.start_y;
+static vx_status VX_CALLBACK vxWarpPerspectiveRGBKernel(vx_node node, vx_reference *parameters, vx_uint32 num)
+{
+    vx_image  src_image = (vx_image) parameters[0];
+    vx_matrix matrix    = (vx_matrix)parameters[1];
+    vx_scalar stype     = (vx_scalar)parameters[2];
+    vx_image  dst_image = (vx_image) parameters[3];
 
-                if (type == VX_INTERPOLATION_TYPE_NEAREST_NEIGHBOR)
-                {
-                    read_pixel(src_base, &src_addr, xf, yf, &borders, dst);
-                }
-                else if (type == VX_INTERPOLATION_TYPE_BILINEAR)
-                {
-                    vx_uint32 tl = 0, tr = 0, bl = 0, br = 0;
-                    vx_bool defined = vx_true_e;
-                    defined &= read_pixel(src_base, &src_addr, floorf(xf), floorf(yf), &borders, &tl);
-                    defined &= read_pixel(src_base, &src_addr, floorf(xf) + 1, floorf(yf), &borders, &tr);
-                    defined &= read_pixel(src_base, &src_addr, floorf(xf), floorf(yf) + 1, &borders, &bl);
-                    defined &= read_pixel(src_base, &src_addr, floorf(xf) + 1, floorf(yf) + 1, &borders, &br);
-                    if (defined)
-                    {
-                        vx_float32 ar = xf - floorf(xf);
-                        vx_float32 ab = yf - floorf(yf);
-                        vx_float32 al = 1.0f - ar;
-                        vx_float32 at = 1.0f - ab;
-                        vx_uint8* dst8 = (vx_uint8*)dst;
-                        vx_uint8 *tl8 = (vx_uint8*)&tl, *tr8 = (vx_uint8*)&tr,
-                                 *bl8 = (vx_uint8*)&bl, *br8 = (vx_uint8*)&br;
-                        dst8[0] = tl8[0] * al * at + tr8[0] * ar * at + bl8[0] * al * ab + br8[0] * ar * ab;
-                        dst8[1] = tl8[1] * al * at + tr8[1] * ar * at + bl8[1] * al * ab + br8[1] * ar * ab;
-                        dst8[2] = tl8[2] * al * at + tr8[2] * ar * at + bl8[2] * al * ab + br8[2] * ar * ab;
-                    }
-                }
-            }
-        }
-    }
+    vx_border_mode_t borders;
+    vxQueryNode(node, VX_NODE_ATTRIBUTE_BORDER_MODE, &borders, sizeof(borders));
 
-    status |= vxCommitMatrix(matrix, m);
-    status |= vxCommitImagePatch(src_image, NULL, 0, &src_addr, src_base);
-    status |= vxCommitImagePatch(dst_image, &dst_rect, 0, &dst_addr, dst_base);
+    vx_status status = VX_SUCCESS;
+    vx_float32 *m = NULL;
+    vx_enum type = 0;
+
+    status |= vxMapMatrixInt(matrix, (void **)&m, VX_READ_ONLY);
+    status |= vxAccessScalarValue(stype, &type);
+    if (status == VX_SUCCESS)
+        status = vxWarpPerspectiveRGBImage(node, src_image, dst_image, m, type, &borders);
+    if (m)
+        vxUnmapMatrixInt(matrix, VX_READ_ONLY);
 
     return status;
 }
 
+/* The homography maps a band of the destination to a quadrilateral of the source, which is
+ * bounded by its corners unless a part of it is mapped through infinity */
+vx_status VX_CALLBACK vxWarpPerspectiveRGBInputRows(vx_node node, const vx_reference parameters[], vx_uint32 index,
+                                                    vx_uint32 start_y, vx_uint32 end_y,
+                                                    vx_uint32 *in_start_y, vx_uint32 *in_end_y)
+{
+    vx_image  src_image = (vx_image) parameters[0];
+    vx_matrix matrix    = (vx_matrix)parameters[1];
+    vx_image  dst_image = (vx_image) parameters[3];
+    vx_uint32 src_height = 0, dst_width = 0;
+    vx_float32 *m = NULL;
+    vx_float32 min_y = 0.f, max_y = 0.f, z0 = 0.f;
+    vx_bool bounded = vx_true_e;
+    vx_status status = VX_SUCCESS;
+    int c;
+
+    status |= vxQueryImage(src_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &src_height, sizeof(src_height));
+    status |= vxQueryImage(dst_image, VX_IMAGE_ATTRIBUTE_WIDTH, &dst_width, sizeof(dst_width));
+    status |= vxMapMatrixInt(matrix, (void **)&m, VX_READ_ONLY);
+    *in_start_y = 0;
+    *in_end_y = src_height;
+    if (status != VX_SUCCESS || dst_width == 0 || end_y <= start_y)
+        return status;
+
+    for (c = 0; c < 4 && bounded; c++)
+    {
+        vx_float32 x = (c & 1) ? (vx_float32)(dst_width - 1) : 0.f;
+        vx_float32 y = (c & 2) ? (vx_float32)(end_y - 1) : (vx_float32)start_y;
+        vx_float32 z = x * m[6] + y * m[7] + m[8];
+        vx_float32 sy = (x * m[3] + y * m[4] + m[5]) / z;
+        if (c == 0)
+            z0 = z;
+        /* a corner on the horizon, corners on both sides of it or NaN */
+        if (!(z > 0.f || z < 0.f) || ((z > 0.f) != (z0 > 0.f)) || !(sy == sy))
+        {
+            bounded = vx_false_e;
+        }
+        else
+        {
+            if (c == 0 || sy < min_y)
+                min_y = sy;
+            if (c == 0 || sy > max_y)
+                max_y = sy;
+        }
+    }
+    vxUnmapMatrixInt(matrix, VX_READ_ONLY);
+
+    if (bounded)
+    {
+        /* the bilinear interpolation reads the next row, and one more row on either side
+         * covers the rounding of the float coordinates */
+        min_y = floorf(min_y) - 1.f;
+        max_y = floorf(max_y) + 3.f;
+        *in_start_y = min_y <= 0.f ? 0 : min_y >= src_height ? src_height : (vx_uint32)min_y;
+        *in_end_y = max_y <= 0.f ? 0 : max_y >= src_height ? src_height : (vx_uint32)max_y;
+    }
+    return status;
+}
 
 static vx_status VX_CALLBACK vxWarpPerspectiveRGBInputValidator(vx_node node, vx_uint32 index)
 {
@@ -256,6 +470,7 @@ vx_kernel_description_t add_warp_perspective_rgb_kernel = {
     add_warp_perspective_rgb_kernel_params, dimof(add_warp_perspective_rgb_kernel_params),
     vxWarpPerspectiveRGBInputValidator,
     vxWarpPerspectiveRGBOutputValidator,
-    NULL, NULL
+    vxRowsInitializer,
+    vxRowsDeinitializer
 };
 
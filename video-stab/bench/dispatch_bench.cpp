@@ -0,0 +1,156 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+
+#include "vx_module.h"
+#include "vx_internal.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double ElapsedNS(bench_clock::time_point begin)
+{
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - begin).count();
+}
+
+/* The work of an item: count it and spin for v2 iterations */
+static vx_bool CountItem(vx_threadpool_worker_t* worker)
+{
+    volatile vx_int32* done = (volatile vx_int32*)worker->data->v1;
+    for(volatile vx_value_t i = 0; i < worker->data->v2; i++)
+        ;
+    vxAtomicAdd(done, 1);
+    return vx_true_e;
+}
+
+/* Issues iterations rounds of batch items and waits for each round, ns is the time per item.
+ * Fails when a round comes back complete before all its items ran. */
+static vx_status TimeDispatch(vx_threadpool_t* pool, std::vector<vx_value_set_t>& items,
+                              vx_uint32 iterations, volatile vx_int32& done, double& ns)
+{
+    vx_int32 expected = vxAtomicLoad(&done);
+    bench_clock::time_point begin = bench_clock::now();
+    for(vx_uint32 i = 0; i < iterations; i++)
+    {
+        if(vxIssueThreadpool(pool, &items[0], (uint32_t)items.size()) == vx_false_e)
+            return VX_ERROR_NO_RESOURCES;
+        vxCompleteThreadpool(pool, vx_true_e);
+        expected += (vx_int32)items.size();
+        if(vxAtomicLoad(&done) != expected)
+        {
+            printf("round %u completed with %d of its %u tasks not run\n",
+                   i, expected - vxAtomicLoad(&done), (vx_uint32)items.size());
+            return VX_FAILURE;
+        }
+    }
+    ns = ElapsedNS(begin) / ((double)iterations * items.size());
+    return VX_SUCCESS;
+}
+
+/* Several threads issue batches to the same pool at once, each with its own count */
+static vx_status TimeConcurrentDispatch(vx_threadpool_t* pool, vx_value_set_t item, vx_uint32 batch,
+                                        vx_uint32 issuers, vx_uint32 iterations, double& ns)
+{
+    std::vector<vx_int32> done(issuers, 0);
+    std::vector<vx_status> status(issuers, VX_SUCCESS);
+    std::vector<double> issuer_ns(issuers, 0.0);
+    std::vector<std::thread> threads;
+    for(vx_uint32 t = 0; t < issuers; t++)
+        threads.push_back(std::thread([&, t]()
+        {
+            vx_value_set_t own = item;
+            own.v1 = (vx_value_t)&done[t];
+            std::vector<vx_value_set_t> items(batch, own);
+            status[t] = TimeDispatch(pool, items, iterations, done[t], issuer_ns[t]);
+        }));
+    for(vx_uint32 t = 0; t < issuers; t++)
+        threads[t].join();
+    ns = 0.0;
+    for(vx_uint32 t = 0; t < issuers; t++)
+    {
+        if(status[t] != VX_SUCCESS)
+            return status[t];
+        ns += issuer_ns[t] / issuers;
+    }
+    return VX_SUCCESS;
+}
+
+static void Usage(const char* name)
+{
+    printf("Usage: %s [--workers N] [--batch N] [--work N] [--issuers N] [--iterations N]\n", name);
+    printf("Reports the time per task from issue to completion in the round robin and the work stealing\n");
+    printf("pools, for single tasks and for batches, default 4 workers, batches of 64 and empty tasks.\n");
+    printf("With several issuers they also issue batches at once, each checking its own batches complete.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    vx_uint32 workers = 4;
+    vx_uint32 batch = 64;
+    vx_uint32 work = 0;
+    vx_uint32 issuers = 1;
+    vx_uint32 iterations = 100000;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--workers" && i + 1 < argc)
+            workers = atoi(argv[++i]);
+        else if(arg == "--batch" && i + 1 < argc)
+            batch = atoi(argv[++i]);
+        else if(arg == "--work" && i + 1 < argc)
+            work = atoi(argv[++i]);
+        else if(arg == "--issuers" && i + 1 < argc)
+            issuers = atoi(argv[++i]);
+        else if(arg == "--iterations" && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    /* a round must fit in the queues of the workers */
+    if(workers < 1 || workers > VX_INT_MAX_WORKERS || batch < 1 || batch * issuers > workers * VX_INT_MAX_QUEUE_DEPTH || issuers < 1)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    const vx_enum types[] = { VX_THREADPOOL_ROUND_ROBIN, VX_THREADPOOL_WORK_STEALING };
+    const char* names[] = { "round robin", "work stealing" };
+    printf("%u workers, %u spins per task\n", workers, work);
+    for(vx_uint32 t = 0; t < dimof(types); t++)
+    {
+        volatile vx_int32 done = 0;
+        vx_value_set_t item;
+        item.v1 = (vx_value_t)&done;
+        item.v2 = (vx_value_t)work;
+        item.v3 = 0;
+        std::vector<vx_value_set_t> single(1, item);
+        std::vector<vx_value_set_t> items(batch, item);
+
+        vx_threadpool_t* pool = vxCreateThreadpool(types[t], workers, VX_INT_MAX_QUEUE_DEPTH,
+                                                   sizeof(vx_work_t), CountItem, NULL);
+        CHECK_NULL(pool);
+        double single_ns = 0.0, batch_ns = 0.0;
+        /* warm the threads up before measuring */
+        CHECK_STATUS( TimeDispatch(pool, items, iterations / 100 + 1, done, batch_ns) );
+        CHECK_STATUS( TimeDispatch(pool, single, iterations, done, single_ns) );
+        CHECK_STATUS( TimeDispatch(pool, items, iterations / batch + 1, done, batch_ns) );
+        printf("%-14s single task %8.1f ns, batch of %u %7.1f ns per task\n",
+               names[t], single_ns, batch, batch_ns);
+        if(issuers > 1)
+        {
+            double concurrent_ns = 0.0;
+            CHECK_STATUS( TimeConcurrentDispatch(pool, item, batch, issuers, iterations / batch + 1, concurrent_ns) );
+            printf("%-14s %u issuers at once, batch of %u %7.1f ns per task\n",
+                   names[t], issuers, batch, concurrent_ns);
+        }
+        vxDestroyThreadpool(&pool);
+    }
+    return 0;
+}
@@ -0,0 +1,298 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+
+#include <sys/resource.h>
+
+#include "vx_module.h"
+
+/* Amplitude of the synthetic camera shake, in pixels */
+#define SHAKE 16
+/* Size of the texture cells, gives FAST plenty of corners */
+#define CELL 8
+
+struct BenchSize
+{
+    const char* name;
+    vx_uint32   width;
+    vx_uint32   height;
+};
+
+static const BenchSize SIZES[] = {
+    {"720p",  1280, 720},
+    {"1080p", 1920, 1080},
+    {"4k",    3840, 2160},
+};
+
+struct BenchResult
+{
+    const BenchSize*      size;
+    vx_uint32             frames;
+    double                total_ms;
+    double                p50_ms;
+    double                p99_ms;
+    long                  peak_rss_kb;
+    std::vector<NodePerf> nodes;
+    std::vector<NodePerf> warmup;
+    /* Shortest run of each node in the measured frames */
+    std::vector<vx_uint64> min_ns;
+};
+
+/* Blocky random RGB texture larger than the frame by the shake on each side */
+static void MakeTexture(std::vector<vx_uint8>& texture, vx_uint32 width, vx_uint32 height)
+{
+    vx_uint32 seed = 12345;
+    vx_uint32 cells_x = (width + CELL - 1) / CELL;
+    vx_uint32 cells_y = (height + CELL - 1) / CELL;
+    std::vector<vx_uint8> cells(cells_x * cells_y * 3);
+    for(size_t i = 0; i < cells.size(); i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+        cells[i] = (vx_uint8)(seed >> 24);
+    }
+    texture.resize(width * height * 3);
+    for(vx_uint32 y = 0; y < height; y++)
+        for(vx_uint32 x = 0; x < width; x++)
+            memcpy(&texture[(y * width + x) * 3], &cells[((y / CELL) * cells_x + x / CELL) * 3], 3);
+}
+
+/* Copies the window of the texture shifted by the shake of the frame into image */
+static vx_status FillFrame(vx_image image, const std::vector<vx_uint8>& texture,
+                           vx_uint32 width, vx_uint32 height, vx_uint32 frame)
+{
+    vx_uint32 tex_width = width + 2 * SHAKE;
+    /* slow pan with a fast jitter on top */
+    vx_int32 dx = (vx_int32)((frame * 7) % (2 * SHAKE + 1)) - SHAKE;
+    vx_int32 dy = (vx_int32)((frame * 5 + frame / 3) % (2 * SHAKE + 1)) - SHAKE;
+
+    vx_rectangle_t rect = {0, 0, width, height};
+    vx_imagepatch_addressing_t addr;
+    void* ptr = NULL;
+    CHECK_STATUS( vxAccessImagePatch(image, &rect, 0, &addr, &ptr, VX_WRITE_ONLY) );
+    for(vx_uint32 y = 0; y < height; y++)
+    {
+        const vx_uint8* src = &texture[((y + SHAKE + dy) * tex_width + SHAKE + dx) * 3];
+        vx_uint8* dst = (vx_uint8*)vxFormatImagePatchAddress2d(ptr, 0, y, &addr);
+        memcpy(dst, src, width * 3);
+    }
+    CHECK_STATUS( vxCommitImagePatch(image, &rect, 0, &addr, ptr) );
+    return VX_SUCCESS;
+}
+
+static double Percentile(std::vector<double> values, double p)
+{
+    if(values.empty())
+        return 0.;
+    std::sort(values.begin(), values.end());
+    size_t idx = (size_t)(p * (values.size() - 1) + 0.5);
+    return values[idx];
+}
+
+/* Every node runs at most once per frame, so a node which ran since the last query took
+ * perf.tmp for its run of this frame */
+static vx_status UpdateMinimum(VXVideoStab& vstub, std::vector<NodePerf>& last, std::vector<vx_uint64>& min_ns)
+{
+    std::vector<NodePerf> now;
+    CHECK_STATUS( vstub.QueryPerformance(now) );
+    min_ns.resize(now.size(), 0);
+    for(size_t n = 0; n < now.size(); n++)
+    {
+        const vx_perf_t& perf = now[n].node.perf;
+        vx_uint64 runs = n < last.size() ? last[n].node.perf.num : 0;
+        if(perf.num > runs && (min_ns[n] == 0 || perf.tmp < min_ns[n]))
+            min_ns[n] = perf.tmp;
+    }
+    last.swap(now);
+    return VX_SUCCESS;
+}
+
+static vx_status RunSize(const BenchSize& size, vx_uint32 warmup, vx_uint32 frames,
+                         vx_bool pipelined, BenchResult& result)
+{
+    typedef std::chrono::steady_clock clock;
+
+    std::vector<vx_uint8> texture;
+    MakeTexture(texture, size.width + 2 * SHAKE, size.height + 2 * SHAKE);
+
+    VXVideoStab vstub;
+    VideoStabParams vs_params;
+    InitParams(size.width, size.height, vs_params);
+    vs_params.pipelined = pipelined;
+    CHECK_STATUS( vstub.CreatePipeline(size.width, size.height, vs_params) );
+
+    std::vector<double> latency;
+    latency.reserve(frames);
+    std::vector<NodePerf> last;
+    clock::time_point start;
+    for(vx_uint32 i = 0; i < warmup + frames; i++)
+    {
+        if(i == warmup)
+        {
+            CHECK_STATUS( vstub.QueryPerformance(result.warmup) );
+            last = result.warmup;
+            start = clock::now();
+        }
+        clock::time_point begin = clock::now();
+        vx_image image = vstub.NewImage();
+        CHECK_NULL(image);
+        CHECK_STATUS( FillFrame(image, texture, size.width, size.height, i) );
+        vx_image out = vstub.Calculate();
+        /* the first frames only fill the smoothing window */
+        if(out == NULL && i >= warmup)
+        {
+            printf("No output for frame %u, increase the warmup\n", i);
+            return VX_FAILURE;
+        }
+        if(i >= warmup)
+        {
+            latency.push_back(std::chrono::duration<double, std::milli>(clock::now() - begin).count());
+            /* perf.min of the graphs would include the warmup runs */
+            CHECK_STATUS( UpdateMinimum(vstub, last, result.min_ns) );
+        }
+    }
+    vstub.Flush();
+    result.total_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    CHECK_STATUS( UpdateMinimum(vstub, last, result.min_ns) );
+    CHECK_STATUS( vstub.QueryPerformance(result.nodes) );
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.size        = &size;
+    result.frames      = frames;
+    result.p50_ms      = Percentile(latency, 0.50);
+    result.p99_ms      = Percentile(latency, 0.99);
+    result.peak_rss_kb = usage.ru_maxrss;
+    return VX_SUCCESS;
+}
+
+static double ToMS(vx_uint64 ns)
+{
+    return (double)ns / 1000000.;
+}
+
+static void WriteJSON(FILE* file, const std::vector<BenchResult>& results, vx_bool pipelined)
+{
+    fprintf(file, "{\n  \"pipelined\": %s,\n  \"runs\": [\n", pipelined ? "true" : "false");
+    for(size_t r = 0; r < results.size(); r++)
+    {
+        const BenchResult& res = results[r];
+        fprintf(file, "    {\n");
+        fprintf(file, "      \"size\": \"%s\",\n", res.size->name);
+        fprintf(file, "      \"width\": %u,\n      \"height\": %u,\n", res.size->width, res.size->height);
+        fprintf(file, "      \"frames\": %u,\n", res.frames);
+        fprintf(file, "      \"fps\": %.3f,\n", res.total_ms > 0. ? res.frames * 1000. / res.total_ms : 0.);
+        fprintf(file, "      \"latency_p50_ms\": %.3f,\n", res.p50_ms);
+        fprintf(file, "      \"latency_p99_ms\": %.3f,\n", res.p99_ms);
+        fprintf(file, "      \"peak_rss_kb\": %ld,\n", res.peak_rss_kb);
+        fprintf(file, "      \"nodes\": [\n");
+        for(size_t n = 0; n < res.nodes.size(); n++)
+        {
+            /* only the measured frames, the warmup runs are subtracted */
+            const vx_perf_t& perf = res.nodes[n].node.perf;
+            vx_uint64 sum = perf.sum, num = perf.num;
+            vx_uint64 min = n < res.min_ns.size() ? res.min_ns[n] : 0;
+            if(n < res.warmup.size())
+            {
+                sum -= res.warmup[n].node.perf.sum;
+                num -= res.warmup[n].node.perf.num;
+            }
+            fprintf(file, "        {\"graph\": \"%s\", \"kernel\": \"%s\", \"runs\": %llu, "
+                          "\"avg_ms\": %.4f, \"min_ms\": %.4f, \"sum_ms\": %.3f}%s\n",
+                    res.nodes[n].graph, res.nodes[n].node.name, (unsigned long long)num,
+                    num ? ToMS(sum / num) : 0., num ? ToMS(min) : 0., ToMS(sum),
+                    n + 1 < res.nodes.size() ? "," : "");
+        }
+        fprintf(file, "      ]\n    }%s\n", r + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+static void Usage(const char* name)
+{
+    printf("Usage: %s [--size 720p|1080p|4k|WxH]... [--frames N] [--warmup N] [--pipelined] [--json FILE]\n", name);
+    printf("Feeds synthetic shaking frames into the stabilizer and reports fps, latency, node times and peak RSS.\n");
+    printf("Sizes run in the given order, default 720p 1080p 4k; peak RSS is the process peak so far.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<BenchSize> sizes;
+    std::vector<std::string> names;
+    vx_uint32 frames = 100;
+    vx_uint32 warmup = 0;
+    vx_bool pipelined = vx_false_e;
+    const char* json = "vx_videostab_bench.json";
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--size" && i + 1 < argc)
+        {
+            std::string name = argv[++i];
+            BenchSize size = {NULL, 0, 0};
+            for(size_t s = 0; s < dimof(SIZES); s++)
+                if(name == SIZES[s].name)
+                    size = SIZES[s];
+            if(size.name == NULL && sscanf(name.c_str(), "%ux%u", &size.width, &size.height) != 2)
+            {
+                Usage(argv[0]);
+                return 1;
+            }
+            names.push_back(name);
+            sizes.push_back(size);
+        }
+        else if(arg == "--frames" && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else if(arg == "--warmup" && i + 1 < argc)
+            warmup = atoi(argv[++i]);
+        else if(arg == "--pipelined")
+            pipelined = vx_true_e;
+        else if(arg == "--json" && i + 1 < argc)
+            json = argv[++i];
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if(sizes.empty())
+        sizes.assign(SIZES, SIZES + dimof(SIZES));
+    /* the name of a WxH size points into names, which is not resized anymore */
+    for(size_t s = 0; s < names.size(); s++)
+        if(sizes[s].name == NULL)
+            sizes[s].name = names[s].c_str();
+
+    std::vector<BenchResult> results(sizes.size());
+    for(size_t s = 0; s < sizes.size(); s++)
+    {
+        /* until the smoothing window is full Calculate gives no frame */
+        VideoStabParams vs_params;
+        InitParams(sizes[s].width, sizes[s].height, vs_params);
+        vx_uint32 fill = vs_params.warp_gauss.gauss_size * 2 + (pipelined ? 1 : 0);
+        vx_uint32 skip = warmup > fill ? warmup : fill;
+
+        printf("%s: %ux%u, %u frames after %u warmup\n", sizes[s].name, sizes[s].width, sizes[s].height, frames, skip);
+        if(RunSize(sizes[s], skip, frames, pipelined, results[s]) != VX_SUCCESS)
+        {
+            printf("Benchmark of %s failed\n", sizes[s].name);
+            return 1;
+        }
+        printf("%s: %.2f fps, p50 %.2f ms, p99 %.2f ms, peak RSS %ld KB\n", sizes[s].name,
+               results[s].frames * 1000. / results[s].total_ms, results[s].p50_ms, results[s].p99_ms,
+               results[s].peak_rss_kb);
+    }
+
+    FILE* file = fopen(json, "w");
+    if(file == NULL)
+    {
+        printf("Can't open %s\n", json);
+        return 1;
+    }
+    WriteJSON(file, results, pipelined);
+    fclose(file);
+    return 0;
+}
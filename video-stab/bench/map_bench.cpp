@@ -0,0 +1,107 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include "vx_module.h"
+#include "vx_internal.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double ElapsedNS(bench_clock::time_point begin)
+{
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - begin).count();
+}
+
+/* Host access of the whole plane: the mapped path when copy is NULL, else the copy into copy */
+static vx_status TimeAccess(vx_image image, vx_rectangle_t& rect, vx_enum usage, void* copy,
+                            vx_uint32 iterations, double& ns)
+{
+    vx_imagepatch_addressing_t addr;
+    bench_clock::time_point begin = bench_clock::now();
+    for(vx_uint32 i = 0; i < iterations; i++)
+    {
+        void* ptr = copy;
+        CHECK_STATUS( vxAccessImagePatch(image, &rect, 0, &addr, &ptr, usage) );
+        CHECK_STATUS( vxCommitImagePatch(image, usage == VX_READ_ONLY ? NULL : &rect, 0, &addr, ptr) );
+    }
+    ns = ElapsedNS(begin) / iterations;
+    return VX_SUCCESS;
+}
+
+/* The map kernels use inside a graph */
+static vx_status TimeMapInt(vx_image image, vx_rectangle_t& rect, vx_enum usage,
+                            vx_uint32 iterations, double& ns)
+{
+    vx_imagepatch_addressing_t addr;
+    bench_clock::time_point begin = bench_clock::now();
+    for(vx_uint32 i = 0; i < iterations; i++)
+    {
+        void* ptr = NULL;
+        CHECK_STATUS( vxMapImagePatchInt(image, &rect, 0, &addr, &ptr, usage) );
+        vxUnmapImagePatchInt(image, &rect, usage);
+    }
+    ns = ElapsedNS(begin) / iterations;
+    return VX_SUCCESS;
+}
+
+static void Usage(const char* name)
+{
+    printf("Usage: %s [--size WxH] [--iterations N] [--copies N]\n", name);
+    printf("Reports the cost of one map and unmap of an RGB image, default 1920x1080, through the host\n");
+    printf("access, the in-graph map and the host copy path.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    vx_uint32 width = 1920, height = 1080;
+    vx_uint32 iterations = 1000000;
+    vx_uint32 copies = 100;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--size" && i + 1 < argc && sscanf(argv[i + 1], "%ux%u", &width, &height) == 2)
+            i++;
+        else if(arg == "--iterations" && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else if(arg == "--copies" && i + 1 < argc)
+            copies = atoi(argv[++i]);
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    vx_context context = vxCreateContext();
+    CHECK_NULL(context);
+    vx_image image = vxCreateImage(context, width, height, VX_DF_IMAGE_RGB);
+    CHECK_NULL(image);
+    vx_rectangle_t rect = {0, 0, width, height};
+    std::vector<vx_uint8> copy(width * height * 3);
+
+    struct {
+        const char* name;
+        vx_enum     usage;
+    } usages[] = {{"read", VX_READ_ONLY}, {"write", VX_WRITE_ONLY}};
+
+    printf("%ux%u RGB, ns per map and unmap\n", width, height);
+    for(size_t u = 0; u < dimof(usages); u++)
+    {
+        double access_ns, map_ns, copy_ns;
+        /* the first access allocates the image */
+        CHECK_STATUS( TimeAccess(image, rect, usages[u].usage, NULL, 1, access_ns) );
+        CHECK_STATUS( TimeAccess(image, rect, usages[u].usage, NULL, iterations, access_ns) );
+        CHECK_STATUS( TimeMapInt(image, rect, usages[u].usage, iterations, map_ns) );
+        CHECK_STATUS( TimeAccess(image, rect, usages[u].usage, &copy[0], copies, copy_ns) );
+        printf("%-5s: access %8.1f, map %6.1f, copy %10.0f (%.2f GB/s)\n", usages[u].name,
+               access_ns, map_ns, copy_ns, copy.size() / copy_ns);
+    }
+
+    vxReleaseImage(&image);
+    vxReleaseContext(&context);
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+
+#include "vx_module.h"
+#include "vx_internal.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+/* The queue the framework used before the lock-free ring, one lock and two events around
+ * the whole ring, kept here to compare against */
+typedef struct _locked_queue_t {
+    vx_value_set_t *data[VX_INT_MAX_QUEUE_DEPTH];
+    vx_int32 start_index;
+    vx_int32 end_index;
+    vx_sem_t lock;
+    vx_event_t readEvent;
+    vx_event_t writeEvent;
+    vx_bool popped;
+} locked_queue_t;
+
+static void InitLockedQueue(locked_queue_t *q)
+{
+    memset(q->data, 0, sizeof(q->data));
+    q->start_index = 0;
+    q->end_index = -1;
+    q->popped = vx_false_e;
+    vxCreateSem(&q->lock, 1);
+    vxInitEvent(&q->readEvent, vx_false_e);
+    vxInitEvent(&q->writeEvent, vx_false_e);
+    vxSetEvent(&q->writeEvent);
+}
+
+static void DeinitLockedQueue(locked_queue_t *q)
+{
+    vxDestroySem(&q->lock);
+    vxDeinitEvent(&q->readEvent);
+    vxDeinitEvent(&q->writeEvent);
+}
+
+static vx_bool WriteLockedQueue(locked_queue_t *q, vx_value_set_t *data)
+{
+    vx_bool wrote = vx_false_e;
+    while (vxWaitEvent(&q->writeEvent, VX_INT_FOREVER) == vx_true_e)
+    {
+        vxSemWait(&q->lock);
+        if (q->popped == vx_false_e)
+        {
+            vxResetEvent(&q->writeEvent);
+            if (q->start_index != q->end_index)
+            {
+                if (q->end_index == -1)
+                    q->end_index = q->start_index;
+                q->data[q->end_index] = data;
+                q->end_index = (q->end_index + 1)%VX_INT_MAX_QUEUE_DEPTH;
+                wrote = vx_true_e;
+                if (q->start_index != q->end_index)
+                    vxSetEvent(&q->writeEvent);
+            }
+            if (q->end_index != -1)
+                vxSetEvent(&q->readEvent);
+        }
+        vxSemPost(&q->lock);
+        if (q->popped == vx_true_e || wrote == vx_true_e)
+            break;
+    }
+    return wrote;
+}
+
+static vx_bool ReadLockedQueue(locked_queue_t *q, vx_value_set_t **data)
+{
+    vx_bool red = vx_false_e;
+    while (vxWaitEvent(&q->readEvent, VX_INT_FOREVER) == vx_true_e)
+    {
+        vxSemWait(&q->lock);
+        if (q->popped == vx_false_e)
+        {
+            if (q->end_index != -1)
+            {
+                *data = q->data[q->start_index];
+                q->data[q->start_index] = NULL;
+                q->start_index = (q->start_index + 1)%VX_INT_MAX_QUEUE_DEPTH;
+                red = vx_true_e;
+                if (q->start_index == q->end_index)
+                {
+                    vxResetEvent(&q->readEvent);
+                    q->end_index = -1;
+                }
+            }
+            vxSetEvent(&q->writeEvent);
+        }
+        vxSemPost(&q->lock);
+        if (q->popped == vx_true_e || red == vx_true_e)
+            break;
+    }
+    return red;
+}
+
+/* The two queues behind one interface for RunQueue */
+struct LockFreeQueue
+{
+    vx_queue_t q;
+    LockFreeQueue() { vxInitQueue(&q); }
+    ~LockFreeQueue() { vxDeinitQueue(&q); }
+    bool Write(vx_value_set_t* data) { return vxWriteQueue(&q, data) == vx_true_e; }
+    bool Read(vx_value_set_t** data) { return vxReadQueue(&q, data) == vx_true_e; }
+};
+
+struct LockedQueue
+{
+    locked_queue_t q;
+    LockedQueue() { InitLockedQueue(&q); }
+    ~LockedQueue() { DeinitLockedQueue(&q); }
+    bool Write(vx_value_set_t* data) { return WriteLockedQueue(&q, data) == vx_true_e; }
+    bool Read(vx_value_set_t** data) { return ReadLockedQueue(&q, data) == vx_true_e; }
+};
+
+/* Told to each consumer once the producers are done, it is queued behind all their items */
+static vx_value_set_t g_stop;
+
+/* Items per second through the queue, from starting the producers to the last consumer done */
+template <class Queue>
+static double RunQueue(vx_uint32 producers, vx_uint32 consumers, vx_uint32 items)
+{
+    Queue queue;
+    vx_value_set_t item;
+    memset(&item, 0, sizeof(item));
+
+    bench_clock::time_point begin = bench_clock::now();
+    std::vector<std::thread> threads;
+    for(vx_uint32 c = 0; c < consumers; c++)
+        threads.push_back(std::thread([&]()
+        {
+            vx_value_set_t* data = NULL;
+            while(queue.Read(&data) && data != &g_stop)
+                ;
+        }));
+    std::vector<std::thread> writers;
+    for(vx_uint32 p = 0; p < producers; p++)
+        writers.push_back(std::thread([&]()
+        {
+            for(vx_uint32 i = 0; i < items; i++)
+                queue.Write(&item);
+        }));
+    for(vx_uint32 p = 0; p < producers; p++)
+        writers[p].join();
+    for(vx_uint32 c = 0; c < consumers; c++)
+        queue.Write(&g_stop);
+    for(vx_uint32 c = 0; c < consumers; c++)
+        threads[c].join();
+    double s = std::chrono::duration<double>(bench_clock::now() - begin).count();
+    return (double)producers * items / s;
+}
+
+static void Usage(const char* name)
+{
+    printf("Usage: %s [--producers N] [--consumers N] [--items N]\n", name);
+    printf("Reports the items per second through the lock-free vx_queue_t and the locked queue it replaced,\n");
+    printf("for 1 up to 8 producers and 2 consumers, 200000 items per producer.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    vx_uint32 max_producers = 8;
+    vx_uint32 consumers = 2;
+    vx_uint32 items = 200000;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--producers" && i + 1 < argc)
+            max_producers = atoi(argv[++i]);
+        else if(arg == "--consumers" && i + 1 < argc)
+            consumers = atoi(argv[++i]);
+        else if(arg == "--items" && i + 1 < argc)
+            items = atoi(argv[++i]);
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if(max_producers < 1 || consumers < 1 || items < 1)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    printf("%u consumers, %u items per producer\n", consumers, items);
+    printf("producers   lock-free items/s   locked items/s   speedup\n");
+    for(vx_uint32 producers = 1; producers <= max_producers; producers++)
+    {
+        double lock_free = RunQueue<LockFreeQueue>(producers, consumers, items);
+        double locked = RunQueue<LockedQueue>(producers, consumers, items);
+        printf("%9u   %17.0f   %14.0f   x%.2f\n", producers, lock_free, locked, lock_free / locked);
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+
+#include "vx_module.h"
+#include "vx_internal.h"
+
+/* Told to each consumer once the producers are done, it is queued behind all their items */
+static vx_value_set_t g_stop;
+
+/* Producers write their own items, v1 is the producer and v2 the index of the item. Consumers
+ * count every item they read and check the items of each producer come to them in order.
+ * A run which is not done after timeout seconds is stopped by popping the queue.
+ * Returns the number of errors. */
+static vx_uint32 RunStress(vx_uint32 producers, vx_uint32 consumers, vx_uint32 items, vx_uint32 timeout)
+{
+    vx_queue_t* queue = vxCreateQueue();
+    if(queue == NULL)
+        return 1;
+    std::vector<vx_value_set_t> sets(producers * items);
+    std::vector<vx_int32> reads(producers * items, 0);
+    std::vector<vx_uint32> errors(consumers, 0);
+    volatile vx_int32 done = 0;
+
+    std::vector<std::thread> threads;
+    for(vx_uint32 c = 0; c < consumers; c++)
+        threads.push_back(std::thread([&, c]()
+        {
+            std::vector<vx_int64> last(producers, -1);
+            vx_value_set_t* data = NULL;
+            while(vxReadQueue(queue, &data) == vx_true_e && data != &g_stop)
+            {
+                vx_uint32 p = (vx_uint32)data->v1;
+                vx_uint32 i = (vx_uint32)data->v2;
+                if(p >= producers || i >= items || data != &sets[p * items + i] || (vx_int64)i <= last[p])
+                    errors[c]++;
+                else
+                    vxAtomicAdd(&reads[p * items + i], 1);
+                last[p] = i;
+            }
+            vxAtomicAdd(&done, 1);
+        }));
+    std::vector<std::thread> writers;
+    for(vx_uint32 p = 0; p < producers; p++)
+        writers.push_back(std::thread([&, p]()
+        {
+            for(vx_uint32 i = 0; i < items; i++)
+            {
+                vx_value_set_t* data = &sets[p * items + i];
+                data->v1 = p;
+                data->v2 = i;
+                data->v3 = 0;
+                vxWriteQueue(queue, data);
+            }
+        }));
+    std::thread closer([&]()
+    {
+        for(vx_uint32 p = 0; p < producers; p++)
+            writers[p].join();
+        for(vx_uint32 c = 0; c < consumers; c++)
+            vxWriteQueue(queue, &g_stop);
+    });
+
+    vx_uint32 failed = 0;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+    while(vxAtomicLoad(&done) < (vx_int32)consumers && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if(vxAtomicLoad(&done) < (vx_int32)consumers)
+    {
+        /* a lost or doubled item leaves threads waiting for ever, let them go */
+        printf("timed out after %u s\n", timeout);
+        vxPopQueue(queue);
+        failed++;
+    }
+    closer.join();
+    for(vx_uint32 c = 0; c < consumers; c++)
+        threads[c].join();
+    vxDestroyQueue(&queue);
+
+    for(vx_uint32 c = 0; c < consumers; c++)
+        failed += errors[c];
+    for(vx_uint32 n = 0; n < reads.size(); n++)
+    {
+        if(reads[n] != 1)
+        {
+            if(failed < 10)
+                printf("item %u of producer %u read %d times\n", n % items, n / items, reads[n]);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+static void Usage(const char* name)
+{
+    printf("Usage: %s [--threads N] [--items N] [--rounds N] [--timeout S]\n", name);
+    printf("Checks every item written to a vx_queue_t by several producers is read exactly once by one of\n");
+    printf("several consumers, for all counts up to 8 producers and 8 consumers, 100000 items per producer.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    vx_uint32 threads = 8;
+    vx_uint32 items = 100000;
+    vx_uint32 rounds = 1;
+    vx_uint32 timeout = 60;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--threads" && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if(arg == "--items" && i + 1 < argc)
+            items = atoi(argv[++i]);
+        else if(arg == "--rounds" && i + 1 < argc)
+            rounds = atoi(argv[++i]);
+        else if(arg == "--timeout" && i + 1 < argc)
+            timeout = atoi(argv[++i]);
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if(threads < 1 || items < 1)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    vx_uint32 failed = 0;
+    for(vx_uint32 r = 0; r < rounds; r++)
+    {
+        for(vx_uint32 producers = 1; producers <= threads; producers *= 2)
+        {
+            for(vx_uint32 consumers = 1; consumers <= threads; consumers *= 2)
+            {
+                vx_uint32 errors = RunStress(producers, consumers, items, timeout);
+                printf("%u producers, %u consumers: %s (%u errors)\n",
+                       producers, consumers, errors == 0 ? "ok" : "FAILED", errors);
+                failed += errors;
+            }
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include "vx_module.h"
+#include "vx_internal.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+/* Branches of small nodes side by side, each node or-ing the node before it with the input,
+ * so the cost of a run is mostly the scheduling of the nodes */
+static vx_graph CreateBranchGraph(vx_context context, vx_image input, vx_image output,
+                                  vx_uint32 nodes, vx_uint32 branches, vx_uint32 width, vx_uint32 height)
+{
+    vx_graph graph = vxCreateGraph(context);
+    for(vx_uint32 b = 0; b < branches; b++)
+    {
+        vx_uint32 length = nodes / branches + (b < nodes % branches ? 1 : 0);
+        vx_image prev = NULL;
+        for(vx_uint32 n = 0; n < length; n++)
+        {
+            vx_image next = (b == 0 && n == length - 1) ? output : vxCreateVirtualImage(graph, width, height, VX_DF_IMAGE_U8);
+            if(n == 0)
+                vxNotNode(graph, input, next);
+            else
+                vxOrNode(graph, prev, input, next);
+            if(prev != NULL)
+                vxReleaseImage(&prev);
+            prev = next;
+        }
+        if(prev != output)
+            vxReleaseImage(&prev);
+    }
+    return graph;
+}
+
+static void Usage(const char* name)
+{
+    printf("Usage: %s [--nodes N] [--branches N] [--size WxH] [--iterations N]\n", name);
+    printf("Reports the time of one run of a graph of small nodes in parallel branches, default 120\n");
+    printf("nodes of 16x16 in 4 branches, most of which is spent scheduling the nodes.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    vx_uint32 nodes = 120;
+    vx_uint32 branches = 4;
+    vx_uint32 width = 16, height = 16;
+    vx_uint32 iterations = 10000;
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--nodes" && i + 1 < argc)
+            nodes = atoi(argv[++i]);
+        else if(arg == "--branches" && i + 1 < argc)
+            branches = atoi(argv[++i]);
+        else if(arg == "--size" && i + 1 < argc && sscanf(argv[i + 1], "%ux%u", &width, &height) == 2)
+            i++;
+        else if(arg == "--iterations" && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if(branches < 1 || nodes < branches)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    vx_context context = vxCreateContext();
+    CHECK_NULL(context);
+    vx_image input = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    vx_image output = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    CHECK_NULL(input);
+    CHECK_NULL(output);
+    vx_graph graph = CreateBranchGraph(context, input, output, nodes, branches, width, height);
+    CHECK_NULL(graph);
+
+    bench_clock::time_point begin = bench_clock::now();
+    CHECK_STATUS( vxVerifyGraph(graph) );
+    double verify_us = std::chrono::duration<double, std::micro>(bench_clock::now() - begin).count();
+    CHECK_STATUS( vxProcessGraph(graph) );
+
+    begin = bench_clock::now();
+    for(vx_uint32 i = 0; i < iterations; i++)
+        CHECK_STATUS( vxProcessGraph(graph) );
+    double run_us = std::chrono::duration<double, std::micro>(bench_clock::now() - begin).count() / iterations;
+
+    printf("%u nodes of %ux%u in %u branches: verify %.1f us, run %.2f us (%.3f us per node)\n",
+           nodes, width, height, branches, verify_us, run_us, run_us / nodes);
+
+    vxReleaseGraph(&graph);
+    vxReleaseImage(&input);
+    vxReleaseImage(&output);
+    vxReleaseContext(&context);
+    return 0;
+}
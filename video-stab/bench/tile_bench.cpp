@@ -0,0 +1,156 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+
+#include "vx_module.h"
+#include "vx_internal.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+/* warp -> cut -> gray, the chain a tiled graph runs band by band */
+static vx_graph CreateChainGraph(vx_context context, vx_image input, vx_image output, vx_uint32 tile_height)
+{
+    vx_uint32 width = 0, height = 0;
+    vxQueryImage(input, VX_IMAGE_ATTRIBUTE_WIDTH, &width, sizeof(width));
+    vxQueryImage(input, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+
+    /* a small rotation about the center, as the stabilizer applies */
+    vx_float32 angle = 0.02f, cx = width / 2.f, cy = height / 2.f;
+    vx_float32 m[9] = {cosf(angle), -sinf(angle), 0.f,
+                       sinf(angle),  cosf(angle), 0.f,
+                       0.f, 0.f, 1.f};
+    m[2] = cx - m[0] * cx - m[1] * cy;
+    m[5] = cy - m[3] * cx - m[4] * cy;
+    vx_uint32 margin_x = width / 10, margin_y = height / 10;
+    vx_uint32 start_x = margin_x, start_y = margin_y, end_x = width - margin_x, end_y = height - margin_y;
+    vx_enum inter = VX_INTERPOLATION_TYPE_BILINEAR;
+    vx_enum order = VX_ADD_CHANNEL_ORDER_RGB;
+
+    vx_graph graph = vxCreateGraph(context);
+    vx_matrix matrix = vxCreateMatrix(context, VX_TYPE_FLOAT32, 3, 3);
+    vxCommitMatrix(matrix, m);
+    vx_image warped = vxCreateVirtualImage(graph, width, height, VX_DF_IMAGE_RGB);
+    vx_image cut = vxCreateVirtualImage(graph, end_x - start_x, end_y - start_y, VX_DF_IMAGE_RGB);
+    vx_scalar inter_s = vxCreateScalar(context, VX_TYPE_ENUM, &inter);
+    vx_scalar order_s = vxCreateScalar(context, VX_TYPE_ENUM, &order);
+    vx_scalar rect_s[4] = {vxCreateScalar(context, VX_TYPE_UINT32, &start_x),
+                           vxCreateScalar(context, VX_TYPE_UINT32, &start_y),
+                           vxCreateScalar(context, VX_TYPE_UINT32, &end_x),
+                           vxCreateScalar(context, VX_TYPE_UINT32, &end_y)};
+    vx_node warp_node = vxWarpPerspectiveRGBNode(graph, input, matrix, inter_s, warped);
+    vxCutNode(graph, warped, rect_s[0], rect_s[1], rect_s[2], rect_s[3], cut);
+    vxRGBtoGrayNode(graph, cut, order_s, output);
+    vx_border_mode_t border = {VX_BORDER_MODE_CONSTANT, 0};
+    vxSetNodeAttribute(warp_node, VX_NODE_ATTRIBUTE_BORDER_MODE, &border, sizeof(border));
+    vxSetGraphAttribute(graph, VX_GRAPH_ATTRIBUTE_TILE_HEIGHT, &tile_height, sizeof(tile_height));
+
+    vxReleaseMatrix(&matrix);
+    vxReleaseImage(&warped);
+    vxReleaseImage(&cut);
+    vxReleaseScalar(&inter_s);
+    vxReleaseScalar(&order_s);
+    for(int i = 0; i < 4; i++)
+        vxReleaseScalar(&rect_s[i]);
+    return graph;
+}
+
+static vx_status ReadImage(vx_image image, std::vector<vx_uint8>& data)
+{
+    vx_rectangle_t rect = {0, 0, 0, 0};
+    vx_imagepatch_addressing_t addr;
+    void* ptr = NULL;
+    vxQueryImage(image, VX_IMAGE_ATTRIBUTE_WIDTH, &rect.end_x, sizeof(rect.end_x));
+    vxQueryImage(image, VX_IMAGE_ATTRIBUTE_HEIGHT, &rect.end_y, sizeof(rect.end_y));
+    data.resize(rect.end_x * rect.end_y);
+    CHECK_STATUS( vxAccessImagePatch(image, &rect, 0, &addr, &ptr, VX_READ_ONLY) );
+    for(vx_uint32 y = 0; y < rect.end_y; y++)
+        memcpy(&data[y * rect.end_x], (vx_uint8*)ptr + y * addr.stride_y, rect.end_x);
+    return vxCommitImagePatch(image, NULL, 0, &addr, ptr);
+}
+
+static void Usage(const char* name)
+{
+    printf("Usage: %s [--size WxH] [--iterations N] [--tile ROWS]...\n", name);
+    printf("Reports the time of a warp -> cut -> gray graph of an RGB image, default 1920x1080, when it\n");
+    printf("is not tiled and in bands of each --tile height, default 16, 32 and 64 rows.\n");
+}
+
+int main(int argc, char* argv[])
+{
+    vx_uint32 width = 1920, height = 1080;
+    vx_uint32 iterations = 100;
+    std::vector<vx_uint32> tiles(1, 0);
+
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--size" && i + 1 < argc && sscanf(argv[i + 1], "%ux%u", &width, &height) == 2)
+            i++;
+        else if(arg == "--iterations" && i + 1 < argc)
+            iterations = atoi(argv[++i]);
+        else if(arg == "--tile" && i + 1 < argc)
+            tiles.push_back(atoi(argv[++i]));
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+    if(tiles.size() == 1)
+    {
+        tiles.push_back(16);
+        tiles.push_back(32);
+        tiles.push_back(64);
+    }
+
+    vx_context context = vxCreateContext();
+    CHECK_NULL(context);
+    vx_image input = vxCreateImage(context, width, height, VX_DF_IMAGE_RGB);
+    CHECK_NULL(input);
+    {
+        vx_rectangle_t rect = {0, 0, width, height};
+        vx_imagepatch_addressing_t addr;
+        void* ptr = NULL;
+        CHECK_STATUS( vxAccessImagePatch(input, &rect, 0, &addr, &ptr, VX_WRITE_ONLY) );
+        srand(1);
+        for(vx_uint32 y = 0; y < height; y++)
+            for(vx_uint32 x = 0; x < width * 3; x++)
+                ((vx_uint8*)ptr)[y * addr.stride_y + x] = (vx_uint8)(((x / 3 + y) & 0xFF) ^ (rand() & 0x1F));
+        CHECK_STATUS( vxCommitImagePatch(input, &rect, 0, &addr, ptr) );
+    }
+
+    std::vector<vx_uint8> reference;
+    printf("%ux%u RGB, warp -> cut -> gray, ms per frame\n", width, height);
+    for(size_t t = 0; t < tiles.size(); t++)
+    {
+        vx_image output = vxCreateImage(context, width - 2 * (width / 10), height - 2 * (height / 10), VX_DF_IMAGE_U8);
+        vx_graph graph = CreateChainGraph(context, input, output, tiles[t]);
+        CHECK_STATUS( vxVerifyGraph(graph) );
+        CHECK_STATUS( vxProcessGraph(graph) );
+
+        bench_clock::time_point begin = bench_clock::now();
+        for(vx_uint32 i = 0; i < iterations; i++)
+            CHECK_STATUS( vxProcessGraph(graph) );
+        double ms = std::chrono::duration<double, std::milli>(bench_clock::now() - begin).count() / iterations;
+
+        std::vector<vx_uint8> result;
+        CHECK_STATUS( ReadImage(output, result) );
+        if(t == 0)
+            reference = result;
+        if(tiles[t] == 0)
+            printf("untiled   : %7.3f\n", ms);
+        else
+            printf("%4u rows : %7.3f%s\n", tiles[t], ms, result == reference ? "" : " (differs from untiled)");
+
+        vxReleaseGraph(&graph);
+        vxReleaseImage(&output);
+    }
+
+    vxReleaseImage(&input);
+    vxReleaseContext(&context);
+    return 0;
+}
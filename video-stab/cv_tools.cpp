@@ -1,22 +1,23 @@
 #include "cv_tools.h"
+#include <cstring>
 
-void _CV2VX(vx_uint8* cv, vx_uint8* vx)
+/* Copies one row of pixels, swapping the red and the blue channel unless the orders match */
+static void CopyRow(vx_uint8* dst, const vx_uint8* src, vx_uint32 width, bool swap)
 {
-    vx[0] = cv[2]; // r
-    vx[1] = cv[1]; // g
-    vx[2] = cv[0]; // b
-}
-
-void _VX2CV(vx_uint8* cv, vx_uint8* vx)
-{
-    cv[0] = vx[2]; // b
-    cv[1] = vx[1]; // g
-    cv[2] = vx[0]; // r
+    if(!swap)
+    {
+        memcpy(dst, src, width * 3);
+        return;
+    }
+    for(vx_uint32 x = 0; x < width; x++, dst += 3, src += 3)
+    {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+    }
 }
 
-typedef void(*ConvKernel)(vx_uint8* a, vx_uint8* b);
-
-bool Converter(vx_image vxImage, cv::Mat& cvImage, ConvKernel kernel)
+bool Converter(vx_image vxImage, cv::Mat& cvImage, bool toVX, bool bgr)
 {
     if(cvImage.type() != CV_8UC3)
     {
@@ -44,25 +45,24 @@ bool Converter(vx_image vxImage, cv::Mat& cvImage, ConvKernel kernel)
     void *buff = NULL;
     vx_rectangle_t rect = {0, 0, width, height};
     vx_imagepatch_addressing_t addr;
-    status |= vxAccessImagePatch(vxImage, &rect, 0, &addr, &buff, VX_READ_AND_WRITE);
+    status |= vxAccessImagePatch(vxImage, &rect, 0, &addr, &buff, toVX ? VX_WRITE_ONLY : VX_READ_ONLY);
     if(status != VX_SUCCESS)
     {
         printf("Can't access to image patch(%d)!\n", status);
         return false;
     }
 
-    for (int y = 0; y < height; y++)
+    for (vx_uint32 y = 0; y < height; y++)
     {
-        uchar* ptr = (uchar*) (cvImage.data + y * cvImage.step[0]);
-        for (int x = 0; x < width; x++)
-        {
-            vx_uint8* cv = ptr + 3 * x;
-            vx_uint8* vx = (vx_uint8*)vxFormatImagePatchAddress2d(buff, x, y, &addr);
-            (*kernel)(cv, vx);
-        }
+        vx_uint8* cv = (vx_uint8*)(cvImage.data + y * cvImage.step[0]);
+        vx_uint8* vx = (vx_uint8*)vxFormatImagePatchAddress2d(buff, 0, y, &addr);
+        if(toVX)
+            CopyRow(vx, cv, width, !bgr);
+        else
+            CopyRow(cv, vx, width, !bgr);
     }
 
-    status |= vxCommitImagePatch(vxImage, &rect, 0, &addr, buff);
+    status |= vxCommitImagePatch(vxImage, toVX ? &rect : NULL, 0, &addr, buff);
     if(status != VX_SUCCESS)
     {
         printf("Can't commit image patch(%d)!\n", status);
@@ -71,15 +71,15 @@ bool Converter(vx_image vxImage, cv::Mat& cvImage, ConvKernel kernel)
     return true;
 }
 
-bool CV2VX(vx_image vxImage, cv::Mat cvImage)
+bool CV2VX(vx_image vxImage, cv::Mat cvImage, bool bgr)
 {
-    bool ret = Converter(vxImage, cvImage, &_CV2VX);
+    bool ret = Converter(vxImage, cvImage, true, bgr);
     if(!ret)
         printf("Can't convert image CV->VX!\n");
     return ret;
 }
 
-bool VX2CV(vx_image vxImage, cv::Mat& cvImage)
+bool VX2CV(vx_image vxImage, cv::Mat& cvImage, bool bgr)
 {
     if(cvImage.empty())
     {
@@ -88,7 +88,7 @@ bool VX2CV(vx_image vxImage, cv::Mat& cvImage)
         vxQueryImage(vxImage, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
         cvImage.create(height, width, CV_8UC3);
     }
-    bool ret = Converter(vxImage, cvImage, &_VX2CV);
+    bool ret = Converter(vxImage, cvImage, false, bgr);
     if(!ret)
         printf("Can't convert image VX->CV!\n");
     return ret;
@@ -6,8 +6,9 @@
 #include "VX/vx.h"
 #include "vx_debug.h"
 
-bool CV2VX(vx_image vxImage, cv::Mat cvImage);
-bool VX2CV(vx_image vxImage, cv::Mat& cvImage);
+/* bgr - the VX image keeps OpenCV's BGR order, rows are copied as they are */
+bool CV2VX(vx_image vxImage, cv::Mat cvImage, bool bgr = false);
+bool VX2CV(vx_image vxImage, cv::Mat& cvImage, bool bgr = false);
 cv::Mat MergeImage(cv::Mat up, cv::Mat down);
 
 #endif // CV_TOOLS_H
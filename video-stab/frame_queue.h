@@ -0,0 +1,61 @@
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+/* Bounded blocking queue used to hand frames between pipeline stages.
+ * Push() blocks while the queue is full, Pop() blocks while it is empty.
+ * After Close() no more items are accepted and Pop() returns false once
+ * the remaining items are drained. */
+template<typename T>
+class FrameQueue
+{
+public:
+    explicit FrameQueue(size_t capacity) :
+        m_Capacity(capacity > 0 ? capacity : 1), m_Closed(false)
+    {
+    }
+
+    bool Push(const T& item)
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_NotFull.wait(lock, [this]{ return m_Closed || m_Items.size() < m_Capacity; });
+        if(m_Closed)
+            return false;
+        m_Items.push_back(item);
+        m_NotEmpty.notify_one();
+        return true;
+    }
+
+    bool Pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_NotEmpty.wait(lock, [this]{ return m_Closed || !m_Items.empty(); });
+        if(m_Items.empty())
+            return false;
+        item = m_Items.front();
+        m_Items.pop_front();
+        m_NotFull.notify_one();
+        return true;
+    }
+
+    void Close()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Closed = true;
+        m_NotEmpty.notify_all();
+        m_NotFull.notify_all();
+    }
+
+private:
+    std::deque<T>           m_Items;
+    size_t                  m_Capacity;
+    bool                    m_Closed;
+    std::mutex              m_Mutex;
+    std::condition_variable m_NotEmpty;
+    std::condition_variable m_NotFull;
+};
+
+#endif // FRAME_QUEUE_H
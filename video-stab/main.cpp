@@ -1,46 +1,120 @@
 #include <cstdio>
 #include <iostream>
 #include <vector>
+#include <string>
+#include <thread>
+#include <deque>
 
 #include "opencv2/highgui/highgui.hpp"
 #include "opencv2/core/core.hpp"
 #include "opencv2/features2d/features2d.hpp"
-#include "opencv2/calib3d/calib3d.hpp"
 
 #include "vx_module.h"
 #include "cv_tools.h"
+#include "frame_queue.h"
 
-#define MAX_PYRAMID_LEVELS 4
+#define PIPELINE_QUEUE_SIZE 4
 
-inline vx_int32 min(vx_int32 left, vx_int32 right)
+/* Gives a decoded frame to the stabilizer. With external frames the pixels of the
+ * frame are used in place, so it's held until the stabilizer releases it. */
+bool AddFrame(VXVideoStab& vstub, cv::Mat frame, std::deque<cv::Mat>& held, bool external)
 {
-    return left < right ? left : right;
+    if(!external)
+        return CV2VX(vstub.NewImage(), frame);
+
+    if(!frame.isContinuous())
+        frame = frame.clone();
+    void* released = NULL;
+    if(vstub.NewImage(frame.data, &released) == NULL)
+        return false;
+    held.push_back(frame);
+    if(released)
+        held.pop_front();
+    return true;
 }
 
-inline vx_int32 max(vx_int32 left, vx_int32 right)
+/* capture -> CV2VX -> Calculate -> VX2CV -> write, strictly one after another */
+void RunSerial(cv::VideoCapture& cvReader, cv::VideoWriter& cvWriter, VXVideoStab& vstub, int frames, bool external)
 {
-    return left > right ? left : right;
+    std::deque<cv::Mat> held;
+    cv::Mat result;
+    int counter = 0;
+    while(true)
+    {
+        /* a new Mat for every frame, the reader would reuse the buffer of a held one */
+        cv::Mat cvImage;
+        cvReader >> cvImage;
+        if(cvImage.empty())
+        {
+            printf("End of video!\n");
+            break;
+        }
+        if(!AddFrame(vstub, cvImage, held, external)) break;
+        vx_image out = vstub.Calculate();
+        if(out)
+        {
+            if(!VX2CV(out, result, external)) break;
+            cvWriter << result;
+        }
+        counter++;
+        std::cout << counter << " from " << frames <<" processed frames" << std::endl;
+    }
 }
 
-void InitParams(const int width, const int height, VideoStabParams& params)
+/* Decoding, stabilization and encoding run on separate threads connected by
+ * bounded queues; inside VXVideoStab FindWarp overlaps WarpAndCut. */
+void RunPipelined(cv::VideoCapture& cvReader, cv::VideoWriter& cvWriter, VXVideoStab& vstub, int frames, bool external)
 {
-    params.warp_gauss.scale = 0.85;
-    params.warp_gauss.interpol = VX_INTERPOLATION_TYPE_BILINEAR;
-    params.warp_gauss.gauss_size = 8;
-    params.find_warp.fast_max_corners = 1000;
-    params.find_warp.fast_thresh      = 50.f;
+    std::deque<cv::Mat> held;
+    FrameQueue<cv::Mat> decoded(PIPELINE_QUEUE_SIZE);
+    FrameQueue<cv::Mat> stabilized(PIPELINE_QUEUE_SIZE);
 
-    params.find_warp.optflow_estimate = 0.01f;
-    params.find_warp.optflow_max_iter = 30;
-    params.find_warp.optflow_term     = VX_TERM_CRITERIA_BOTH;
-    params.find_warp.optflow_wnd_size = 11;
+    std::thread reader([&]()
+    {
+        while(true)
+        {
+            cv::Mat frame;
+            cvReader >> frame;
+            if(frame.empty() || !decoded.Push(frame))
+                break;
+        }
+        decoded.Close();
+    });
+    std::thread writer([&]()
+    {
+        cv::Mat frame;
+        while(stabilized.Pop(frame))
+            cvWriter << frame;
+    });
 
-    params.find_warp.pyramid_scale    = VX_SCALE_PYRAMID_HALF;
-    params.find_warp.pyramid_level    = min(
-            floor(log(vx_float32(params.find_warp.optflow_wnd_size) / vx_float32(width)) / log(params.find_warp.pyramid_scale)),
-            floor(log(vx_float32(params.find_warp.optflow_wnd_size) / vx_float32(height)) / log(params.find_warp.pyramid_scale))
-            );
-    params.find_warp.pyramid_level = max(1, min(params.find_warp.pyramid_level, MAX_PYRAMID_LEVELS));
+    cv::Mat cvImage;
+    int counter = 0;
+    bool failed = false;
+    while(decoded.Pop(cvImage))
+    {
+        if(!AddFrame(vstub, cvImage, held, external)) { failed = true; break; }
+        vx_image out = vstub.Calculate();
+        if(out)
+        {
+            cv::Mat result;
+            if(!VX2CV(out, result, external)) { failed = true; break; }
+            stabilized.Push(result);
+        }
+        counter++;
+        std::cout << counter << " from " << frames <<" processed frames" << std::endl;
+    }
+    if(!failed)
+    {
+        printf("End of video!\n");
+        vx_image out = vstub.Flush();
+        cv::Mat result;
+        if(out && VX2CV(out, result, external))
+            stabilized.Push(result);
+    }
+    decoded.Close();
+    stabilized.Close();
+    reader.join();
+    writer.join();
 }
 
 #define DEBUG_ZONES {VX_ZONE_ERROR}
@@ -49,7 +123,8 @@ int main(int argc, char* argv[])
 {
     if(argc < 2)
     {
-        printf("Use ./%s <input_video> <output_video>\n", argv[0]);
+        printf("Use ./%s <input_video> <output_video> [--pipelined] [--zero-copy]"
+               " [--motion translation|similarity|affine|homography]\n", argv[0]);
         return 0;
     }
     cv::VideoCapture cvReader(argv[1]); // video reader
@@ -68,6 +143,36 @@ int main(int argc, char* argv[])
     }
     /* Init parameters of stabilization */
     InitParams(width, height, vs_params);
+    for(int i = 3; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if(arg == "--pipelined")
+            vs_params.pipelined = vx_true_e;
+        /* decoded BGR frames enter the graphs as they are */
+        else if(arg == "--zero-copy")
+        {
+            vs_params.external_frames = vx_true_e;
+            vs_params.find_warp.channel_order = VX_ADD_CHANNEL_ORDER_BGR;
+        }
+        /* model of the motion between two frames */
+        else if(arg == "--motion" && i + 1 < argc)
+        {
+            std::string model = argv[++i];
+            if(model == "translation")
+                vs_params.find_warp.warp_model = VX_ADD_MOTION_MODEL_TRANSLATION;
+            else if(model == "similarity")
+                vs_params.find_warp.warp_model = VX_ADD_MOTION_MODEL_SIMILARITY;
+            else if(model == "affine")
+                vs_params.find_warp.warp_model = VX_ADD_MOTION_MODEL_AFFINE;
+            else if(model == "homography")
+                vs_params.find_warp.warp_model = VX_ADD_MOTION_MODEL_HOMOGRAPHY;
+            else
+            {
+                std::cout << " Unknown motion model " << model << "!" << std::endl;
+                return 1;
+            }
+        }
+    }
     /* Build pipeline of stabilization */
     if(vstub.CreatePipeline(width, height, vs_params) != VX_SUCCESS)
         return 1;
@@ -75,27 +180,10 @@ int main(int argc, char* argv[])
     vstub.EnableDebug(DEBUG_ZONES);
     /**********************/
 
-    cv::Mat cvImage;
-    int counter = 0;
-    while(true)
-    {
-        cvReader >> cvImage;
-        if(cvImage.empty())
-        {
-            printf("End of video!\n");
-            break;
-        }
-        vx_image vxImage = vstub.NewImage();
-        if(!CV2VX(vxImage, cvImage)) break;
-        vx_image out = vstub.Calculate();
-        if(out)
-        {
-            if(!VX2CV(out, cvImage)) break;
-            cvWriter << cvImage;
-        }
-        counter++;
-        std::cout << counter << " from " << frames <<" processed frames" << std::endl;
-    }
+    if(vs_params.pipelined)
+        RunPipelined(cvReader, cvWriter, vstub, frames, vs_params.external_frames);
+    else
+        RunSerial(cvReader, cvWriter, vstub, frames, vs_params.external_frames);
     cvWriter.release();
     vstub.DisableDebug(DEBUG_ZONES);
     return 0;
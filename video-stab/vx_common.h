@@ -4,6 +4,11 @@
 #include <vector>
 #include <initializer_list>
 #include "VX/vx.h"
+#include "VX/vx_ext_image_handle.h"
+#include "VX/vx_ext_keypoint_f32.h"
+#include "VX/vx_ext_node_perf.h"
+#include "VX/vx_ext_node_threads.h"
+#include "VX/vx_ext_tiled_graph.h"
 #include "vx_debug.h"
 #include "add_kernels/add_kernels.h"
 
@@ -1,13 +1,60 @@
 #include "vx_pipelines.h"
 
-vx_status FindWarpGraph(vx_context context, vx_graph& graph,vx_image from_image, vx_image to_image,
-                        vx_matrix matrix, FindWarpParams& params)
+/* Converts the new frame to gray and builds its pyramid into slot 0 of the delays */
+static vx_status AddFrameNodes(vx_graph graph, vx_image image, vx_delay grays, vx_delay pyramids,
+                               FindWarpParams& params)
+{
+    vx_context context = vxGetContext((vx_reference)graph);
+    vx_image   gray    = (vx_image)vxGetReferenceFromDelay(grays, 0);
+    vx_pyramid pyramid = (vx_pyramid)vxGetReferenceFromDelay(pyramids, 0);
+    vx_scalar  order_s = vxCreateScalar(context, VX_TYPE_ENUM, &params.channel_order);
+    CHECK_NULL(gray);
+    CHECK_NULL(pyramid);
+    CHECK_NULL(order_s);
+
+    vx_node node[2];
+    node[0] = vxRGBtoGrayNode(graph, image, order_s, gray);
+    node[1] = vxGaussianPyramidNode(graph, gray, pyramid);
+
+    for(int i = 0; i < dimof(node); i++)
+        CHECK_NULL(node[i]);
+    return VX_SUCCESS;
+}
+
+vx_status FrameGraph(vx_context context, vx_graph& graph, vx_image image,
+                     vx_delay grays, vx_delay pyramids, FindWarpParams& params)
+{
+    CHECK_NULL(context);
+    graph = vxCreateGraph(context);
+    CHECK_NULL(graph);
+    CHECK_STATUS( AddFrameNodes(graph, image, grays, pyramids, params) );
+    CHECK_STATUS( vxVerifyGraph(graph) );
+    return VX_SUCCESS;
+}
+
+vx_status CreateFrameDelays(vx_context context, vx_uint32 width, vx_uint32 height,
+                            vx_delay& grays, vx_delay& pyramids, FindWarpParams& params)
 {
     CHECK_NULL(context);
 
-    vx_uint32 width, height;
-    vxQueryImage(from_image, VX_IMAGE_ATTRIBUTE_WIDTH,  &width,  sizeof(width));
-    vxQueryImage(from_image, VX_IMAGE_ATTRIBUTE_HEIGHT, &height, sizeof(height));
+    vx_image   tmp_gray    = vxCreateImage(context, width, height, VX_DF_IMAGE_U8);
+    vx_pyramid tmp_pyramid = vxCreatePyramid(context, params.pyramid_level, params.pyramid_scale, width, height, VX_DF_IMAGE_U8);
+    CHECK_NULL(tmp_gray);
+    CHECK_NULL(tmp_pyramid);
+
+    grays    = vxCreateDelay(context, (vx_reference)tmp_gray, 2);
+    pyramids = vxCreateDelay(context, (vx_reference)tmp_pyramid, 2);
+    vxReleaseImage(&tmp_gray);
+    vxReleasePyramid(&tmp_pyramid);
+    CHECK_NULL(grays);
+    CHECK_NULL(pyramids);
+    return VX_SUCCESS;
+}
+
+vx_status FindWarpGraph(vx_context context, vx_graph& graph, vx_image to_image,
+                        vx_delay grays, vx_delay pyramids, vx_matrix matrix, FindWarpParams& params)
+{
+    CHECK_NULL(context);
 
     /***    Internal params    ***/
     vx_uint32 corners_num = 100;
@@ -16,43 +63,48 @@ vx_status FindWarpGraph(vx_context context, vx_graph& graph,vx_image from_image,
 
     /***    Create objects    ***/
                graph             = vxCreateGraph(context);
-    vx_image   gray_image_1      = vxCreateVirtualImage(graph, width, height, VX_DF_IMAGE_U8);
-    vx_image   gray_image_2      = vxCreateVirtualImage(graph, width, height, VX_DF_IMAGE_U8);
+    vx_image   gray_image_1      = (vx_image)vxGetReferenceFromDelay(grays, 1);
     vx_scalar  fast_thresh_s     = vxCreateScalar(context, VX_TYPE_FLOAT32, &params.fast_thresh);
     vx_scalar  fast_num_corn_s   = vxCreateScalar(context, VX_TYPE_UINT32, &corners_num);
     vx_array   fast_found_corn_s = vxCreateArray(context, VX_TYPE_KEYPOINT, params.fast_max_corners);
-    vx_array   optf_moved_corn_s = vxCreateArray(context, VX_TYPE_KEYPOINT, params.fast_max_corners);
+    vx_array   optf_moved_corn_s = vxCreateArray(context, VX_TYPE_KEYPOINT_F32, params.fast_max_corners);
     vx_scalar  optf_estimate_s   = vxCreateScalar(context, VX_TYPE_FLOAT32, &params.optflow_estimate);
     vx_scalar  optf_max_iter_s   = vxCreateScalar(context, VX_TYPE_UINT32, &params.optflow_max_iter);
     vx_scalar  optf_init_estim   = vxCreateScalar(context, VX_TYPE_BOOL, &optflow_init_estimate);
-    vx_pyramid pyramid_1         = vxCreatePyramid(context, params.pyramid_level, params.pyramid_scale, width, height, VX_DF_IMAGE_U8);
-    vx_pyramid pyramid_2         = vxCreatePyramid(context, params.pyramid_level, params.pyramid_scale, width, height, VX_DF_IMAGE_U8);
+    vx_pyramid pyramid_1         = (vx_pyramid)vxGetReferenceFromDelay(pyramids, 1);
+    vx_pyramid pyramid_2         = (vx_pyramid)vxGetReferenceFromDelay(pyramids, 0);
+    vx_scalar  warp_model_s      = vxCreateScalar(context, VX_TYPE_ENUM, &params.warp_model);
+    vx_scalar  warp_max_iter_s   = vxCreateScalar(context, VX_TYPE_UINT32, &params.warp_max_iter);
+    vx_scalar  warp_threshold_s  = vxCreateScalar(context, VX_TYPE_FLOAT32, &params.warp_threshold);
     /***      Check objects   ***/
     CHECK_NULL(graph);
     CHECK_NULL(gray_image_1);
-    CHECK_NULL(gray_image_2);
     CHECK_NULL(fast_thresh_s);
     CHECK_NULL(fast_num_corn_s);
     CHECK_NULL(fast_found_corn_s);
     CHECK_NULL(optf_moved_corn_s);
     CHECK_NULL(pyramid_1);
     CHECK_NULL(pyramid_2);
+    CHECK_NULL(warp_model_s);
+    CHECK_NULL(warp_max_iter_s);
+    CHECK_NULL(warp_threshold_s);
     /***    End of objects    ***/
 
-    vx_node node[7];
-    node[0] = vxRGBtoGrayNode(graph, from_image, gray_image_1);
-    node[1] = vxRGBtoGrayNode(graph, to_image, gray_image_2);
-    node[2] = vxFastCornersNode(graph, gray_image_1, fast_thresh_s, vx_true_e, fast_found_corn_s, fast_num_corn_s);
-    node[3] = vxGaussianPyramidNode(graph, gray_image_1, pyramid_1);
-    node[4] = vxGaussianPyramidNode(graph, gray_image_2, pyramid_2);
-    node[5] = vxOpticalFlowPyrLKNode(graph, pyramid_1, pyramid_2, fast_found_corn_s,
+    /* only the new frame is converted, the previous one was done a step earlier */
+    CHECK_STATUS( AddFrameNodes(graph, to_image, grays, pyramids, params) );
+
+    vx_node node[3];
+    node[0] = vxFastCornersNode(graph, gray_image_1, fast_thresh_s, vx_true_e, fast_found_corn_s, fast_num_corn_s);
+    node[1] = vxOpticalFlowPyrLKNode(graph, pyramid_1, pyramid_2, fast_found_corn_s,
                     fast_found_corn_s, optf_moved_corn_s, params.optflow_term,
                     optf_estimate_s, optf_max_iter_s, optf_init_estim, params.optflow_wnd_size);
-    node[6] = vxFindWarpNode(graph, fast_found_corn_s, optf_moved_corn_s, matrix);
+    node[2] = vxFindWarpNode(graph, fast_found_corn_s, optf_moved_corn_s, warp_model_s,
+                    warp_max_iter_s, warp_threshold_s, matrix);
 
     for(int i = 0; i < dimof(node); i++)
         CHECK_NULL(node[i]);
 
+    CHECK_STATUS( vxSetNodeAttribute(node[1], VX_NODE_ATTRIBUTE_THREADS, &params.optflow_threads, sizeof(params.optflow_threads)) );
     CHECK_STATUS( vxVerifyGraph(graph) );
     return VX_SUCCESS;
 }
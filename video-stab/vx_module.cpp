@@ -5,9 +5,51 @@
 #include <string>
 #include <ctime>
 
+#define MAX_PYRAMID_LEVELS 4
+
+static inline vx_int32 min(vx_int32 left, vx_int32 right)
+{
+    return left < right ? left : right;
+}
+
+static inline vx_int32 max(vx_int32 left, vx_int32 right)
+{
+    return left > right ? left : right;
+}
+
+void InitParams(const int width, const int height, VideoStabParams& params)
+{
+    params.warp_gauss.scale = 0.85;
+    params.warp_gauss.interpol = VX_INTERPOLATION_TYPE_BILINEAR;
+    params.warp_gauss.gauss_size = 8;
+    params.warp_gauss.warp_threads = 0;
+    params.find_warp.fast_max_corners = 1000;
+    params.find_warp.fast_thresh      = 50.f;
+
+    params.find_warp.optflow_estimate = 0.01f;
+    params.find_warp.optflow_max_iter = 30;
+    params.find_warp.optflow_term     = VX_TERM_CRITERIA_BOTH;
+    params.find_warp.optflow_wnd_size = 11;
+    params.find_warp.optflow_threads  = 0;
+
+    params.find_warp.pyramid_scale    = VX_SCALE_PYRAMID_HALF;
+    params.find_warp.pyramid_level    = min(
+            floor(log(vx_float32(params.find_warp.optflow_wnd_size) / vx_float32(width)) / log(params.find_warp.pyramid_scale)),
+            floor(log(vx_float32(params.find_warp.optflow_wnd_size) / vx_float32(height)) / log(params.find_warp.pyramid_scale))
+            );
+    params.find_warp.pyramid_level = max(1, min(params.find_warp.pyramid_level, MAX_PYRAMID_LEVELS));
+    params.find_warp.warp_model       = VX_ADD_MOTION_MODEL_HOMOGRAPHY;
+    params.find_warp.warp_max_iter    = 500;
+    params.find_warp.warp_threshold   = 3.f;
+    params.find_warp.channel_order = VX_ADD_CHANNEL_ORDER_RGB;
+    params.pipelined = vx_false_e;
+    params.external_frames = vx_false_e;
+}
+
 VXVideoStab::VXVideoStab() :
-    m_CurrState(0), m_WorkSize(0), m_Images(NULL),
-    m_Matrices(NULL), m_FindWarpGraph(NULL), m_WarpAndCutGraph(NULL),
+    m_CurrState(0), m_WorkSize(0), m_Lag(0), m_Images(NULL),
+    m_Matrices(NULL), m_Grays(NULL), m_Pyramids(NULL), m_FrameGraph(NULL),
+    m_FindWarpGraph(NULL), m_WarpAndCutGraph(NULL),
     m_ImageAdded(vx_false_e)
 {
     m_Context = vxCreateContext();
@@ -46,6 +88,9 @@ vx_status VXVideoStab::CreatePipeline(const vx_uint32 width, const vx_uint32 hei
     vx_int32 gauss_size = params.warp_gauss.gauss_size;
     m_WorkSize = gauss_size * 2 + 1;
     int numMatr = gauss_size * 2;
+    /* In pipelined mode WarpAndCut works one step behind FindWarp, so both
+     * delays keep one more slot and the graphs never touch the same slot. */
+    m_Lag = params.pipelined ? 1 : 0;
 
     /*** Calc gauss coeffs ***/
     vx_float32 sigma = gauss_size * 0.7;
@@ -63,15 +108,21 @@ vx_status VXVideoStab::CreatePipeline(const vx_uint32 width, const vx_uint32 hei
     /*************************/
 
     vx_image tmp_image = vxCreateImage(m_Context, width, height, VX_DF_IMAGE_RGB);
-    m_Images = vxCreateDelay(m_Context, (vx_reference)tmp_image, m_WorkSize);
+    m_Images = vxCreateDelay(m_Context, (vx_reference)tmp_image, m_WorkSize + m_Lag);
     CHECK_NULL(m_Images);
 
     vx_matrix tmp_matr = vxCreateMatrix(m_Context, VX_TYPE_FLOAT32, 3, 3);
-    m_Matrices = vxCreateDelay(m_Context, (vx_reference)tmp_matr, numMatr);
+    m_Matrices = vxCreateDelay(m_Context, (vx_reference)tmp_matr, numMatr + m_Lag);
 
-    status = FindWarpGraph(m_Context, m_FindWarpGraph,
-                  (vx_image)vxGetReferenceFromDelay(m_Images, 1),
+    status = CreateFrameDelays(m_Context, width, height, m_Grays, m_Pyramids, params.find_warp);
+    if(status == VX_SUCCESS)
+        status = FrameGraph(m_Context, m_FrameGraph,
                   (vx_image)vxGetReferenceFromDelay(m_Images, 0),
+                  m_Grays, m_Pyramids, params.find_warp);
+    if(status == VX_SUCCESS)
+        status = FindWarpGraph(m_Context, m_FindWarpGraph,
+                  (vx_image)vxGetReferenceFromDelay(m_Images, 0),
+                  m_Grays, m_Pyramids,
                   (vx_matrix)vxGetReferenceFromDelay(m_Matrices, 0),
                   params.find_warp);
     if(status != VX_SUCCESS)
@@ -80,15 +131,11 @@ vx_status VXVideoStab::CreatePipeline(const vx_uint32 width, const vx_uint32 hei
         return VX_FAILURE;
     }
 
-    vx_matrix matrices[numMatr];
-    for(int i = 0; i < numMatr; i++)
-        matrices[i] = (vx_matrix)vxGetReferenceFromDelay(m_Matrices, i);
-
     m_ResultImage = vxCreateImage(m_Context, width, height, VX_DF_IMAGE_RGB);
     status = WarpGaussAndCutGraph(m_Context, m_WarpAndCutGraph,
-                (vx_image)vxGetReferenceFromDelay(m_Images, m_WorkSize / 2),
+                (vx_image)vxGetReferenceFromDelay(m_Images, m_WorkSize / 2 + m_Lag),
                 m_ResultImage,
-                matrices,
+                m_Matrices, m_Lag,
                 params.warp_gauss);
     if(status != VX_SUCCESS)
     {
@@ -108,7 +155,12 @@ vx_image VXVideoStab::NewImage()
         return NULL;
     }
 
-    if(m_CurrState < m_WorkSize)
+    if(m_params.external_frames)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "External frames are given with NewImage(data)!\n");
+        return NULL;
+    }
+    if(m_CurrState < m_WorkSize + m_Lag)
     {
         m_ImageAdded = vx_true_e;
         vx_image ret = (vx_image)vxGetReferenceFromDelay(m_Images, 0);
@@ -122,6 +174,44 @@ vx_image VXVideoStab::NewImage()
     }
 }
 
+vx_image VXVideoStab::NewImage(void* data, void** released)
+{
+    if(m_Images == NULL)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Pipeline wasn't created!\n");
+        return NULL;
+    }
+    if(!m_params.external_frames)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Pipeline wasn't created for external frames!\n");
+        return NULL;
+    }
+    if(m_CurrState >= m_WorkSize + m_Lag)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Can't store more images, need calculate!\n");
+        return NULL;
+    }
+
+    /* Slot 0 holds the image of the oldest frame after aging, nothing reads it anymore */
+    vx_image ret = (vx_image)vxGetReferenceFromDelay(m_Images, 0);
+    void* prev = NULL;
+    if(vxSwapImageHandle(ret, &data, &prev, 1) != VX_SUCCESS)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Can't wrap the frame!\n");
+        return NULL;
+    }
+    if(released)
+        *released = prev;
+    m_ImageAdded = vx_true_e;
+    m_CurrState++;
+    return ret;
+}
+
+vx_int32 VXVideoStab::FramesInFlight() const
+{
+    return m_WorkSize + m_Lag;
+}
+
 vx_image VXVideoStab::Calculate()
 {
     if(!m_ImageAdded)
@@ -129,28 +219,99 @@ vx_image VXVideoStab::Calculate()
         VX_PRINT(VX_ZONE_WARNING, "Add new image first!\n");
         return NULL;
     }
-    if(m_CurrState > 1)
+    vx_bool scheduled = vx_false_e;
+    if(m_CurrState == 1)
+    {
+        /* later frames are converted by the FindWarp graph */
+        if(vxProcessGraph(m_FrameGraph) != VX_SUCCESS)
+        {
+            VX_PRINT(VX_ZONE_ERROR, "Frame graph process error!\n");
+            return NULL;
+        }
+    }
+    else if(m_CurrState > 1)
     {
-        if(vxProcessGraph(m_FindWarpGraph) != VX_SUCCESS)
+        if(m_Lag)
+        {
+            /* runs on the context's graph thread while WarpAndCut runs here */
+            if(vxScheduleGraph(m_FindWarpGraph) != VX_SUCCESS)
+            {
+                VX_PRINT(VX_ZONE_ERROR, "Optical flow graph schedule error!\n");
+                return NULL;
+            }
+            scheduled = vx_true_e;
+        }
+        else if(vxProcessGraph(m_FindWarpGraph) != VX_SUCCESS)
         {
             VX_PRINT(VX_ZONE_ERROR, "Optical flow graph process error!\n");
             return NULL;
         }
     }
     vx_image ret = NULL;
-    if(m_CurrState == m_WorkSize)
+    vx_status status = VX_SUCCESS;
+    if(m_CurrState == m_WorkSize + m_Lag)
     {
-        if(vxProcessGraph(m_WarpAndCutGraph) != VX_SUCCESS)
+        status = vxProcessGraph(m_WarpAndCutGraph);
+        if(status != VX_SUCCESS)
         {
             VX_PRINT(VX_ZONE_ERROR, "MatrixGauss graph process error!\n");
-            return NULL;
         }
-        ret = m_ResultImage;
-        m_CurrState--;
+        else
+        {
+            ret = m_ResultImage;
+            m_CurrState--;
+        }
+    }
+    if(scheduled && vxWaitGraph(m_FindWarpGraph) != VX_SUCCESS)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "Optical flow graph process error!\n");
+        return NULL;
     }
+    if(status != VX_SUCCESS)
+        return NULL;
     vxAgeDelay(m_Images);
     vxAgeDelay(m_Matrices);
+    vxAgeDelay(m_Grays);
+    vxAgeDelay(m_Pyramids);
     m_ImageAdded = vx_false_e;
     return ret;
 }
 
+vx_image VXVideoStab::Flush()
+{
+    /* In pipelined mode the last WarpAndCut step is still pending when
+     * the input ends; the serial path has nothing left to produce. */
+    if(m_Lag == 0 || m_ImageAdded || m_CurrState != m_WorkSize)
+        return NULL;
+    if(vxProcessGraph(m_WarpAndCutGraph) != VX_SUCCESS)
+    {
+        VX_PRINT(VX_ZONE_ERROR, "MatrixGauss graph process error!\n");
+        return NULL;
+    }
+    m_CurrState--;
+    return m_ResultImage;
+}
+
+vx_status VXVideoStab::QueryPerformance(std::vector<NodePerf>& perf)
+{
+    const char* names[] = {"Frame", "FindWarp", "WarpAndCut"};
+    vx_graph graphs[] = {m_FrameGraph, m_FindWarpGraph, m_WarpAndCutGraph};
+
+    perf.clear();
+    for(int i = 0; i < dimof(graphs); i++)
+    {
+        CHECK_NULL(graphs[i]);
+        vx_uint32 num = 0;
+        CHECK_STATUS( vxQueryGraph(graphs[i], VX_GRAPH_ATTRIBUTE_NUMNODES, &num, sizeof(num)) );
+        if(num == 0)
+            continue;
+        std::vector<vx_node_perf_t> nodes(num);
+        CHECK_STATUS( vxQueryGraph(graphs[i], VX_GRAPH_ATTRIBUTE_NODE_PERFORMANCE, &nodes[0], num * sizeof(vx_node_perf_t)) );
+        for(vx_uint32 n = 0; n < num; n++)
+        {
+            NodePerf node = {names[i], nodes[n]};
+            perf.push_back(node);
+        }
+    }
+    return VX_SUCCESS;
+}
@@ -8,6 +8,20 @@ struct  VideoStabParams
 {
     FindWarpParams  find_warp;
     WarpGaussParams warp_gauss;
+    /* Overlap FindWarp of frame N+1 with WarpAndCut of frame N */
+    vx_bool         pipelined;
+    /* Frames are given to NewImage(data) and used in place instead of being copied in */
+    vx_bool         external_frames;
+};
+
+/* Default parameters for frames of the given size */
+void InitParams(const int width, const int height, VideoStabParams& params);
+
+/* Timings of one node of the stabilization graphs */
+struct  NodePerf
+{
+    const char*    graph;
+    vx_node_perf_t node;
 };
 
 class VXVideoStab
@@ -20,16 +34,28 @@ public:
     vx_status EnableDebug(const std::initializer_list<vx_enum>& zones);
     vx_status DisableDebug(const std::initializer_list<vx_enum>& zones);
     vx_image  NewImage();
+    /* Wraps a frame of packed pixels (stride of width * 3) as the next input without a copy.
+     * The frame must stay valid until it's given back in released by a later call,
+     * which happens after FramesInFlight() more frames, or until the pipeline is gone. */
+    vx_image  NewImage(void* data, void** released);
+    vx_int32  FramesInFlight() const;
     vx_image  Calculate();
+    vx_image  Flush();
+    /* Per node timings of all frames calculated so far */
+    vx_status QueryPerformance(std::vector<NodePerf>& perf);
 private:
     /* Context of execution */
     vx_context m_Context;
     /* Graphs */
+    vx_graph   m_FrameGraph;
     vx_graph   m_FindWarpGraph;
     vx_graph   m_WarpAndCutGraph;
     /* Containers */
     vx_delay   m_Images;
     vx_delay   m_Matrices;
+    /* Gray images and pyramids of the last two frames */
+    vx_delay   m_Grays;
+    vx_delay   m_Pyramids;
     /* One step result image */
     vx_image   m_ResultImage;
     /* Internal status */
@@ -37,6 +63,8 @@ private:
     vx_bool    m_ImageAdded;
     /* Global configs */
     vx_int32   m_WorkSize;
+    /* Extra delay slots used by pipelined mode (0 or 1) */
+    vx_int32   m_Lag;
     VideoStabParams m_params;
     vx_uint32 m_width, m_height;
 };
@@ -11,10 +11,12 @@ struct  WarpGaussParams
     vx_uint32   gauss_size;
     vx_enum     interpol;
     vx_float32  scale;
+    vx_uint32   warp_threads; // 0 - one per core
 };
 
+/* Smooths the 2 * gauss_size transforms from slot first of matrices and warps input by the result */
 vx_status WarpGaussAndCutGraph(vx_context context, vx_graph& graph, vx_image input, vx_image output,
-                         vx_matrix* matrices, WarpGaussParams& params);
+                         vx_delay matrices, vx_uint32 first, WarpGaussParams& params);
 
 struct  FindWarpParams
 {
@@ -33,10 +35,28 @@ struct  FindWarpParams
     vx_enum    optflow_term;
     vx_float32 optflow_estimate;
     vx_uint32  optflow_max_iter;
+    vx_uint32  optflow_threads; // 0 - one per core
     /*******************/
+
+    /* Motion estimation */
+    vx_enum    warp_model;          // vx_add_motion_model_e
+    vx_uint32  warp_max_iter;       // RANSAC iteration budget
+    vx_float32 warp_threshold;      // largest inlier distance, pixels
+    /*******************/
+
+    /* Channel order of the frames, vx_add_channel_order_e */
+    vx_enum    channel_order;
 };
 
-vx_status FindWarpGraph(vx_context context, vx_graph& graph,vx_image from_image, vx_image to_image,
-                        vx_matrix matrix, FindWarpParams& params);
+/* The gray images and pyramids of the current (slot 0) and the previous (slot 1) frame */
+vx_status CreateFrameDelays(vx_context context, vx_uint32 width, vx_uint32 height,
+                            vx_delay& grays, vx_delay& pyramids, FindWarpParams& params);
+
+/* Fills slot 0 of the delays from image, for the first frame */
+vx_status FrameGraph(vx_context context, vx_graph& graph, vx_image image,
+                     vx_delay grays, vx_delay pyramids, FindWarpParams& params);
+
+vx_status FindWarpGraph(vx_context context, vx_graph& graph, vx_image to_image,
+                        vx_delay grays, vx_delay pyramids, vx_matrix matrix, FindWarpParams& params);
 
 #endif // VX_WARPGAUSS_H